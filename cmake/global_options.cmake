@@ -9,6 +9,12 @@ set(ENG_VALIDATION_LAYERS_GPU_ASSISTED
 set(ENG_SHIPPING
     ON
     CACHE BOOL "Install everything into the build directory")
+set(ENG_AVX2
+    OFF
+    CACHE BOOL "Build SIMD kernels with AVX2")
+set(ENG_BENCHMARKS
+    OFF
+    CACHE BOOL "Build the engine_benchmarks executable")
 set(ENG_WSI_SELECTION
     "XCB"
     CACHE STRING "Select WSI target (XCB, XLIB, WAYLAND, D2D)")
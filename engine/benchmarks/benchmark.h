@@ -0,0 +1,40 @@
+#pragma once
+
+#include "core/timer.h"
+
+#include <functional>
+#include <limits>
+
+namespace engine
+{
+    namespace benchmark
+    {
+        // Fastest of a few runs in milliseconds, the first run also warms up the caches and the job system's workers
+        inline double Measure(const std::function<void()> &function, uint32_t runs = 5)
+        {
+            function();
+
+            double fastest = std::numeric_limits<double>::max();
+
+            for (uint32_t run = 0; run < runs; run++)
+            {
+                Timer timer;
+                timer.Start();
+                function();
+                fastest = std::min(fastest, timer.Stop<Timer::Milliseconds>());
+            }
+
+            return fastest;
+        }
+
+        // Logs the new path's time next to the path it replaced
+        inline void Report(const std::string &name, double new_time, double old_time)
+        {
+            ENG_CORE_INFO("{:<40} {:>10.3f} ms {:>10.3f} ms {:>7.2f}x", name, new_time, old_time, old_time / new_time);
+        }
+
+        void RunDrawQueueBenchmark();
+        void RunMipmapBenchmark();
+        void RunTransformBenchmark();
+    }
+}
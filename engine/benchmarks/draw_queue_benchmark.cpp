@@ -0,0 +1,104 @@
+#include "benchmark.h"
+
+#include "scene/entity.h"
+#include "scene/scene.h"
+#include "scene/components/pbr_material.h"
+#include "scene/components/submesh.h"
+#include "scene/components/transform.h"
+#include "vulkan_api/rendering/draw_queue.h"
+
+namespace engine
+{
+    namespace benchmark
+    {
+        namespace
+        {
+            constexpr size_t MATERIAL_COUNT = 64;
+            constexpr size_t SUBMESH_COUNT = 1024;
+
+            // Every 8th material is blended
+            constexpr size_t BLEND_MATERIAL_STRIDE = 8;
+        }
+
+        void RunDrawQueueBenchmark()
+        {
+            std::vector<std::unique_ptr<sg::PBRMaterial>> materials;
+            for (size_t i = 0; i < MATERIAL_COUNT; i++)
+            {
+                materials.push_back(std::make_unique<sg::PBRMaterial>("material " + std::to_string(i)));
+                materials.back()->m_DoubleSided = i % 3 == 0;
+
+                if (i % BLEND_MATERIAL_STRIDE == 0)
+                    materials.back()->m_AlphaMode = sg::AlphaMode::Blend;
+            }
+
+            std::vector<std::unique_ptr<sg::Submesh>> submeshes;
+            for (size_t i = 0; i < SUBMESH_COUNT; i++)
+            {
+                submeshes.push_back(std::make_unique<sg::Submesh>());
+                submeshes.back()->SetMaterial(*materials[i % MATERIAL_COUNT]);
+            }
+
+            // Neither path reads the transform, every draw shares one
+            Scene scene;
+            auto entity = scene.CreateEntity();
+            auto &transform = entity.AddComponent<sg::Transform>(entity);
+
+            for (size_t count : {10000u, 100000u})
+            {
+                std::vector<std::pair<sg::Submesh *, float>> draws(count);
+
+                uint32_t state = 0x12345678u;
+                for (size_t i = 0; i < count; i++)
+                {
+                    state = state * 1664525u + 1013904223u;
+                    draws[i] = {submeshes[(state >> 8) % SUBMESH_COUNT].get(), static_cast<float>(state >> 16) * 0.01f};
+                }
+
+                // Consumed after each pass so the ordered draws are not optimized away
+                uintptr_t checksum = 0;
+
+                DrawQueue draw_queue;
+
+                auto queue_time = Measure([&]()
+                                          {
+                                              draw_queue.Clear();
+
+                                              for (auto &draw : draws)
+                                                  draw_queue.Push(*draw.first, transform, VK_FRONT_FACE_COUNTER_CLOCKWISE, draw.second);
+
+                                              draw_queue.Sort();
+
+                                              for (auto &packet : draw_queue.GetPackets())
+                                                  checksum += reinterpret_cast<uintptr_t>(packet.submesh);
+                                          });
+
+                // GeometrySubpass before the draw queue, two multimaps filled every frame
+                auto multimap_time = Measure([&]()
+                                             {
+                                                 std::multimap<float, std::pair<sg::Submesh *, sg::Transform *>> opaque_nodes;
+                                                 std::multimap<float, std::pair<sg::Submesh *, sg::Transform *>> transparent_nodes;
+
+                                                 for (auto &draw : draws)
+                                                 {
+                                                     auto pair = std::make_pair(draw.first, &transform);
+
+                                                     if (draw.first->GetMaterial()->m_AlphaMode == sg::AlphaMode::Blend)
+                                                         transparent_nodes.emplace(draw.second, pair);
+                                                     else
+                                                         opaque_nodes.emplace(draw.second, pair);
+                                                 }
+
+                                                 for (auto node_it = opaque_nodes.begin(); node_it != opaque_nodes.end(); node_it++)
+                                                     checksum += reinterpret_cast<uintptr_t>(node_it->second.first);
+
+                                                 for (auto node_it = transparent_nodes.rbegin(); node_it != transparent_nodes.rend(); node_it++)
+                                                     checksum += reinterpret_cast<uintptr_t>(node_it->second.first);
+                                             });
+
+                Report(fmt::format("draw queue vs multimap, {} draws", count), queue_time, multimap_time);
+                ENG_CORE_TRACE("Draw order checksum {}", checksum);
+            }
+        }
+    }
+}
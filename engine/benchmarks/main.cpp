@@ -0,0 +1,43 @@
+#include "benchmark.h"
+
+#include "core/job_system.h"
+
+#include <cstring>
+
+namespace
+{
+    struct Benchmark
+    {
+        const char *name;
+        void (*run)();
+    };
+
+    const Benchmark BENCHMARKS[] = {
+        {"draw_queue", engine::benchmark::RunDrawQueueBenchmark},
+        {"mipmap", engine::benchmark::RunMipmapBenchmark},
+        {"transform", engine::benchmark::RunTransformBenchmark}};
+}
+
+// Runs every benchmark, or only the ones named on the command line
+int main(int argc, char *argv[])
+{
+    engine::Log::Init();
+    engine::JobSystem::Init();
+
+    ENG_CORE_INFO("{} workers", engine::JobSystem::Get().GetWorkerCount());
+    ENG_CORE_INFO("{:<40} {:>13} {:>13} {:>8}", "", "new", "old", "speedup");
+
+    for (auto &benchmark : BENCHMARKS)
+    {
+        bool selected = argc < 2;
+
+        for (int argument = 1; argument < argc && !selected; argument++)
+            selected = std::strcmp(argv[argument], benchmark.name) == 0;
+
+        if (selected)
+            benchmark.run();
+    }
+
+    engine::JobSystem::Shutdown();
+    return 0;
+}
@@ -0,0 +1,101 @@
+#include "benchmark.h"
+
+#include "scene/mipmap_generator.h"
+
+ENG_DISABLE_WARNINGS()
+#define STB_IMAGE_RESIZE_IMPLEMENTATION
+#include <stb_image_resize.h>
+ENG_ENABLE_WARNINGS()
+
+namespace engine
+{
+    namespace benchmark
+    {
+        namespace
+        {
+            constexpr uint32_t CHANNELS = 4;
+
+            // Same layout as Image::LayoutMipmaps, every level down to 1x1 after level 0
+            std::vector<sg::Mipmap> LayoutChain(uint32_t size, size_t &chain_size)
+            {
+                std::vector<sg::Mipmap> mipmaps{{0, 0, {size, size, 1u}}};
+                chain_size = static_cast<size_t>(size) * size * CHANNELS;
+
+                auto extent = mipmaps.back().extent;
+                while (extent.width > 1 || extent.height > 1)
+                {
+                    extent.width = std::max(1u, extent.width / 2);
+                    extent.height = std::max(1u, extent.height / 2);
+
+                    mipmaps.push_back({mipmaps.back().level + 1, ToUint32_t(chain_size), extent});
+                    chain_size += static_cast<size_t>(extent.width) * extent.height * CHANNELS;
+                }
+
+                return mipmaps;
+            }
+
+            // The chained stb_image_resize path Image::WriteMipmaps used before sg::WriteMipmapChain
+            void WriteStbChain(const uint8_t *base, const std::vector<sg::Mipmap> &mipmaps, bool srgb, uint8_t *data)
+            {
+                auto &base_mipmap = mipmaps.front();
+                std::memcpy(data, base, static_cast<size_t>(base_mipmap.extent.width) * base_mipmap.extent.height * CHANNELS);
+
+                const uint8_t *previous_data = base;
+                std::vector<uint8_t> previous;
+                std::vector<uint8_t> next;
+
+                for (size_t level = 1; level < mipmaps.size(); level++)
+                {
+                    auto &previous_mipmap = mipmaps[level - 1];
+                    auto &next_mipmap = mipmaps[level];
+
+                    next.resize(static_cast<size_t>(next_mipmap.extent.width) * next_mipmap.extent.height * CHANNELS);
+
+                    if (srgb)
+                        stbir_resize_uint8_srgb(previous_data, previous_mipmap.extent.width, previous_mipmap.extent.height, 0,
+                                                next.data(), next_mipmap.extent.width, next_mipmap.extent.height, 0, CHANNELS, 3, 0);
+                    else
+                        stbir_resize_uint8(previous_data, previous_mipmap.extent.width, previous_mipmap.extent.height, 0,
+                                           next.data(), next_mipmap.extent.width, next_mipmap.extent.height, 0, CHANNELS);
+
+                    std::memcpy(data + next_mipmap.offset, next.data(), next.size());
+
+                    std::swap(previous, next);
+                    previous_data = previous.data();
+                }
+            }
+        }
+
+        void RunMipmapBenchmark()
+        {
+            for (uint32_t size : {4096u, 8192u})
+            {
+                size_t chain_size = 0;
+                auto mipmaps = LayoutChain(size, chain_size);
+
+                // Noise keeps either path from skipping work on flat regions
+                std::vector<uint8_t> base(static_cast<size_t>(size) * size * CHANNELS);
+                uint32_t state = 0x12345678u;
+                for (auto &value : base)
+                {
+                    state = state * 1664525u + 1013904223u;
+                    value = static_cast<uint8_t>(state >> 24);
+                }
+
+                std::vector<uint8_t> data(chain_size);
+
+                for (bool srgb : {false, true})
+                {
+                    auto new_time = Measure([&]()
+                                            { sg::WriteMipmapChain(base.data(), mipmaps, srgb, data.data()); },
+                                            3);
+                    auto old_time = Measure([&]()
+                                            { WriteStbChain(base.data(), mipmaps, srgb, data.data()); },
+                                            3);
+
+                    Report(fmt::format("mipmaps {}x{} {}", size, size, srgb ? "sRGB" : "UNORM"), new_time, old_time);
+                }
+            }
+        }
+    }
+}
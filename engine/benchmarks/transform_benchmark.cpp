@@ -0,0 +1,58 @@
+#include "benchmark.h"
+
+#include "scene/systems/transform_batch.h"
+
+namespace engine
+{
+    namespace benchmark
+    {
+        void RunTransformBenchmark()
+        {
+            for (size_t count : {1000u, 10000u, 100000u})
+            {
+                std::vector<glm::vec3> translations(count);
+                std::vector<glm::quat> rotations(count);
+                std::vector<glm::vec3> scales(count);
+
+                TransformBatch batch;
+                batch.Resize(count);
+
+                auto axis = glm::normalize(glm::vec3(1.0f, 2.0f, 3.0f));
+
+                for (size_t i = 0; i < count; i++)
+                {
+                    auto value = static_cast<float>(i);
+
+                    translations[i] = glm::vec3(value, -value, value * 0.5f);
+                    rotations[i] = glm::angleAxis(value * 0.001f, axis);
+                    scales[i] = glm::vec3(1.0f + value * 0.0001f);
+
+                    batch.Set(i, translations[i], rotations[i], scales[i]);
+                }
+
+                std::vector<glm::mat4> matrices(count);
+
+                auto batch_time = Measure([&]()
+                                          { batch.Compose(matrices.data()); });
+
+                auto scalar_time = Measure([&]()
+                                           {
+                                               for (size_t i = 0; i < count; i++)
+                                                   matrices[i] = ComposeTRS(translations[i], rotations[i], scales[i]);
+                                           });
+
+                // Transform::GetMatrix before ComposeTRS
+                auto glm_time = Measure([&]()
+                                        {
+                                            for (size_t i = 0; i < count; i++)
+                                                matrices[i] = glm::translate(glm::mat4(1.0f), translations[i]) *
+                                                              glm::mat4_cast(rotations[i]) *
+                                                              glm::scale(glm::mat4(1.0f), scales[i]);
+                                        });
+
+                Report(fmt::format("TRS batch vs ComposeTRS, {} transforms", count), batch_time, scalar_time);
+                Report(fmt::format("TRS batch vs glm, {} transforms", count), batch_time, glm_time);
+            }
+        }
+    }
+}
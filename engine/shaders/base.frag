@@ -30,7 +30,6 @@ layout(location = 0) out vec4 o_color;
 
 layout(set = 0, binding = 1) uniform GlobalUniform
 {
-	mat4 model;
 	mat4 view_proj;
 	vec3 camera_position;
 }
@@ -43,6 +42,9 @@ layout(push_constant, std430) uniform PBRMaterialUniform
 	vec4  base_color_factor;
 	float metallic_factor;
 	float roughness_factor;
+	// Only read by the vertex stage, declared so both stages share one range
+	vec4  position_offset;
+	vec4  position_scale;
 }
 pbr_material_uniform;
 
@@ -18,25 +18,60 @@
 
 layout(location = 0) in vec3 position;
 layout(location = 1) in vec2 texcoord_0;
+#ifdef OCTAHEDRAL_NORMAL
+layout(location = 2) in vec2 normal;
+#else
 layout(location = 2) in vec3 normal;
+#endif
+layout(location = 3) in mat4 instance_model;
 
 layout(set = 0, binding = 1) uniform GlobalUniform {
-    mat4 model;
     mat4 view_proj;
     vec3 camera_position;
 } global_uniform;
 
+#ifdef QUANTIZED_POSITION
+// Same block as the fragment stage, positions are normalized to the submesh bounds
+layout(push_constant, std430) uniform PBRMaterialUniform {
+    vec4 base_color_factor;
+    float metallic_factor;
+    float roughness_factor;
+    vec4 position_offset;
+    vec4 position_scale;
+} pbr_material_uniform;
+#endif
+
 layout (location = 0) out vec4 o_pos;
 layout (location = 1) out vec2 o_uv;
 layout (location = 2) out vec3 o_normal;
 
+#ifdef OCTAHEDRAL_NORMAL
+vec3 decode_octahedral(vec2 encoded)
+{
+    vec3 direction = vec3(encoded, 1.0 - abs(encoded.x) - abs(encoded.y));
+    float fold = max(-direction.z, 0.0);
+    direction.xy += vec2(direction.x >= 0.0 ? -fold : fold, direction.y >= 0.0 ? -fold : fold);
+    return normalize(direction);
+}
+#endif
+
 void main(void)
 {
-    o_pos = global_uniform.model * vec4(position, 1.0);
+#ifdef QUANTIZED_POSITION
+    vec3 local_position = pbr_material_uniform.position_offset.xyz + position * pbr_material_uniform.position_scale.xyz;
+#else
+    vec3 local_position = position;
+#endif
+
+    o_pos = instance_model * vec4(local_position, 1.0);
 
     o_uv = texcoord_0;
 
-    o_normal = mat3(global_uniform.model) * normal;
+#ifdef OCTAHEDRAL_NORMAL
+    o_normal = mat3(instance_model) * decode_octahedral(normal);
+#else
+    o_normal = mat3(instance_model) * normal;
+#endif
 
     gl_Position = global_uniform.view_proj * o_pos;
 }
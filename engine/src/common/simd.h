@@ -0,0 +1,17 @@
+#pragma once
+
+// Compile time instruction set selection, AVX2 is opted into with ENG_AVX2
+#if defined(__AVX2__)
+#define ENG_SIMD_AVX2
+#endif
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define ENG_SIMD_SSE
+#endif
+
+#if defined(ENG_SIMD_AVX2)
+#include <immintrin.h>
+#elif defined(ENG_SIMD_SSE)
+#include <emmintrin.h>
+#include <xmmintrin.h>
+#endif
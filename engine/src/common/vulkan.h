@@ -19,6 +19,16 @@ namespace engine
         uint32_t new_queue_family{VK_QUEUE_FAMILY_IGNORED};
     };
 
+    struct BufferMemoryBarrier
+    {
+        VkPipelineStageFlags src_stage_mask{VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT};
+        VkPipelineStageFlags dst_stage_mask{VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT};
+        VkAccessFlags src_access_mask{0};
+        VkAccessFlags dst_access_mask{0};
+        uint32_t old_queue_family{VK_QUEUE_FAMILY_IGNORED};
+        uint32_t new_queue_family{VK_QUEUE_FAMILY_IGNORED};
+    };
+
     struct LoadStoreInfo
     {
         VkAttachmentLoadOp load_op = VK_ATTACHMENT_LOAD_OP_CLEAR;
@@ -3,12 +3,14 @@
 #include "window/window.h"
 #include "core/timer.h"
 #include "core/gui.h"
+#include "core/job_system.h"
 #include "core/layer_stack.h"
 #include "events/application_event.h"
 #include "events/key_event.h"
 #include "window/input.h"
 #include "vulkan_api/command_buffer.h"
 #include "vulkan_api/device.h"
+#include "vulkan_api/core/geometry_arena.h"
 #include "vulkan_api/instance.h"
 #include "platform/platform.h"
 #include "vulkan_api/physical_device.h"
@@ -34,6 +36,8 @@ namespace engine
 
         ENG_CORE_INFO("Logger initialized.");
 
+        JobSystem::Init();
+
         SetUsage(
             R"(Engine
     Usage:
@@ -53,6 +57,10 @@ namespace engine
 
     Application::~Application()
     {
+        // Loaders use the device and the scenes
+        for (auto &scene_load : m_SceneLoads)
+            JobSystem::Get().Wait(*scene_load.finished);
+
         if (m_Device)
             m_Device->WaitIdle();
 
@@ -65,6 +73,8 @@ namespace engine
         m_Device.reset();
 
         m_Instance.reset();
+
+        JobSystem::Shutdown();
     }
 
     bool Application::Prepare()
@@ -147,6 +157,28 @@ namespace engine
 
     void Application::Update(float delta_time)
     {
+        auto &job_system = JobSystem::Get();
+        job_system.ExecuteMainThreadJobs();
+
+        // Rethrows errors of finished loads on this thread
+        for (auto it = m_SceneLoads.begin(); it != m_SceneLoads.end();)
+        {
+            if (!it->finished->IsDone())
+            {
+                ++it;
+                continue;
+            }
+
+            job_system.Wait(*it->finished);
+
+            // No frame is recorded yet, packs the gaps left by alignment and by primitives that failed to load
+            auto *arena = it->scene->GetGeometryArena();
+            if (arena && arena->IsFragmented())
+                arena->Defragment();
+
+            it = m_SceneLoads.erase(it);
+        }
+
         std::set<Scene *> scenes;
         for (auto &layer : m_LayerStack.GetLayers())
         {
@@ -156,8 +188,19 @@ namespace engine
                 layer.second->m_Initialized = true;
             }
 
+            Scene *scene = layer.second->GetScene();
+
+            if (!layer.second->IsSceneLoaded())
+            {
+                if (scene && !scene->IsLoaded())
+                    continue;
+
+                layer.second->m_SceneLoaded = true;
+                layer.second->OnSceneLoaded();
+            }
+
             layer.second->OnUpdate(delta_time);
-            scenes.emplace(layer.second->GetScene());
+            scenes.emplace(scene);
         }
 
         for (Scene *scene : scenes)
@@ -188,6 +231,32 @@ namespace engine
         return m_Scenes.back().get();
     }
 
+    Application::SceneLoad Application::LoadSceneAsync(const std::string &name)
+    {
+        m_Scenes.emplace_back(std::make_unique<Scene>());
+
+        SceneLoad scene_load{};
+        scene_load.scene = m_Scenes.back().get();
+        scene_load.scene->SetLoaded(false);
+
+        scene_load.finished = std::make_shared<JobCounter>();
+
+        Device &device = *m_Device;
+        Scene *scene = scene_load.scene;
+
+        // The loader mostly waits for its decode jobs, on a thread of its own it leaves every worker to them
+        JobSystem::Get().RunDedicated([&device, scene, name]()
+                                      {
+                                          GLTFLoader loader(device);
+                                          if (!loader.ReadSceneFromFile(name, *scene))
+                                              throw std::runtime_error("Failed to load scene " + name);
+                                      },
+                                      scene_load.finished.get());
+
+        m_SceneLoads.push_back(scene_load);
+        return scene_load;
+    }
+
     void Application::OnEvent(Event &event)
     {
         EventDispatcher dispatcher(event);
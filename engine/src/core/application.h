@@ -19,10 +19,18 @@ namespace engine
     class RenderPipeline;
     class CommandBuffer;
     class Gui;
+    class JobCounter;
 
     class Application
     {
     public:
+        // The scene is owned by the application right away, but not loaded until the counter reached zero
+        struct SceneLoad
+        {
+            Scene *scene{nullptr};
+            std::shared_ptr<JobCounter> finished;
+        };
+
         Application(Platform *platform);
         Application() = delete;
         Application(const Application &) = default;
@@ -43,6 +51,8 @@ namespace engine
 
         Scene *LoadScene(std::string name);
         Scene *LoadScene();
+        // Loads the scene in a background job, layers using it start updating and drawing it once it is loaded
+        SceneLoad LoadSceneAsync(const std::string &name);
         void SetName(const std::string &name) { m_Name = name; }
         std::string GetName() const { return m_Name; }
 
@@ -83,6 +93,7 @@ namespace engine
         std::unique_ptr<Instance> m_Instance{};
         std::unique_ptr<Device> m_Device{};
         std::vector<std::unique_ptr<Scene>> m_Scenes{};
+        std::vector<SceneLoad> m_SceneLoads{};
 
         std::unordered_map<const char *, bool> m_DeviceExtensions{};
         std::unordered_map<const char *, bool> m_InstanceExtensions{};
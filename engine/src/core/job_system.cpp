@@ -0,0 +1,367 @@
+#include "core/job_system.h"
+
+namespace engine
+{
+    namespace
+    {
+        constexpr size_t NO_WORKER = std::numeric_limits<size_t>::max();
+
+        // Ranges per thread ParallelFor splits into at most, so uneven ranges still balance out
+        constexpr size_t RANGES_PER_THREAD = 4;
+
+        thread_local size_t t_WorkerIndex = NO_WORKER;
+    }
+
+    JobSystem *JobSystem::s_Instance = nullptr;
+
+    void JobSystem::Init(size_t worker_count)
+    {
+        ENG_ASSERT(!s_Instance, "Job system is already initialized");
+
+        if (worker_count == 0)
+        {
+            auto thread_count = std::thread::hardware_concurrency();
+            worker_count = thread_count > 1 ? thread_count - 1 : 1;
+        }
+
+        s_Instance = new JobSystem(worker_count);
+
+        ENG_CORE_INFO("Job system started with {} workers.", worker_count);
+    }
+
+    void JobSystem::Shutdown()
+    {
+        delete s_Instance;
+        s_Instance = nullptr;
+    }
+
+    JobSystem &JobSystem::Get()
+    {
+        ENG_ASSERT(s_Instance, "Job system is not initialized");
+        return *s_Instance;
+    }
+
+    JobSystem::JobSystem(size_t worker_count)
+    {
+        for (size_t i = 0; i < worker_count; i++)
+            m_Queues.push_back(std::make_unique<WorkerQueue>());
+
+        for (size_t i = 0; i < worker_count; i++)
+            m_Workers.emplace_back(&JobSystem::WorkerLoop, this, i);
+    }
+
+    JobSystem::~JobSystem()
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_DedicatedMutex);
+
+            for (auto &thread : m_DedicatedThreads)
+                thread.join();
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(m_Mutex);
+            m_Stop = true;
+        }
+
+        m_Wake.notify_all();
+
+        for (auto &worker : m_Workers)
+            worker.join();
+    }
+
+    void JobSystem::Run(Job job, JobCounter *counter)
+    {
+        if (counter)
+            counter->m_Count++;
+
+        Push(Wrap(std::move(job), counter), false);
+    }
+
+    void JobSystem::RunAfter(JobCounter &dependency, Job job, JobCounter *counter)
+    {
+        if (counter)
+            counter->m_Count++;
+
+        auto wrapped = Wrap(std::move(job), counter);
+
+        {
+            std::lock_guard<std::mutex> lock(dependency.m_Mutex);
+
+            if (dependency.m_Count > 0)
+            {
+                dependency.m_Continuations.push_back(std::move(wrapped));
+                return;
+            }
+        }
+
+        Push(std::move(wrapped), false);
+    }
+
+    void JobSystem::RunBackground(Job job, JobCounter *counter)
+    {
+        if (counter)
+            counter->m_Count++;
+
+        Push(Wrap(std::move(job), counter), true);
+    }
+
+    void JobSystem::RunDedicated(Job job, JobCounter *counter)
+    {
+        if (counter)
+            counter->m_Count++;
+
+        // Few dedicated jobs run over a session, their threads are only joined on shutdown
+        std::lock_guard<std::mutex> lock(m_DedicatedMutex);
+        m_DedicatedThreads.emplace_back(Wrap(std::move(job), counter));
+    }
+
+    void JobSystem::Wait(JobCounter &counter)
+    {
+        while (counter.m_Count > 0)
+        {
+            if (TryExecute(false))
+                continue;
+
+            std::unique_lock<std::mutex> lock(m_Mutex);
+            m_Wake.wait(lock, [this, &counter]()
+                        { return counter.m_Count == 0 || m_PendingCount > 0; });
+        }
+
+        std::exception_ptr exception;
+
+        {
+            // Also waits for the last job to let go of the counter
+            std::lock_guard<std::mutex> lock(counter.m_Mutex);
+            std::swap(exception, counter.m_Exception);
+        }
+
+        if (exception)
+            std::rethrow_exception(exception);
+    }
+
+    void JobSystem::ParallelFor(size_t count, size_t min_range_size, const std::function<void(size_t, size_t)> &function)
+    {
+        if (count == 0)
+            return;
+
+        auto range_count = std::min(count / std::max<size_t>(min_range_size, 1), (m_Workers.size() + 1) * RANGES_PER_THREAD);
+
+        if (range_count <= 1)
+        {
+            function(0, count);
+            return;
+        }
+
+        auto range_size = (count + range_count - 1) / range_count;
+
+        JobCounter counter;
+
+        for (size_t begin = range_size; begin < count; begin += range_size)
+        {
+            auto end = std::min(begin + range_size, count);
+            Run([&function, begin, end]()
+                { function(begin, end); },
+                &counter);
+        }
+
+        // The calling thread takes the first range instead of idling
+        std::exception_ptr exception;
+
+        try
+        {
+            function(0, range_size);
+        }
+        catch (...)
+        {
+            exception = std::current_exception();
+        }
+
+        Wait(counter);
+
+        if (exception)
+            std::rethrow_exception(exception);
+    }
+
+    void JobSystem::RunOnMainThread(Job job)
+    {
+        std::lock_guard<std::mutex> lock(m_MainThreadMutex);
+        m_MainThreadJobs.push_back(std::move(job));
+    }
+
+    void JobSystem::ExecuteMainThreadJobs()
+    {
+        std::vector<Job> jobs;
+
+        {
+            std::lock_guard<std::mutex> lock(m_MainThreadMutex);
+            jobs.swap(m_MainThreadJobs);
+        }
+
+        for (auto &job : jobs)
+            job();
+    }
+
+    JobSystem::Job JobSystem::Wrap(Job job, JobCounter *counter)
+    {
+        return [this, job = std::move(job), counter]()
+        {
+            std::exception_ptr exception;
+
+            try
+            {
+                job();
+            }
+            catch (...)
+            {
+                exception = std::current_exception();
+            }
+
+            if (counter)
+                Finish(*counter, exception);
+            else if (exception)
+                ENG_CORE_ERROR("Uncounted job threw an exception, nobody waits for it.");
+        };
+    }
+
+    void JobSystem::Push(Job job, bool background)
+    {
+        auto worker_index = t_WorkerIndex;
+
+        if (background)
+        {
+            std::lock_guard<std::mutex> lock(m_BackgroundQueue.mutex);
+            m_BackgroundQueue.jobs.push_back(std::move(job));
+            m_BackgroundCount++;
+        }
+        else
+        {
+            // Workers keep their jobs local, other threads spread theirs over the workers
+            if (worker_index == NO_WORKER)
+                worker_index = m_NextQueue++ % m_Queues.size();
+
+            auto &queue = *m_Queues[worker_index];
+
+            std::lock_guard<std::mutex> lock(queue.mutex);
+            queue.jobs.push_back(std::move(job));
+            m_PendingCount++;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(m_Mutex);
+        }
+
+        // Waiting threads can't take background jobs, so those have to reach a worker
+        if (background)
+            m_Wake.notify_all();
+        else
+            m_Wake.notify_one();
+    }
+
+    bool JobSystem::TryExecute(bool include_background)
+    {
+        Job job;
+        if (!Pop(job, include_background))
+            return false;
+
+        job();
+        return true;
+    }
+
+    bool JobSystem::Pop(Job &job, bool include_background)
+    {
+        auto worker_index = t_WorkerIndex;
+        auto queue_count = m_Queues.size();
+
+        if (worker_index != NO_WORKER)
+        {
+            auto &queue = *m_Queues[worker_index];
+
+            std::lock_guard<std::mutex> lock(queue.mutex);
+            if (!queue.jobs.empty())
+            {
+                job = std::move(queue.jobs.back());
+                queue.jobs.pop_back();
+                m_PendingCount--;
+                return true;
+            }
+        }
+
+        // Steal the oldest job of another queue, it tends to be the largest piece of work left
+        auto first = worker_index == NO_WORKER ? 0 : worker_index + 1;
+
+        for (size_t i = 0; i < queue_count; i++)
+        {
+            auto &queue = *m_Queues[(first + i) % queue_count];
+
+            std::lock_guard<std::mutex> lock(queue.mutex);
+            if (!queue.jobs.empty())
+            {
+                job = std::move(queue.jobs.front());
+                queue.jobs.pop_front();
+                m_PendingCount--;
+                return true;
+            }
+        }
+
+        if (include_background)
+        {
+            std::lock_guard<std::mutex> lock(m_BackgroundQueue.mutex);
+            if (!m_BackgroundQueue.jobs.empty())
+            {
+                job = std::move(m_BackgroundQueue.jobs.front());
+                m_BackgroundQueue.jobs.pop_front();
+                m_BackgroundCount--;
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    void JobSystem::Finish(JobCounter &counter, std::exception_ptr exception)
+    {
+        std::vector<Job> continuations;
+
+        {
+            std::lock_guard<std::mutex> lock(counter.m_Mutex);
+
+            if (exception && !counter.m_Exception)
+                counter.m_Exception = exception;
+
+            if (--counter.m_Count > 0)
+                return;
+
+            continuations.swap(counter.m_Continuations);
+        }
+
+        // The counter may be gone from here on, its waiter can return
+        for (auto &continuation : continuations)
+            Push(std::move(continuation), false);
+
+        {
+            std::lock_guard<std::mutex> lock(m_Mutex);
+        }
+
+        m_Wake.notify_all();
+    }
+
+    void JobSystem::WorkerLoop(size_t worker_index)
+    {
+        t_WorkerIndex = worker_index;
+
+        while (true)
+        {
+            if (TryExecute(true))
+                continue;
+
+            std::unique_lock<std::mutex> lock(m_Mutex);
+            m_Wake.wait(lock, [this]()
+                        { return m_Stop || m_PendingCount > 0 || m_BackgroundCount > 0; });
+
+            // Queued jobs are drained before the workers exit
+            if (m_Stop && m_PendingCount == 0 && m_BackgroundCount == 0)
+                return;
+        }
+    }
+}
@@ -0,0 +1,106 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+namespace engine
+{
+    // Counts the unfinished jobs of a group. Jobs can be started once a counter reached zero,
+    // the first exception thrown by a counted job is rethrown by JobSystem::Wait
+    class JobCounter
+    {
+    public:
+        JobCounter() = default;
+        ~JobCounter() = default;
+
+        JobCounter(const JobCounter &) = delete;
+        JobCounter &operator=(const JobCounter &) = delete;
+
+        bool IsDone() const { return m_Count == 0; }
+
+    private:
+        friend class JobSystem;
+
+        std::atomic<uint32_t> m_Count{0};
+        std::mutex m_Mutex;
+        std::vector<std::function<void()>> m_Continuations;
+        std::exception_ptr m_Exception;
+    };
+
+    // Engine wide worker threads. Every worker owns a deque it pushes to and pops from the back of,
+    // idle workers steal from the front of the others. Threads waiting for a counter execute jobs meanwhile
+    class JobSystem
+    {
+    public:
+        using Job = std::function<void()>;
+
+        // A worker count of 0 uses one worker per hardware thread besides the main thread
+        static void Init(size_t worker_count = 0);
+        static void Shutdown();
+        static JobSystem &Get();
+
+        JobSystem(const JobSystem &) = delete;
+        JobSystem &operator=(const JobSystem &) = delete;
+
+        void Run(Job job, JobCounter *counter = nullptr);
+        // Starts the job once dependency reached zero
+        void RunAfter(JobCounter &dependency, Job job, JobCounter *counter = nullptr);
+        // Long running jobs, only workers pick them up so a waiting thread never gets stuck in one
+        void RunBackground(Job job, JobCounter *counter = nullptr);
+        // Jobs that mostly block on jobs of their own, e.g. scene loads, get a thread of their own so they never hold a worker
+        void RunDedicated(Job job, JobCounter *counter = nullptr);
+        // Executes jobs until the counter reached zero, rethrows the first exception of its jobs
+        void Wait(JobCounter &counter);
+
+        // Splits [0, count) into ranges of at least min_range_size and calls function(begin, end) for each of them
+        void ParallelFor(size_t count, size_t min_range_size, const std::function<void(size_t, size_t)> &function);
+
+        // Thread safe, queued jobs run on the main thread when it executes them between frames
+        void RunOnMainThread(Job job);
+        void ExecuteMainThreadJobs();
+
+        size_t GetWorkerCount() const { return m_Workers.size(); }
+
+    private:
+        struct WorkerQueue
+        {
+            std::mutex mutex;
+            std::deque<Job> jobs;
+        };
+
+        JobSystem(size_t worker_count);
+        ~JobSystem();
+
+        // Wraps the job so it counts down its counter, the caller counted it up
+        Job Wrap(Job job, JobCounter *counter);
+        void Push(Job job, bool background);
+        bool TryExecute(bool include_background);
+        bool Pop(Job &job, bool include_background);
+        void Finish(JobCounter &counter, std::exception_ptr exception);
+        void WorkerLoop(size_t worker_index);
+
+        static JobSystem *s_Instance;
+
+        std::vector<std::thread> m_Workers;
+        std::vector<std::unique_ptr<WorkerQueue>> m_Queues;
+        WorkerQueue m_BackgroundQueue;
+        std::atomic<size_t> m_NextQueue{0};
+        std::atomic<size_t> m_PendingCount{0};
+        std::atomic<size_t> m_BackgroundCount{0};
+
+        std::mutex m_Mutex;
+        std::condition_variable m_Wake;
+        bool m_Stop{false};
+
+        std::mutex m_MainThreadMutex;
+        std::vector<Job> m_MainThreadJobs;
+
+        // Joined on shutdown, before the workers the dedicated jobs may still push to
+        std::mutex m_DedicatedMutex;
+        std::vector<std::thread> m_DedicatedThreads;
+    };
+}
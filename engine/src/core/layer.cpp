@@ -35,7 +35,10 @@ namespace engine
             auto &transform = entity.AddComponent<sg::Transform>(entity);
             if (cameras.size() > 0)
             {
-                transform = cameras.front()->GetComponent<sg::Transform>();
+                auto &source_transform = cameras.front()->GetComponent<sg::Transform>();
+                transform.SetTranslation(source_transform.GetTranslation());
+                transform.SetRotation(source_transform.GetRotation());
+                transform.SetScale(source_transform.GetScale());
                 perspective_camera = cameras.front()->GetComponent<sg::PerspectiveCamera>();
             }
 
@@ -64,6 +67,9 @@ namespace engine
 
     bool Layer::OnResize(WindowResizeEvent &event)
     {
+        if (!m_SceneLoaded)
+            return false;
+
         auto view = m_Scene->GetRegistry().view<sg::FreeCamera, sg::PerspectiveCamera>();
         for (auto &entity : view)
         {
@@ -25,6 +25,8 @@ namespace engine
 		void AddFreeCamera(VkExtent2D extent, Window *window);
 
 		virtual void OnAttach() {}
+		// Called on the first update after the layer's scene finished loading
+		virtual void OnSceneLoaded() {}
 		virtual void OnDetach();
 		virtual void OnUpdate(float delta_time) {}
 		virtual void OnEvent(Event &event);
@@ -48,6 +50,7 @@ namespace engine
 		RenderPipeline *GetRenderPipeline() { return m_RenderPipeline; }
 
 		bool IsInitialized() { return m_Initialized; }
+		bool IsSceneLoaded() const { return m_SceneLoaded; }
 
 		friend class Application;
 		friend class Platform;
@@ -61,5 +64,6 @@ namespace engine
 		RenderPipeline *m_RenderPipeline{};
 
 		bool m_Initialized{false};
+		bool m_SceneLoaded{false};
 	};
 }
\ No newline at end of file
@@ -9,6 +9,15 @@ ENG_ENABLE_WARNINGS()
 
 #include <fstream>
 
+#if defined(_WIN32) || defined(_WIN64)
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
 namespace engine
 {
     namespace fs
@@ -19,6 +28,7 @@ namespace engine
                 {Type::Assets, "assets"},
                 {Type::Shaders, "shaders"},
                 {Type::Storage, "output"},
+                {Type::Cache, "output/cache"},
                 {Type::Fonts, "vendor/imgui/misc/fonts"}};
 
             std::filesystem::path Get(const Type type, const std::string &filename)
@@ -51,7 +61,7 @@ namespace engine
                 }
 
                 if (!std::filesystem::exists(path))
-                    std::filesystem::create_directory(path);
+                    std::filesystem::create_directories(path);
 
                 return path / filename;
             }
@@ -96,5 +106,81 @@ namespace engine
 
             return data;
         }
+
+        MappedFile::MappedFile(const std::filesystem::path &path)
+        {
+#if defined(_WIN32) || defined(_WIN64)
+            m_File = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+            if (m_File == INVALID_HANDLE_VALUE)
+            {
+                m_File = nullptr;
+                throw std::runtime_error("Failed to open file: " + path.generic_string());
+            }
+
+            LARGE_INTEGER size;
+            GetFileSizeEx(m_File, &size);
+            m_Size = static_cast<size_t>(size.QuadPart);
+
+            if (m_Size == 0)
+                return;
+
+            m_Mapping = CreateFileMappingW(m_File, nullptr, PAGE_READONLY, 0, 0, nullptr);
+            if (m_Mapping)
+                m_Data = static_cast<const uint8_t *>(MapViewOfFile(m_Mapping, FILE_MAP_READ, 0, 0, 0));
+
+            if (!m_Data)
+            {
+                if (m_Mapping)
+                    CloseHandle(m_Mapping);
+                CloseHandle(m_File);
+                throw std::runtime_error("Failed to map file: " + path.generic_string());
+            }
+#else
+            int file = open(path.c_str(), O_RDONLY);
+            if (file < 0)
+                throw std::runtime_error("Failed to open file: " + path.generic_string());
+
+            struct stat file_stat;
+            if (fstat(file, &file_stat) != 0)
+            {
+                close(file);
+                throw std::runtime_error("Failed to stat file: " + path.generic_string());
+            }
+
+            m_Size = static_cast<size_t>(file_stat.st_size);
+
+            if (m_Size > 0)
+            {
+                void *data = mmap(nullptr, m_Size, PROT_READ, MAP_PRIVATE, file, 0);
+                if (data == MAP_FAILED)
+                {
+                    close(file);
+                    throw std::runtime_error("Failed to map file: " + path.generic_string());
+                }
+
+                // Meshes are read front to back, let the kernel read ahead aggressively
+                madvise(data, m_Size, MADV_SEQUENTIAL);
+                m_Data = static_cast<const uint8_t *>(data);
+            }
+
+            // The mapping keeps its own reference to the file
+            close(file);
+#endif
+        }
+
+        MappedFile::~MappedFile()
+        {
+#if defined(_WIN32) || defined(_WIN64)
+            if (m_Data)
+                UnmapViewOfFile(m_Data);
+            if (m_Mapping)
+                CloseHandle(m_Mapping);
+            if (m_File)
+                CloseHandle(m_File);
+#else
+            if (m_Data)
+                munmap(const_cast<uint8_t *>(m_Data), m_Size);
+#endif
+        }
     }
 }
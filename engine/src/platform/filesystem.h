@@ -12,6 +12,7 @@ namespace engine
                 Shaders,
                 Assets,
                 Fonts,
+                Cache,
 
                 SourceDirectory,
                 ExternalStorage,
@@ -26,5 +27,28 @@ namespace engine
 
         std::string ReadTextFile(const std::filesystem::path &path);
         std::vector<uint8_t> ReadBinaryFile(const std::filesystem::path &path);
+
+        // Read only view of a whole file, pages are loaded by the OS on first access instead of copied up front
+        class MappedFile
+        {
+        public:
+            MappedFile(const std::filesystem::path &path);
+            ~MappedFile();
+
+            MappedFile(const MappedFile &) = delete;
+            MappedFile &operator=(const MappedFile &) = delete;
+
+            const uint8_t *GetData() const { return m_Data; }
+            size_t GetSize() const { return m_Size; }
+
+        private:
+            const uint8_t *m_Data{nullptr};
+            size_t m_Size{0};
+
+#if defined(_WIN32) || defined(_WIN64)
+            void *m_File{nullptr};
+            void *m_Mapping{nullptr};
+#endif
+        };
     }
 }
\ No newline at end of file
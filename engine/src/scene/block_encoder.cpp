@@ -0,0 +1,663 @@
+#include "scene/block_encoder.h"
+
+#include "core/job_system.h"
+
+#include <mutex>
+
+ENG_DISABLE_WARNINGS()
+#define STB_DXT_IMPLEMENTATION
+#include <stb_dxt.h>
+ENG_ENABLE_WARNINGS()
+
+namespace engine
+{
+    namespace sg
+    {
+        namespace
+        {
+            // Block rows a job encodes at least
+            constexpr size_t MIN_BLOCK_ROWS_PER_RANGE = 8;
+
+            constexpr int BC7_WEIGHTS[16] = {0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64};
+
+            // Small and large intensity modifier of every ETC1 table
+            constexpr int ETC1_MODIFIERS[8][2] = {{2, 8}, {5, 17}, {9, 29}, {13, 42}, {18, 60}, {24, 80}, {33, 106}, {47, 183}};
+
+            constexpr int EAC_MODIFIERS[16][8] = {
+                {-3, -6, -9, -15, 2, 5, 8, 14},
+                {-3, -7, -10, -13, 2, 6, 9, 12},
+                {-2, -5, -8, -13, 1, 4, 7, 12},
+                {-2, -4, -6, -13, 1, 3, 5, 12},
+                {-3, -6, -8, -12, 2, 5, 7, 11},
+                {-3, -7, -9, -11, 2, 6, 8, 10},
+                {-4, -7, -8, -11, 3, 6, 7, 10},
+                {-3, -5, -8, -11, 2, 4, 7, 10},
+                {-2, -6, -8, -10, 1, 5, 7, 9},
+                {-2, -5, -8, -10, 1, 4, 7, 9},
+                {-2, -4, -8, -10, 1, 3, 7, 9},
+                {-2, -5, -7, -10, 1, 4, 6, 9},
+                {-3, -4, -7, -10, 2, 3, 6, 9},
+                {-1, -2, -3, -10, 0, 1, 2, 9},
+                {-4, -6, -8, -9, 3, 5, 7, 8},
+                {-3, -5, -7, -9, 2, 4, 6, 8}};
+
+            // EAC table with a zero modifier, used for blocks of a single alpha value
+            constexpr uint32_t EAC_ZERO_TABLE = 13;
+            constexpr uint32_t EAC_ZERO_INDEX = 4;
+
+            inline int Clamp255(int value)
+            {
+                return std::min(std::max(value, 0), 255);
+            }
+
+            // Little endian bit stream of a BC7 block
+            class BitWriter
+            {
+            public:
+                BitWriter(uint8_t *data)
+                    : m_Data(data)
+                {
+                    std::memset(m_Data, 0, 16);
+                }
+
+                void Write(uint32_t value, uint32_t bit_count)
+                {
+                    for (uint32_t bit = 0; bit < bit_count; bit++, m_Position++)
+                    {
+                        if ((value >> bit) & 1)
+                            m_Data[m_Position >> 3] |= static_cast<uint8_t>(1 << (m_Position & 7));
+                    }
+                }
+
+            private:
+                uint8_t *m_Data;
+                uint32_t m_Position{0};
+            };
+
+            // Mode 6 endpoints, 7 bits per channel and a shared lowest bit per endpoint
+            struct BC7Endpoints
+            {
+                int quantized[2][4];
+                int pbits[2];
+            };
+
+            BC7Endpoints QuantizeBC7(const float endpoints[2][4], int pbit0, int pbit1)
+            {
+                BC7Endpoints result{};
+                result.pbits[0] = pbit0;
+                result.pbits[1] = pbit1;
+
+                for (int endpoint = 0; endpoint < 2; endpoint++)
+                {
+                    for (int channel = 0; channel < 4; channel++)
+                    {
+                        auto value = (endpoints[endpoint][channel] - static_cast<float>(result.pbits[endpoint])) * 0.5f;
+                        result.quantized[endpoint][channel] = std::min(std::max(static_cast<int>(std::lround(value)), 0), 127);
+                    }
+                }
+
+                return result;
+            }
+
+            // Picks the closest palette entry of every texel, returns the squared error of the block
+            uint32_t FindBC7Indices(const BC7Endpoints &endpoints, const uint8_t *texels, uint8_t *indices)
+            {
+                int palette[16][4];
+
+                for (int index = 0; index < 16; index++)
+                {
+                    for (int channel = 0; channel < 4; channel++)
+                    {
+                        auto color0 = endpoints.quantized[0][channel] << 1 | endpoints.pbits[0];
+                        auto color1 = endpoints.quantized[1][channel] << 1 | endpoints.pbits[1];
+                        palette[index][channel] = ((64 - BC7_WEIGHTS[index]) * color0 + BC7_WEIGHTS[index] * color1 + 32) >> 6;
+                    }
+                }
+
+                int axis[4];
+                int axis_length = 0;
+
+                for (int channel = 0; channel < 4; channel++)
+                {
+                    axis[channel] = palette[15][channel] - palette[0][channel];
+                    axis_length += axis[channel] * axis[channel];
+                }
+
+                uint32_t total_error = 0;
+
+                for (int texel = 0; texel < 16; texel++)
+                {
+                    auto *color = texels + texel * 4;
+
+                    // The palette is close to evenly spaced, so only the neighbours of the projection are compared
+                    int estimate = 0;
+
+                    if (axis_length > 0)
+                    {
+                        int projection = 0;
+                        for (int channel = 0; channel < 4; channel++)
+                            projection += (color[channel] - palette[0][channel]) * axis[channel];
+
+                        estimate = std::min(std::max((projection * 15 + axis_length / 2) / axis_length, 0), 15);
+                    }
+
+                    uint32_t best_error = std::numeric_limits<uint32_t>::max();
+
+                    for (int index = std::max(estimate - 1, 0); index <= std::min(estimate + 1, 15); index++)
+                    {
+                        uint32_t error = 0;
+                        for (int channel = 0; channel < 4; channel++)
+                        {
+                            auto difference = palette[index][channel] - color[channel];
+                            error += static_cast<uint32_t>(difference * difference);
+                        }
+
+                        if (error < best_error)
+                        {
+                            best_error = error;
+                            indices[texel] = static_cast<uint8_t>(index);
+                        }
+                    }
+
+                    total_error += best_error;
+                }
+
+                return total_error;
+            }
+
+            // Tries every combination of p-bits, keeps the best in endpoints and indices
+            uint32_t FitBC7(const float endpoints[2][4], const uint8_t *texels, BC7Endpoints &best, uint8_t *best_indices, uint32_t best_error)
+            {
+                uint8_t indices[16];
+
+                for (int pbits = 0; pbits < 4; pbits++)
+                {
+                    auto candidate = QuantizeBC7(endpoints, pbits & 1, pbits >> 1);
+                    auto error = FindBC7Indices(candidate, texels, indices);
+
+                    if (error < best_error)
+                    {
+                        best_error = error;
+                        best = candidate;
+                        std::memcpy(best_indices, indices, sizeof(indices));
+                    }
+                }
+
+                return best_error;
+            }
+
+            // Base colors, tables and indices of one ETC1 subblock
+            struct ETCSubblock
+            {
+                int color[3];
+                uint32_t table{0};
+                uint32_t indices[8]{};
+                uint32_t error{0};
+            };
+
+            // Texel of the 4x4 block at position of a subblock, in ETC column order
+            inline uint32_t ETCTexelIndex(bool flip, uint32_t subblock, uint32_t position)
+            {
+                // Side by side 2x4 halves, or 4x2 halves on top of each other when flipped
+                uint32_t x = flip ? position % 4 : subblock * 2 + position % 2;
+                uint32_t y = flip ? subblock * 2 + position / 4 : position / 2;
+                return x * 4 + y;
+            }
+
+            void FitETCSubblock(const uint8_t *texels, bool flip, uint32_t subblock_index, ETCSubblock &subblock)
+            {
+                subblock.error = std::numeric_limits<uint32_t>::max();
+
+                for (uint32_t table = 0; table < 8; table++)
+                {
+                    const int modifiers[4] = {ETC1_MODIFIERS[table][0], ETC1_MODIFIERS[table][1], -ETC1_MODIFIERS[table][0], -ETC1_MODIFIERS[table][1]};
+
+                    uint32_t indices[8];
+                    uint32_t error = 0;
+
+                    for (uint32_t position = 0; position < 8; position++)
+                    {
+                        auto texel = ETCTexelIndex(flip, subblock_index, position);
+                        auto *color = texels + ((texel % 4) * 4 + texel / 4) * 4;
+
+                        uint32_t best_error = std::numeric_limits<uint32_t>::max();
+
+                        for (uint32_t index = 0; index < 4; index++)
+                        {
+                            uint32_t texel_error = 0;
+                            for (int channel = 0; channel < 3; channel++)
+                            {
+                                auto difference = Clamp255(subblock.color[channel] + modifiers[index]) - color[channel];
+                                texel_error += static_cast<uint32_t>(difference * difference);
+                            }
+
+                            if (texel_error < best_error)
+                            {
+                                best_error = texel_error;
+                                indices[position] = index;
+                            }
+                        }
+
+                        error += best_error;
+                    }
+
+                    if (error < subblock.error)
+                    {
+                        subblock.error = error;
+                        subblock.table = table;
+                        std::memcpy(subblock.indices, indices, sizeof(indices));
+                    }
+                }
+            }
+
+            void WriteBigEndian(uint64_t block, uint8_t *destination)
+            {
+                for (int byte = 0; byte < 8; byte++)
+                    destination[byte] = static_cast<uint8_t>(block >> (56 - byte * 8));
+            }
+
+            inline bool IsBC7(VkFormat format)
+            {
+                return format == VK_FORMAT_BC7_UNORM_BLOCK || format == VK_FORMAT_BC7_SRGB_BLOCK;
+            }
+
+            inline bool IsBC3(VkFormat format)
+            {
+                return format == VK_FORMAT_BC3_UNORM_BLOCK || format == VK_FORMAT_BC3_SRGB_BLOCK;
+            }
+
+            inline bool IsBC1(VkFormat format)
+            {
+                return format == VK_FORMAT_BC1_RGB_UNORM_BLOCK || format == VK_FORMAT_BC1_RGB_SRGB_BLOCK;
+            }
+
+            inline bool IsETC2RGBA(VkFormat format)
+            {
+                return format == VK_FORMAT_ETC2_R8G8B8A8_UNORM_BLOCK || format == VK_FORMAT_ETC2_R8G8B8A8_SRGB_BLOCK;
+            }
+
+            inline bool IsETC2RGB(VkFormat format)
+            {
+                return format == VK_FORMAT_ETC2_R8G8B8_UNORM_BLOCK || format == VK_FORMAT_ETC2_R8G8B8_SRGB_BLOCK;
+            }
+        }
+
+        bool IsBlockEncodable(VkFormat format)
+        {
+            return IsBC7(format) || IsBC3(format) || IsBC1(format) || IsETC2RGBA(format) || IsETC2RGB(format);
+        }
+
+        uint32_t GetBlockSize(VkFormat format)
+        {
+            return IsBC1(format) || IsETC2RGB(format) ? 8 : 16;
+        }
+
+        size_t GetEncodedSize(VkFormat format, uint32_t width, uint32_t height)
+        {
+            return static_cast<size_t>((width + 3) / 4) * ((height + 3) / 4) * GetBlockSize(format);
+        }
+
+        void EncodeBlocks(const uint8_t *rgba, uint32_t width, uint32_t height, VkFormat format, uint8_t *destination)
+        {
+            ENG_ASSERT(IsBlockEncodable(format), "Format can't be encoded");
+
+            // Older versions of stb_dxt fill their tables on first use
+            static std::once_flag stb_dxt_initialized;
+            std::call_once(stb_dxt_initialized, []()
+                           {
+                               uint8_t texels[64]{};
+                               uint8_t block[16];
+                               stb_compress_dxt_block(block, texels, 1, STB_DXT_HIGHQUAL);
+                           });
+
+            auto blocks_x = (width + 3) / 4;
+            auto blocks_y = (height + 3) / 4;
+            auto block_size = GetBlockSize(format);
+
+            JobSystem::Get().ParallelFor(blocks_y, MIN_BLOCK_ROWS_PER_RANGE, [&](size_t begin, size_t end)
+                                         {
+                                             uint8_t texels[64];
+
+                                             for (auto block_y = begin; block_y < end; block_y++)
+                                             {
+                                                 for (uint32_t block_x = 0; block_x < blocks_x; block_x++)
+                                                 {
+                                                     for (uint32_t y = 0; y < 4; y++)
+                                                     {
+                                                         auto source_y = std::min<size_t>(block_y * 4 + y, height - 1);
+
+                                                         for (uint32_t x = 0; x < 4; x++)
+                                                         {
+                                                             auto source_x = std::min<size_t>(block_x * 4 + x, width - 1);
+                                                             std::memcpy(texels + (y * 4 + x) * 4, rgba + (source_y * width + source_x) * 4, 4);
+                                                         }
+                                                     }
+
+                                                     auto *block = destination + (block_y * blocks_x + block_x) * block_size;
+
+                                                     if (IsBC7(format))
+                                                         EncodeBC7Block(texels, block);
+                                                     else if (IsBC3(format))
+                                                         stb_compress_dxt_block(block, texels, 1, STB_DXT_HIGHQUAL);
+                                                     else if (IsBC1(format))
+                                                         stb_compress_dxt_block(block, texels, 0, STB_DXT_HIGHQUAL);
+                                                     else if (IsETC2RGBA(format))
+                                                     {
+                                                         EncodeEACAlphaBlock(texels, block);
+                                                         EncodeETC2Block(texels, block + 8);
+                                                     }
+                                                     else
+                                                         EncodeETC2Block(texels, block);
+                                                 }
+                                             }
+                                         });
+        }
+
+        void EncodeBC7Block(const uint8_t *texels, uint8_t *destination)
+        {
+            // Principal axis of the colors through their mean, found by power iteration
+            float mean[4]{};
+            for (int texel = 0; texel < 16; texel++)
+            {
+                for (int channel = 0; channel < 4; channel++)
+                    mean[channel] += texels[texel * 4 + channel] / 16.0f;
+            }
+
+            float covariance[4][4]{};
+            for (int texel = 0; texel < 16; texel++)
+            {
+                for (int row = 0; row < 4; row++)
+                {
+                    for (int column = 0; column < 4; column++)
+                        covariance[row][column] += (texels[texel * 4 + row] - mean[row]) * (texels[texel * 4 + column] - mean[column]);
+                }
+            }
+
+            float axis[4] = {1.0f, 1.0f, 1.0f, 1.0f};
+            for (int iteration = 0; iteration < 8; iteration++)
+            {
+                float next[4]{};
+                for (int row = 0; row < 4; row++)
+                {
+                    for (int column = 0; column < 4; column++)
+                        next[row] += covariance[row][column] * axis[column];
+                }
+
+                auto length = std::max({std::abs(next[0]), std::abs(next[1]), std::abs(next[2]), std::abs(next[3])});
+                if (length <= 0.0f)
+                    break;
+
+                for (int channel = 0; channel < 4; channel++)
+                    axis[channel] = next[channel] / length;
+            }
+
+            float min_projection = std::numeric_limits<float>::max();
+            float max_projection = std::numeric_limits<float>::lowest();
+            float axis_length = axis[0] * axis[0] + axis[1] * axis[1] + axis[2] * axis[2] + axis[3] * axis[3];
+
+            for (int texel = 0; texel < 16; texel++)
+            {
+                float projection = 0.0f;
+                for (int channel = 0; channel < 4; channel++)
+                    projection += (texels[texel * 4 + channel] - mean[channel]) * axis[channel];
+
+                min_projection = std::min(min_projection, projection / axis_length);
+                max_projection = std::max(max_projection, projection / axis_length);
+            }
+
+            float endpoints[2][4];
+            for (int channel = 0; channel < 4; channel++)
+            {
+                endpoints[0][channel] = std::min(std::max(mean[channel] + axis[channel] * min_projection, 0.0f), 255.0f);
+                endpoints[1][channel] = std::min(std::max(mean[channel] + axis[channel] * max_projection, 0.0f), 255.0f);
+            }
+
+            BC7Endpoints best{};
+            uint8_t indices[16]{};
+            auto error = FitBC7(endpoints, texels, best, indices, std::numeric_limits<uint32_t>::max());
+
+            // Least squares endpoints for the chosen indices, kept when they lower the error
+            if (error > 0)
+            {
+                float aa = 0.0f, ab = 0.0f, bb = 0.0f;
+                float ax[4]{}, bx[4]{};
+
+                for (int texel = 0; texel < 16; texel++)
+                {
+                    auto b = BC7_WEIGHTS[indices[texel]] / 64.0f;
+                    auto a = 1.0f - b;
+
+                    aa += a * a;
+                    ab += a * b;
+                    bb += b * b;
+
+                    for (int channel = 0; channel < 4; channel++)
+                    {
+                        ax[channel] += a * texels[texel * 4 + channel];
+                        bx[channel] += b * texels[texel * 4 + channel];
+                    }
+                }
+
+                auto determinant = aa * bb - ab * ab;
+
+                if (std::abs(determinant) > 1e-6f)
+                {
+                    for (int channel = 0; channel < 4; channel++)
+                    {
+                        endpoints[0][channel] = std::min(std::max((bb * ax[channel] - ab * bx[channel]) / determinant, 0.0f), 255.0f);
+                        endpoints[1][channel] = std::min(std::max((aa * bx[channel] - ab * ax[channel]) / determinant, 0.0f), 255.0f);
+                    }
+
+                    FitBC7(endpoints, texels, best, indices, error);
+                }
+            }
+
+            // The first index has an implicit zero high bit, so its endpoints are swapped when it is set
+            if (indices[0] >= 8)
+            {
+                std::swap(best.quantized[0], best.quantized[1]);
+                std::swap(best.pbits[0], best.pbits[1]);
+
+                for (auto &index : indices)
+                    index = static_cast<uint8_t>(15 - index);
+            }
+
+            BitWriter writer(destination);
+            writer.Write(1 << 6, 7);
+
+            for (int channel = 0; channel < 4; channel++)
+            {
+                writer.Write(static_cast<uint32_t>(best.quantized[0][channel]), 7);
+                writer.Write(static_cast<uint32_t>(best.quantized[1][channel]), 7);
+            }
+
+            writer.Write(static_cast<uint32_t>(best.pbits[0]), 1);
+            writer.Write(static_cast<uint32_t>(best.pbits[1]), 1);
+
+            for (int texel = 0; texel < 16; texel++)
+                writer.Write(indices[texel], texel == 0 ? 3 : 4);
+        }
+
+        void EncodeETC2Block(const uint8_t *texels, uint8_t *destination)
+        {
+            uint64_t best_block = 0;
+            uint32_t best_error = std::numeric_limits<uint32_t>::max();
+
+            for (int flip = 0; flip < 2; flip++)
+            {
+                float averages[2][3]{};
+
+                for (uint32_t subblock = 0; subblock < 2; subblock++)
+                {
+                    for (uint32_t position = 0; position < 8; position++)
+                    {
+                        auto texel = ETCTexelIndex(flip, subblock, position);
+                        for (int channel = 0; channel < 3; channel++)
+                            averages[subblock][channel] += texels[((texel % 4) * 4 + texel / 4) * 4 + channel] / 8.0f;
+                    }
+                }
+
+                // Differential mode keeps 5 bits per base color when the second is close enough to the first,
+                // its deltas have to stay in range as ETC2 reads overflowing ones as other modes
+                int base5[2][3];
+                bool differential = true;
+
+                for (int subblock = 0; subblock < 2; subblock++)
+                {
+                    for (int channel = 0; channel < 3; channel++)
+                        base5[subblock][channel] = std::min(std::max(static_cast<int>(std::lround(averages[subblock][channel] * 31.0f / 255.0f)), 0), 31);
+                }
+
+                for (int channel = 0; channel < 3; channel++)
+                {
+                    auto delta = base5[1][channel] - base5[0][channel];
+                    differential = differential && delta >= -4 && delta <= 3;
+                }
+
+                ETCSubblock subblocks[2];
+                int base4[2][3];
+
+                for (int subblock = 0; subblock < 2; subblock++)
+                {
+                    for (int channel = 0; channel < 3; channel++)
+                    {
+                        if (differential)
+                        {
+                            subblocks[subblock].color[channel] = base5[subblock][channel] << 3 | base5[subblock][channel] >> 2;
+                        }
+                        else
+                        {
+                            base4[subblock][channel] = std::min(std::max(static_cast<int>(std::lround(averages[subblock][channel] * 15.0f / 255.0f)), 0), 15);
+                            subblocks[subblock].color[channel] = base4[subblock][channel] * 17;
+                        }
+                    }
+
+                    FitETCSubblock(texels, flip, subblock, subblocks[subblock]);
+                }
+
+                auto error = subblocks[0].error + subblocks[1].error;
+                if (error >= best_error)
+                    continue;
+
+                uint64_t block = 0;
+
+                for (int channel = 0; channel < 3; channel++)
+                {
+                    auto shift = 59 - channel * 8;
+
+                    if (differential)
+                    {
+                        auto delta = static_cast<uint64_t>((base5[1][channel] - base5[0][channel]) & 7);
+                        block |= static_cast<uint64_t>(base5[0][channel]) << shift | delta << (shift - 3);
+                    }
+                    else
+                    {
+                        block |= static_cast<uint64_t>(base4[0][channel]) << (shift + 1) | static_cast<uint64_t>(base4[1][channel]) << (shift - 3);
+                    }
+                }
+
+                block |= static_cast<uint64_t>(subblocks[0].table) << 37 | static_cast<uint64_t>(subblocks[1].table) << 34;
+                block |= static_cast<uint64_t>(differential ? 1 : 0) << 33 | static_cast<uint64_t>(flip) << 32;
+
+                for (uint32_t subblock = 0; subblock < 2; subblock++)
+                {
+                    for (uint32_t position = 0; position < 8; position++)
+                    {
+                        auto texel = ETCTexelIndex(flip, subblock, position);
+                        auto index = subblocks[subblock].indices[position];
+
+                        block |= static_cast<uint64_t>(index >> 1) << (16 + texel) | static_cast<uint64_t>(index & 1) << texel;
+                    }
+                }
+
+                best_error = error;
+                best_block = block;
+            }
+
+            WriteBigEndian(best_block, destination);
+        }
+
+        void EncodeEACAlphaBlock(const uint8_t *texels, uint8_t *destination)
+        {
+            int min_alpha = 255, max_alpha = 0;
+
+            for (int texel = 0; texel < 16; texel++)
+            {
+                min_alpha = std::min<int>(min_alpha, texels[texel * 4 + 3]);
+                max_alpha = std::max<int>(max_alpha, texels[texel * 4 + 3]);
+            }
+
+            uint32_t best_base = static_cast<uint32_t>(min_alpha), best_multiplier = 1, best_table = EAC_ZERO_TABLE;
+            uint32_t best_indices[16];
+            std::fill(std::begin(best_indices), std::end(best_indices), EAC_ZERO_INDEX);
+
+            if (min_alpha != max_alpha)
+            {
+                uint32_t best_error = std::numeric_limits<uint32_t>::max();
+
+                for (uint32_t table = 0; table < 16; table++)
+                {
+                    auto &modifiers = EAC_MODIFIERS[table];
+                    auto range = static_cast<float>(modifiers[7] - modifiers[3]);
+                    auto estimate = static_cast<float>(max_alpha - min_alpha) / range;
+
+                    for (int multiplier = static_cast<int>(estimate); multiplier <= static_cast<int>(estimate) + 1; multiplier++)
+                    {
+                        if (multiplier < 1 || multiplier > 15)
+                            continue;
+
+                        auto center = ((min_alpha - modifiers[3] * multiplier) + (max_alpha - modifiers[7] * multiplier)) / 2;
+
+                        for (int base = center - 1; base <= center + 1; base++)
+                        {
+                            if (base < 0 || base > 255)
+                                continue;
+
+                            uint32_t indices[16];
+                            uint32_t error = 0;
+
+                            for (int texel = 0; texel < 16 && error < best_error; texel++)
+                            {
+                                uint32_t texel_error = std::numeric_limits<uint32_t>::max();
+
+                                for (uint32_t index = 0; index < 8; index++)
+                                {
+                                    auto difference = Clamp255(base + modifiers[index] * multiplier) - texels[texel * 4 + 3];
+                                    auto squared = static_cast<uint32_t>(difference * difference);
+
+                                    if (squared < texel_error)
+                                    {
+                                        texel_error = squared;
+                                        indices[texel] = index;
+                                    }
+                                }
+
+                                error += texel_error;
+                            }
+
+                            if (error < best_error)
+                            {
+                                best_error = error;
+                                best_base = static_cast<uint32_t>(base);
+                                best_multiplier = static_cast<uint32_t>(multiplier);
+                                best_table = table;
+                                std::memcpy(best_indices, indices, sizeof(indices));
+                            }
+                        }
+                    }
+                }
+            }
+
+            uint64_t block = static_cast<uint64_t>(best_base) << 56 | static_cast<uint64_t>(best_multiplier) << 52 | static_cast<uint64_t>(best_table) << 48;
+
+            // Indices are in column order, the first texel in the highest bits
+            for (uint32_t y = 0; y < 4; y++)
+            {
+                for (uint32_t x = 0; x < 4; x++)
+                    block |= static_cast<uint64_t>(best_indices[y * 4 + x]) << (45 - (x * 4 + y) * 3);
+            }
+
+            WriteBigEndian(block, destination);
+        }
+    }
+}
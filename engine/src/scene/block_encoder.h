@@ -0,0 +1,26 @@
+#pragma once
+
+namespace engine
+{
+    namespace sg
+    {
+        // Block compressed formats RGBA8 images can be encoded to on the CPU, in both UNORM and sRGB:
+        // BC7 (mode 6 only), BC3, BC1, ETC2 RGBA8 and ETC2 RGB8
+        bool IsBlockEncodable(VkFormat format);
+
+        // Bytes of one 4x4 block
+        uint32_t GetBlockSize(VkFormat format);
+
+        // Size of an encoded level, partial blocks at the edges included
+        size_t GetEncodedSize(VkFormat format, uint32_t width, uint32_t height);
+
+        // Encodes one RGBA8 level, edge blocks repeat the last row and column. Block rows are split
+        // across the job system's workers
+        void EncodeBlocks(const uint8_t *rgba, uint32_t width, uint32_t height, VkFormat format, uint8_t *destination);
+
+        // Encoders of a single block of 16 RGBA8 texels in row order
+        void EncodeBC7Block(const uint8_t *texels, uint8_t *destination);
+        void EncodeETC2Block(const uint8_t *texels, uint8_t *destination);
+        void EncodeEACAlphaBlock(const uint8_t *texels, uint8_t *destination);
+    }
+}
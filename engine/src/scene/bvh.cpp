@@ -0,0 +1,490 @@
+#include "scene/bvh.h"
+
+#include "core/job_system.h"
+
+#include <numeric>
+
+namespace engine
+{
+    namespace sg
+    {
+        namespace
+        {
+            constexpr uint32_t BIN_COUNT = 16;
+            constexpr uint32_t MAX_LEAF_ITEMS = 4;
+            constexpr uint32_t MAX_DEPTH = 56;
+            constexpr uint32_t STACK_SIZE = 64;
+            constexpr uint32_t PARALLEL_ITEM_THRESHOLD = 4096;
+            constexpr uint32_t PARALLEL_DEPTH = 3;
+            constexpr size_t PARALLEL_CULL_RANGE_SIZE = 2048;
+
+            inline float HalfArea(const AABB &bounds)
+            {
+                if (!bounds.IsValid())
+                    return 0.0f;
+
+                auto extent = bounds.GetMax() - bounds.GetMin();
+                return extent.x * extent.y + extent.y * extent.z + extent.z * extent.x;
+            }
+
+            inline float DistanceSquared(const AABB &bounds, const glm::vec3 &point)
+            {
+                auto delta = glm::max(glm::max(bounds.GetMin() - point, point - bounds.GetMax()), glm::vec3(0.0f));
+                return glm::dot(delta, delta);
+            }
+
+            inline bool IntersectRay(const AABB &bounds, const glm::vec3 &origin, const glm::vec3 &inverse_direction,
+                                     float max_distance, float &distance)
+            {
+                auto t0 = (bounds.GetMin() - origin) * inverse_direction;
+                auto t1 = (bounds.GetMax() - origin) * inverse_direction;
+
+                auto t_min = glm::min(t0, t1);
+                auto t_max = glm::max(t0, t1);
+
+                float enter_distance = std::max(std::max(t_min.x, t_min.y), std::max(t_min.z, 0.0f));
+                float exit_distance = std::min(std::min(t_max.x, t_max.y), std::min(t_max.z, max_distance));
+
+                distance = enter_distance;
+                return enter_distance <= exit_distance;
+            }
+
+            inline bool Equals(const AABB &left, const AABB &right)
+            {
+                return left.GetMin() == right.GetMin() && left.GetMax() == right.GetMax();
+            }
+        }
+
+        void BVH::Build(const std::vector<AABB> &item_bounds)
+        {
+            Clear();
+
+            auto item_count = ToUint32_t(item_bounds.size());
+            if (item_count == 0)
+                return;
+
+            m_ItemBounds = item_bounds;
+            m_Items.resize(item_count);
+            std::iota(m_Items.begin(), m_Items.end(), 0);
+
+            m_Centroids.resize(item_count);
+            for (uint32_t item = 0; item < item_count; item++)
+                m_Centroids[item] = m_ItemBounds[item].GetCenter();
+
+            // A binary tree with at most one leaf per item
+            m_Nodes.resize(2 * item_count - 1);
+            m_NodeCount = 1;
+
+            BuildNode(0, 0, item_count, 0);
+
+            m_Nodes.resize(m_NodeCount);
+
+            m_ItemLeaves.resize(item_count);
+            m_LeafDirty.assign(m_Nodes.size(), 0);
+
+            for (uint32_t node_index = 0; node_index < m_Nodes.size(); node_index++)
+            {
+                auto &node = m_Nodes[node_index];
+                for (uint32_t i = node.first; i < node.first + node.count; i++)
+                    m_ItemLeaves[m_Items[i]] = node_index;
+            }
+        }
+
+        void BVH::Clear()
+        {
+            m_Nodes.clear();
+            m_NodeCount = 0;
+            m_Items.clear();
+            m_ItemBounds.clear();
+            m_Centroids.clear();
+            m_ItemLeaves.clear();
+            m_DirtyLeaves.clear();
+            m_LeafDirty.clear();
+        }
+
+        void BVH::BuildNode(uint32_t node_index, uint32_t begin, uint32_t end, uint32_t depth)
+        {
+            AABB bounds;
+            AABB centroid_bounds;
+
+            for (uint32_t i = begin; i < end; i++)
+            {
+                bounds.Update(m_ItemBounds[m_Items[i]]);
+                centroid_bounds.Update(m_Centroids[m_Items[i]]);
+            }
+
+            m_Nodes[node_index].bounds = bounds;
+
+            uint32_t count = end - begin;
+
+            auto make_leaf = [&]()
+            {
+                m_Nodes[node_index].first = begin;
+                m_Nodes[node_index].count = count;
+            };
+
+            if (count <= MAX_LEAF_ITEMS || depth >= MAX_DEPTH)
+            {
+                make_leaf();
+                return;
+            }
+
+            struct Bin
+            {
+                AABB bounds;
+                uint32_t count{0};
+            };
+
+            int best_axis = -1;
+            uint32_t best_split = 0;
+            float best_cost = std::numeric_limits<float>::max();
+
+            auto centroid_min = centroid_bounds.GetMin();
+            auto centroid_extent = centroid_bounds.GetMax() - centroid_min;
+
+            for (int axis = 0; axis < 3; axis++)
+            {
+                if (centroid_extent[axis] <= 0.0f)
+                    continue;
+
+                float scale = BIN_COUNT / centroid_extent[axis];
+                std::array<Bin, BIN_COUNT> bins{};
+
+                for (uint32_t i = begin; i < end; i++)
+                {
+                    auto item = m_Items[i];
+                    auto bin = std::min(BIN_COUNT - 1, static_cast<uint32_t>((m_Centroids[item][axis] - centroid_min[axis]) * scale));
+                    bins[bin].count++;
+                    bins[bin].bounds.Update(m_ItemBounds[item]);
+                }
+
+                // Sweep from the right to get the cost of every right side, then from the left
+                std::array<float, BIN_COUNT> right_cost{};
+                AABB right_bounds;
+                uint32_t right_count = 0;
+
+                for (uint32_t bin = BIN_COUNT - 1; bin > 0; bin--)
+                {
+                    right_bounds.Update(bins[bin].bounds);
+                    right_count += bins[bin].count;
+                    right_cost[bin] = right_count * HalfArea(right_bounds);
+                }
+
+                AABB left_bounds;
+                uint32_t left_count = 0;
+
+                for (uint32_t split = 1; split < BIN_COUNT; split++)
+                {
+                    left_bounds.Update(bins[split - 1].bounds);
+                    left_count += bins[split - 1].count;
+
+                    if (left_count == 0 || left_count == count)
+                        continue;
+
+                    float cost = left_count * HalfArea(left_bounds) + right_cost[split];
+                    if (cost < best_cost)
+                    {
+                        best_cost = cost;
+                        best_axis = axis;
+                        best_split = split;
+                    }
+                }
+            }
+
+            uint32_t middle = begin;
+
+            if (best_axis >= 0)
+            {
+                float leaf_cost = count * HalfArea(bounds);
+                if (best_cost >= leaf_cost && count <= 4 * MAX_LEAF_ITEMS)
+                {
+                    make_leaf();
+                    return;
+                }
+
+                float scale = BIN_COUNT / centroid_extent[best_axis];
+                auto split_it = std::partition(m_Items.begin() + begin, m_Items.begin() + end,
+                                               [&](uint32_t item)
+                                               {
+                                                   auto bin = std::min(BIN_COUNT - 1, static_cast<uint32_t>((m_Centroids[item][best_axis] - centroid_min[best_axis]) * scale));
+                                                   return bin < best_split;
+                                               });
+
+                middle = static_cast<uint32_t>(split_it - m_Items.begin());
+            }
+
+            // All centroids coincide, split in the middle of the range
+            if (middle == begin || middle == end)
+                middle = begin + count / 2;
+
+            uint32_t left = m_NodeCount.fetch_add(2);
+
+            m_Nodes[node_index].first = left;
+            m_Nodes[node_index].count = 0;
+            m_Nodes[left].parent = static_cast<int32_t>(node_index);
+            m_Nodes[left + 1].parent = static_cast<int32_t>(node_index);
+
+            if (count >= PARALLEL_ITEM_THRESHOLD && depth < PARALLEL_DEPTH)
+            {
+                auto &job_system = JobSystem::Get();
+
+                JobCounter left_build;
+                job_system.Run([this, left, begin, middle, depth]()
+                               { BuildNode(left, begin, middle, depth + 1); },
+                               &left_build);
+
+                BuildNode(left + 1, middle, end, depth + 1);
+                job_system.Wait(left_build);
+            }
+            else
+            {
+                BuildNode(left, begin, middle, depth + 1);
+                BuildNode(left + 1, middle, end, depth + 1);
+            }
+        }
+
+        void BVH::Update(uint32_t item, const AABB &bounds)
+        {
+            m_ItemBounds[item] = bounds;
+
+            auto leaf = m_ItemLeaves[item];
+            if (!m_LeafDirty[leaf])
+            {
+                m_LeafDirty[leaf] = 1;
+                m_DirtyLeaves.push_back(leaf);
+            }
+        }
+
+        void BVH::RefitNode(uint32_t node_index)
+        {
+            auto &node = m_Nodes[node_index];
+            AABB bounds;
+
+            if (node.count > 0)
+            {
+                for (uint32_t i = node.first; i < node.first + node.count; i++)
+                    bounds.Update(m_ItemBounds[m_Items[i]]);
+            }
+            else
+            {
+                bounds.Update(m_Nodes[node.first].bounds);
+                bounds.Update(m_Nodes[node.first + 1].bounds);
+            }
+
+            node.bounds = bounds;
+        }
+
+        void BVH::Refit()
+        {
+            if (m_DirtyLeaves.empty())
+                return;
+
+            if (m_DirtyLeaves.size() * 8 > m_Nodes.size())
+            {
+                // Children are always stored after their parent
+                for (size_t node_index = m_Nodes.size(); node_index-- > 0;)
+                    RefitNode(static_cast<uint32_t>(node_index));
+            }
+            else
+            {
+                for (auto leaf : m_DirtyLeaves)
+                {
+                    RefitNode(leaf);
+
+                    for (auto parent = m_Nodes[leaf].parent; parent >= 0; parent = m_Nodes[parent].parent)
+                    {
+                        auto previous = m_Nodes[parent].bounds;
+                        RefitNode(static_cast<uint32_t>(parent));
+
+                        if (Equals(previous, m_Nodes[parent].bounds))
+                            break;
+                    }
+                }
+            }
+
+            for (auto leaf : m_DirtyLeaves)
+                m_LeafDirty[leaf] = 0;
+
+            m_DirtyLeaves.clear();
+        }
+
+        void BVH::Cull(const Frustum &frustum, CullResult &result) const
+        {
+            result.visible.clear();
+            result.candidates.clear();
+
+            if (m_Nodes.empty())
+                return;
+
+            std::array<std::pair<uint32_t, bool>, STACK_SIZE> stack;
+            uint32_t stack_size = 0;
+            stack[stack_size++] = {0, false};
+
+            while (stack_size > 0)
+            {
+                auto [node_index, inside] = stack[--stack_size];
+                auto &node = m_Nodes[node_index];
+
+                if (!inside)
+                {
+                    auto test = frustum.Classify(node.bounds);
+                    if (test == FrustumTest::Outside)
+                        continue;
+
+                    inside = test == FrustumTest::Inside;
+                }
+
+                if (node.count == 0)
+                {
+                    stack[stack_size++] = {node.first, inside};
+                    stack[stack_size++] = {node.first + 1, inside};
+                    continue;
+                }
+
+                // Items of leaves on the frustum boundary are tested together afterwards
+                auto &items = inside ? result.visible : result.candidates;
+                items.insert(items.end(), m_Items.begin() + node.first, m_Items.begin() + node.first + node.count);
+            }
+
+            auto candidate_count = result.candidates.size();
+            result.candidate_bounds.Resize(candidate_count);
+            result.candidate_visibility.resize(candidate_count);
+
+            for (size_t i = 0; i < candidate_count; i++)
+                result.candidate_bounds.Set(i, m_ItemBounds[result.candidates[i]]);
+
+            // Large candidate sets are tested in ranges on the workers
+            JobSystem::Get().ParallelFor(candidate_count, PARALLEL_CULL_RANGE_SIZE,
+                                         [&frustum, &result](size_t begin, size_t end)
+                                         { frustum.Intersects(result.candidate_bounds, begin, end, result.candidate_visibility.data()); });
+
+            for (size_t i = 0; i < candidate_count; i++)
+            {
+                if (result.candidate_visibility[i])
+                    result.visible.push_back(result.candidates[i]);
+            }
+        }
+
+        bool BVH::Raycast(const glm::vec3 &origin, const glm::vec3 &direction, float max_distance,
+                          uint32_t &item, float &distance) const
+        {
+            if (m_Nodes.empty())
+                return false;
+
+            auto inverse_direction = 1.0f / direction;
+            bool hit = false;
+            distance = max_distance;
+
+            std::array<uint32_t, STACK_SIZE> stack;
+            uint32_t stack_size = 0;
+            stack[stack_size++] = 0;
+
+            while (stack_size > 0)
+            {
+                auto &node = m_Nodes[stack[--stack_size]];
+
+                float node_distance;
+                if (!IntersectRay(node.bounds, origin, inverse_direction, distance, node_distance))
+                    continue;
+
+                if (node.count > 0)
+                {
+                    for (uint32_t i = node.first; i < node.first + node.count; i++)
+                    {
+                        float item_distance;
+                        if (IntersectRay(m_ItemBounds[m_Items[i]], origin, inverse_direction, distance, item_distance) &&
+                            item_distance < distance)
+                        {
+                            distance = item_distance;
+                            item = m_Items[i];
+                            hit = true;
+                        }
+                    }
+
+                    continue;
+                }
+
+                // Push the farther child first so the nearer one is visited first
+                float left_distance, right_distance;
+                bool left_hit = IntersectRay(m_Nodes[node.first].bounds, origin, inverse_direction, distance, left_distance);
+                bool right_hit = IntersectRay(m_Nodes[node.first + 1].bounds, origin, inverse_direction, distance, right_distance);
+
+                if (left_hit && right_hit)
+                {
+                    bool left_first = left_distance <= right_distance;
+                    stack[stack_size++] = left_first ? node.first + 1 : node.first;
+                    stack[stack_size++] = left_first ? node.first : node.first + 1;
+                }
+                else if (left_hit)
+                {
+                    stack[stack_size++] = node.first;
+                }
+                else if (right_hit)
+                {
+                    stack[stack_size++] = node.first + 1;
+                }
+            }
+
+            return hit;
+        }
+
+        void BVH::FindNearest(const glm::vec3 &point, size_t count, std::vector<std::pair<float, uint32_t>> &results) const
+        {
+            results.clear();
+
+            if (m_Nodes.empty() || count == 0)
+                return;
+
+            // results is kept as a max heap on distance while searching
+            auto worst_distance = [&]()
+            {
+                return results.size() < count ? std::numeric_limits<float>::max() : results.front().first;
+            };
+
+            std::array<uint32_t, STACK_SIZE> stack;
+            uint32_t stack_size = 0;
+            stack[stack_size++] = 0;
+
+            while (stack_size > 0)
+            {
+                auto &node = m_Nodes[stack[--stack_size]];
+
+                if (DistanceSquared(node.bounds, point) > worst_distance())
+                    continue;
+
+                if (node.count > 0)
+                {
+                    for (uint32_t i = node.first; i < node.first + node.count; i++)
+                    {
+                        float item_distance = DistanceSquared(m_ItemBounds[m_Items[i]], point);
+                        if (item_distance >= worst_distance())
+                            continue;
+
+                        if (results.size() == count)
+                        {
+                            std::pop_heap(results.begin(), results.end());
+                            results.pop_back();
+                        }
+
+                        results.emplace_back(item_distance, m_Items[i]);
+                        std::push_heap(results.begin(), results.end());
+                    }
+
+                    continue;
+                }
+
+                float left_distance = DistanceSquared(m_Nodes[node.first].bounds, point);
+                float right_distance = DistanceSquared(m_Nodes[node.first + 1].bounds, point);
+                bool left_first = left_distance <= right_distance;
+
+                stack[stack_size++] = left_first ? node.first + 1 : node.first;
+                stack[stack_size++] = left_first ? node.first : node.first + 1;
+            }
+
+            std::sort_heap(results.begin(), results.end());
+
+            for (auto &result : results)
+                result.first = std::sqrt(result.first);
+        }
+    }
+}
@@ -0,0 +1,70 @@
+#pragma once
+
+#include "scene/frustum.h"
+
+#include <atomic>
+
+namespace engine
+{
+    namespace sg
+    {
+        // Binned SAH bounding volume hierarchy over item bounds, items are indices into the build array
+        class BVH
+        {
+        public:
+            struct Node
+            {
+                AABB bounds;
+                // First child for interior nodes, first entry in the item list for leaves
+                uint32_t first{0};
+                // Item count, 0 for interior nodes
+                uint32_t count{0};
+                int32_t parent{-1};
+            };
+
+            // Reused between frustum queries so culling doesn't allocate once warmed up
+            struct CullResult
+            {
+                std::vector<uint32_t> visible;
+                std::vector<uint32_t> candidates;
+                BoundsBatch candidate_bounds;
+                std::vector<uint8_t> candidate_visibility;
+            };
+
+            BVH() = default;
+            ~BVH() = default;
+
+            void Build(const std::vector<AABB> &item_bounds);
+            void Clear();
+
+            // Stores new bounds for an item, the tree is refit on the next Refit call
+            void Update(uint32_t item, const AABB &bounds);
+            void Refit();
+
+            void Cull(const Frustum &frustum, CullResult &result) const;
+            bool Raycast(const glm::vec3 &origin, const glm::vec3 &direction, float max_distance,
+                         uint32_t &item, float &distance) const;
+            // Writes up to count items ordered by the distance of their bounds to point
+            void FindNearest(const glm::vec3 &point, size_t count, std::vector<std::pair<float, uint32_t>> &results) const;
+
+            const std::vector<Node> &GetNodes() const { return m_Nodes; }
+            const AABB &GetItemBounds(uint32_t item) const { return m_ItemBounds[item]; }
+            size_t GetItemCount() const { return m_ItemBounds.size(); }
+
+        private:
+            void BuildNode(uint32_t node_index, uint32_t begin, uint32_t end, uint32_t depth);
+            void RefitNode(uint32_t node_index);
+
+            std::vector<Node> m_Nodes;
+            std::atomic<uint32_t> m_NodeCount{0};
+
+            std::vector<uint32_t> m_Items;
+            std::vector<AABB> m_ItemBounds;
+            std::vector<glm::vec3> m_Centroids;
+            std::vector<uint32_t> m_ItemLeaves;
+
+            std::vector<uint32_t> m_DirtyLeaves;
+            std::vector<uint8_t> m_LeafDirty;
+        };
+    }
+}
@@ -24,6 +24,12 @@ namespace engine
             m_Max = glm::max(m_Max, point);
         }
 
+        void AABB::Update(const AABB &other)
+        {
+            m_Min = glm::min(m_Min, other.m_Min);
+            m_Max = glm::max(m_Max, other.m_Max);
+        }
+
         void AABB::Update(const std::vector<glm::vec3> &vertex_data, const std::vector<uint16_t> &index_data)
         {
             if (index_data.size() > 0)
@@ -42,24 +48,27 @@ namespace engine
             }
         }
 
-        void AABB::Transform(glm::mat4 &transform)
+        void AABB::Transform(const glm::mat4 &transform)
         {
-            m_Min = m_Max = glm::vec4(m_Min, 1.0f) * transform;
+            if (!IsValid())
+                return;
+
+            // Transform the center and project the extent onto the new axes
+            glm::vec3 center{transform * glm::vec4(GetCenter(), 1.0f)};
+            glm::vec3 extent = GetExtent();
+            glm::mat3 absolute{glm::abs(glm::vec3(transform[0])),
+                               glm::abs(glm::vec3(transform[1])),
+                               glm::abs(glm::vec3(transform[2]))};
+            extent = absolute * extent;
 
-            // Update bounding box for the remaining 7 corners of the box
-            Update(glm::vec4(m_Min.x, m_Min.y, m_Max.z, 1.0f) * transform);
-            Update(glm::vec4(m_Min.x, m_Max.y, m_Min.z, 1.0f) * transform);
-            Update(glm::vec4(m_Min.x, m_Max.y, m_Max.z, 1.0f) * transform);
-            Update(glm::vec4(m_Max.x, m_Min.y, m_Min.z, 1.0f) * transform);
-            Update(glm::vec4(m_Max.x, m_Min.y, m_Max.z, 1.0f) * transform);
-            Update(glm::vec4(m_Max.x, m_Max.y, m_Min.z, 1.0f) * transform);
-            Update(glm::vec4(m_Max, 1.0f) * transform);
+            m_Min = center - extent;
+            m_Max = center + extent;
         }
 
         void AABB::Reset()
         {
-            m_Min = std::numeric_limits<glm::vec3>::max();
-            m_Max = std::numeric_limits<glm::vec3>::min();
+            m_Min = glm::vec3(std::numeric_limits<float>::max());
+            m_Max = glm::vec3(std::numeric_limits<float>::lowest());
         }
     }
 }
\ No newline at end of file
@@ -14,12 +14,15 @@ namespace engine
             ~AABB();
 
             void Update(const glm::vec3 &point);
+            void Update(const AABB &other);
             void Update(const std::vector<glm::vec3> &vertex_data, const std::vector<uint16_t> &index_data);
-            void Transform(glm::mat4 &transform);
+            void Transform(const glm::mat4 &transform);
             void Reset();
 
             glm::vec3 GetCenter() const { return (m_Min + m_Max) * 0.5f; }
             glm::vec3 GetScale() const { return (m_Max - m_Min); }
+            glm::vec3 GetExtent() const { return (m_Max - m_Min) * 0.5f; }
+            bool IsValid() const { return m_Min.x <= m_Max.x && m_Min.y <= m_Max.y && m_Min.z <= m_Max.z; }
 
             glm::vec3 GetMin() const { return m_Min; }
             glm::vec3 GetMax() const { return m_Max; }
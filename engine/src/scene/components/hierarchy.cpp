@@ -0,0 +1,15 @@
+#include "scene/components/hierarchy.h"
+
+namespace engine
+{
+    namespace sg
+    {
+        Hierarchy::Hierarchy()
+        {
+        }
+
+        Hierarchy::~Hierarchy()
+        {
+        }
+    }
+}
@@ -0,0 +1,30 @@
+#pragma once
+
+ENG_DISABLE_WARNINGS()
+#include <entt/entt.hpp>
+ENG_ENABLE_WARNINGS()
+
+namespace engine
+{
+    class TransformSystem;
+
+    namespace sg
+    {
+        class Hierarchy
+        {
+        public:
+            Hierarchy();
+            ~Hierarchy();
+            Hierarchy(const Hierarchy &) = default;
+
+            entt::entity GetParent() const { return m_Parent; }
+            const std::vector<entt::entity> &GetChildren() const { return m_Children; }
+
+        private:
+            friend class engine::TransformSystem;
+
+            entt::entity m_Parent{entt::null};
+            std::vector<entt::entity> m_Children;
+        };
+    }
+}
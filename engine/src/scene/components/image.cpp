@@ -3,14 +3,10 @@
 #include "platform/filesystem.h"
 #include "scene/components/image/ktx.h"
 #include "scene/components/image/stb.h"
+#include "scene/mipmap_generator.h"
 #include "vulkan_api/core/image.h"
 #include "vulkan_api/core/image_view.h"
 
-ENG_DISABLE_WARNINGS()
-#define STB_IMAGE_RESIZE_IMPLEMENTATION
-#include <stb_image_resize.h>
-ENG_ENABLE_WARNINGS()
-
 namespace engine
 {
     namespace sg
@@ -47,6 +43,30 @@ namespace engine
                     format == VK_FORMAT_ASTC_12x12_SRGB_BLOCK);
         }
 
+        bool IsAstcSrgb(const VkFormat format)
+        {
+            switch (format)
+            {
+            case VK_FORMAT_ASTC_4x4_SRGB_BLOCK:
+            case VK_FORMAT_ASTC_5x4_SRGB_BLOCK:
+            case VK_FORMAT_ASTC_5x5_SRGB_BLOCK:
+            case VK_FORMAT_ASTC_6x5_SRGB_BLOCK:
+            case VK_FORMAT_ASTC_6x6_SRGB_BLOCK:
+            case VK_FORMAT_ASTC_8x5_SRGB_BLOCK:
+            case VK_FORMAT_ASTC_8x6_SRGB_BLOCK:
+            case VK_FORMAT_ASTC_8x8_SRGB_BLOCK:
+            case VK_FORMAT_ASTC_10x5_SRGB_BLOCK:
+            case VK_FORMAT_ASTC_10x6_SRGB_BLOCK:
+            case VK_FORMAT_ASTC_10x8_SRGB_BLOCK:
+            case VK_FORMAT_ASTC_10x10_SRGB_BLOCK:
+            case VK_FORMAT_ASTC_12x10_SRGB_BLOCK:
+            case VK_FORMAT_ASTC_12x12_SRGB_BLOCK:
+                return true;
+            default:
+                return false;
+            }
+        }
+
         Image::Image(const std::string &name, std::vector<uint8_t> &&data, std::vector<Mipmap> &&mipmaps)
             : m_Name{name},
               m_Data{std::move(data)},
@@ -59,7 +79,7 @@ namespace engine
         {
         }
 
-        std::unique_ptr<Image> Image::Load(const std::string &name, const std::filesystem::path path)
+        std::unique_ptr<Image> Image::Load(const std::string &name, const std::filesystem::path path, const std::vector<VkFormat> &transcode_formats)
         {
             std::unique_ptr<Image> image{};
 
@@ -76,55 +96,52 @@ namespace engine
             }
             else if (extension == ".ktx2")
             {
-                image = std::make_unique<Ktx>(name, data);
+                image = std::make_unique<Ktx>(name, data, transcode_formats);
             }
 
             return image;
         }
 
-        void Image::GenerateMipmaps()
+        void Image::GenerateMipmaps(bool srgb)
         {
             ENG_ASSERT(m_Mipmaps.size() == 1, "Mipmaps already present");
 
             if (m_Mipmaps.size() > 1)
                 return;
 
-            auto extent = GetExtent();
-            auto next_width = std::max<uint32_t>(1u, extent.width / 2);
-            auto next_height = std::max<uint32_t>(1u, extent.height / 2);
+            std::vector<uint8_t> data(LayoutMipmaps());
+            WriteMipmaps(data.data(), srgb);
+            m_Data = std::move(data);
+        }
+
+        size_t Image::LayoutMipmaps()
+        {
+            ENG_ASSERT(m_Mipmaps.size() == 1, "Mipmaps already present");
+
             auto channels = 4;
-            auto next_size = next_width * next_height * channels;
+            auto extent = GetExtent();
+            size_t size = extent.width * extent.height * channels;
 
-            while (true)
+            while (extent.width > 1 || extent.height > 1)
             {
-                auto old_size = ToUint32_t(m_Data.size());
-                m_Data.resize(old_size + next_size);
-                auto &previous_mipmap = m_Mipmaps.back();
+                extent.width = std::max<uint32_t>(1u, extent.width / 2);
+                extent.height = std::max<uint32_t>(1u, extent.height / 2);
 
                 Mipmap next_mipmap{};
-                next_mipmap.level = previous_mipmap.level + 1;
-                next_mipmap.offset = old_size;
-                next_mipmap.extent = {next_width, next_height, 1u};
-
-                stbir_resize_uint8(m_Data.data() + previous_mipmap.offset,
-                                   previous_mipmap.extent.width,
-                                   previous_mipmap.extent.height, 0,
+                next_mipmap.level = m_Mipmaps.back().level + 1;
+                next_mipmap.offset = ToUint32_t(size);
+                next_mipmap.extent = {extent.width, extent.height, 1u};
 
-                                   m_Data.data() + next_mipmap.offset,
-                                   next_mipmap.extent.width,
-                                   next_mipmap.extent.height, 0, channels);
-
-                m_Mipmaps.emplace_back(std::move(next_mipmap));
+                m_Mipmaps.push_back(next_mipmap);
+                size += extent.width * extent.height * channels;
+            }
 
-                next_width = std::max<uint32_t>(1u, next_width / 2);
-                next_height = std::max<uint32_t>(1u, next_height / 2);
-                next_size = next_width * next_height * channels;
+            return size;
+        }
 
-                if (next_width == 1 && next_height == 1)
-                {
-                    break;
-                }
-            }
+        void Image::WriteMipmaps(uint8_t *data, bool srgb) const
+        {
+            WriteMipmapChain(m_Data.data(), m_Mipmaps, srgb, data);
         }
 
         void Image::CreateVkImage(Device &device, VkImageViewType image_view_type, VkImageCreateFlags flags)
@@ -132,12 +149,12 @@ namespace engine
             ENG_ASSERT(!m_VkImage && !m_VkImageView, "Vulkan image already constructed");
 
             m_VkImage = std::make_unique<core::Image>(device,
-                                                      GetExtent(),
+                                                      m_Mipmaps.at(m_BaseLevel).extent,
                                                       m_Format,
                                                       VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT,
                                                       VMA_MEMORY_USAGE_GPU_ONLY,
                                                       VK_SAMPLE_COUNT_1_BIT,
-                                                      ToUint32_t(m_Mipmaps.size()),
+                                                      ToUint32_t(m_Mipmaps.size()) - m_BaseLevel,
                                                       m_Layers,
                                                       VK_IMAGE_TILING_OPTIMAL,
                                                       flags);
@@ -145,6 +162,39 @@ namespace engine
             m_VkImageView = std::make_unique<core::ImageView>(*m_VkImage, image_view_type);
         }
 
+        void Image::SetBaseLevel(uint32_t level)
+        {
+            ENG_ASSERT(!m_VkImage, "Vulkan image already constructed");
+            ENG_ASSERT(level < m_Mipmaps.size(), "Base level out of range");
+
+            m_BaseLevel = level;
+        }
+
+        std::pair<size_t, size_t> Image::GetLevelRange(uint32_t first_level) const
+        {
+            size_t begin = m_Data.size();
+            size_t end = 0;
+
+            for (auto &mipmap : m_Mipmaps)
+            {
+                if (mipmap.level < first_level)
+                    continue;
+
+                // A level ends where the next stored one starts
+                size_t mipmap_end = m_Data.size();
+                for (auto &other : m_Mipmaps)
+                {
+                    if (other.offset > mipmap.offset)
+                        mipmap_end = std::min<size_t>(mipmap_end, other.offset);
+                }
+
+                begin = std::min<size_t>(begin, mipmap.offset);
+                end = std::max(end, mipmap_end);
+            }
+
+            return {begin, end - begin};
+        }
+
         void Image::SetData(const uint8_t *raw_data, size_t size)
         {
             ENG_ASSERT(m_Data.empty() && "Image data already set");
@@ -13,6 +13,7 @@ namespace engine
     namespace sg
     {
         bool IsAstc(const VkFormat format);
+        bool IsAstcSrgb(const VkFormat format);
 
         struct Mipmap
         {
@@ -27,8 +28,15 @@ namespace engine
             Image(const std::string &name, std::vector<uint8_t> &&data = {}, std::vector<Mipmap> &&mipmaps = {{}});
             virtual ~Image();
 
-            static std::unique_ptr<Image> Load(const std::string &name, const std::filesystem::path path);
-            void GenerateMipmaps();
+            // transcode_formats are the formats Basis Universal KTX2 images may be transcoded to, see Ktx::get_transcode_formats
+            static std::unique_ptr<Image> Load(const std::string &name, const std::filesystem::path path, const std::vector<VkFormat> &transcode_formats = {});
+            // srgb averages the colors in linear space, the caller knows whether the image holds colors or data
+            void GenerateMipmaps(bool srgb);
+            // Adds the levels down to 1x1 after the decoded RGBA8 level 0, returns the size of the whole chain
+            size_t LayoutMipmaps();
+            // Writes the whole laid out chain to data, which can be mapped staging memory as it is only written to
+            void WriteMipmaps(uint8_t *data, bool srgb) const;
+            // The Vulkan image holds the levels from the base level on
             void CreateVkImage(Device &device, VkImageViewType image_view_type = VK_IMAGE_VIEW_TYPE_2D, VkImageCreateFlags flags = 0);
 
             void ClearData();
@@ -39,6 +47,14 @@ namespace engine
             const core::Image &GetVkImage() const;
             const core::ImageView &GetVkImageView() const;
             const std::vector<Mipmap> &GetMipmaps() const { return m_Mipmaps; }
+            uint32_t GetLayers() const { return m_Layers; }
+
+            // Streamed images only create their smallest levels at first, set before the Vulkan image is created
+            void SetBaseLevel(uint32_t level);
+            uint32_t GetBaseLevel() const { return m_BaseLevel; }
+            // Offset and size in data of the levels from first_level on, which are contiguous whether they are stored
+            // largest or smallest first. Only covers the first layer
+            std::pair<size_t, size_t> GetLevelRange(uint32_t first_level) const;
 
         protected:
             std::vector<uint8_t> &GetMutData() { return m_Data; }
@@ -57,6 +73,7 @@ namespace engine
             std::vector<uint8_t> m_Data;
             VkFormat m_Format{VK_FORMAT_UNDEFINED};
             uint32_t m_Layers{1};
+            uint32_t m_BaseLevel{0};
             std::vector<Mipmap> m_Mipmaps{{}};
             std::vector<std::vector<VkDeviceSize>> m_Offsets;
             std::unique_ptr<core::Image> m_VkImage;
@@ -18,6 +18,8 @@
 #include "scene/components/image/astc.h"
 
 #include "common/glm.h"
+#include "common/simd.h"
+#include "core/job_system.h"
 ENG_DISABLE_WARNINGS()
 #if defined(_WIN32) || defined(_WIN64)
 // Windows.h defines IGNORE, so we must #undef it to avoid clashes with astc header
@@ -94,6 +96,51 @@ namespace engine
 			uint8_t zsize[3]; // block count is inferred
 		};
 
+		namespace
+		{
+			// Block rows a job decodes at least
+			constexpr size_t MIN_BLOCK_ROWS_PER_RANGE = 4;
+
+			// Writes one row of decoded texels as RGBA8, texel values are in [0, 1]
+			void write_texel_row(const float *texels, int count, uint8_t *destination)
+			{
+				int i = 0;
+
+#if defined(ENG_SIMD_SSE) || defined(ENG_SIMD_AVX2)
+				const __m128 scale = _mm_set1_ps(255.0f);
+				const __m128 half  = _mm_set1_ps(0.5f);
+				const __m128 zero  = _mm_setzero_ps();
+				const __m128 one   = _mm_set1_ps(1.0f);
+
+				auto convert = [&](const float *texel) {
+					__m128 value = _mm_min_ps(_mm_max_ps(_mm_loadu_ps(texel), zero), one);
+					return _mm_cvttps_epi32(_mm_add_ps(_mm_mul_ps(value, scale), half));
+				};
+
+				// 4 texels per iteration covers the 4, 6 and 8 wide blocks in one or two steps
+				for (; i + 4 <= count; i += 4)
+				{
+					__m128i low  = _mm_packs_epi32(convert(texels + i * 4), convert(texels + i * 4 + 4));
+					__m128i high = _mm_packs_epi32(convert(texels + i * 4 + 8), convert(texels + i * 4 + 12));
+					_mm_storeu_si128(reinterpret_cast<__m128i *>(destination + i * 4), _mm_packus_epi16(low, high));
+				}
+
+				for (; i < count; i++)
+				{
+					__m128i packed = _mm_packs_epi32(convert(texels + i * 4), _mm_setzero_si128());
+					int32_t texel  = _mm_cvtsi128_si32(_mm_packus_epi16(packed, packed));
+					std::memcpy(destination + i * 4, &texel, sizeof(texel));
+				}
+#else
+				for (; i < count * 4; i++)
+				{
+					auto value     = std::min(std::max(texels[i], 0.0f), 1.0f);
+					destination[i] = static_cast<uint8_t>(value * 255.0f + 0.5f);
+				}
+#endif
+			}
+		}
+
 		void Astc::init()
 		{
 			// Initializes ASTC library
@@ -109,20 +156,32 @@ namespace engine
 			}
 		}
 
-		void Astc::decode(BlockDim blockdim, VkExtent3D extent, const uint8_t *data_)
+		void Astc::prepare_block_tables(BlockDim blockdim)
+		{
+			// The library builds the tables of a block size lazily, which is not thread safe
+			static std::mutex preparation;
+			std::unique_lock<std::mutex> lock{preparation};
+
+			get_block_size_descriptor(blockdim.x, blockdim.y, blockdim.z);
+
+			for (int partition_count = 1; partition_count <= 4; partition_count++)
+			{
+				get_partition_table(blockdim.x, blockdim.y, blockdim.z, partition_count);
+			}
+		}
+
+		void Astc::decode(BlockDim blockdim, VkExtent3D extent, const uint8_t *data_, bool srgb)
 		{
 			// Actual decoding
-			astc_decode_mode decode_mode = DECODE_LDR_SRGB;
-			uint32_t bitness = 8;
-			swizzlepattern swz_decode = {0, 1, 2, 3};
+			astc_decode_mode decode_mode = srgb ? DECODE_LDR_SRGB : DECODE_LDR;
 
 			int xdim = blockdim.x;
 			int ydim = blockdim.y;
 			int zdim = blockdim.z;
 
 			if ((xdim < 3 || xdim > 6 || ydim < 3 || ydim > 6 || zdim < 3 || zdim > 6) &&
-				(xdim < 4 || xdim == 7 || xdim == 9 || xdim == 11 || xdim > 12 ||
-				 ydim < 4 || ydim == 7 || ydim == 9 || ydim == 11 || ydim > 12 || zdim != 1))
+			    (xdim < 4 || xdim == 7 || xdim == 9 || xdim == 11 || xdim > 12 ||
+			     ydim < 4 || ydim == 7 || ydim == 9 || ydim == 11 || ydim > 12 || zdim != 1))
 			{
 				throw std::runtime_error{"Error reading astc: invalid block"};
 			}
@@ -140,43 +199,62 @@ namespace engine
 			int yblocks = (ysize + ydim - 1) / ydim;
 			int zblocks = (zsize + zdim - 1) / zdim;
 
-			auto astc_image = allocate_image(bitness, xsize, ysize, zsize, 0);
-			initialize_image(astc_image);
+			prepare_block_tables(blockdim);
 
-			imageblock pb;
-			for (int z = 0; z < zblocks; z++)
-			{
-				for (int y = 0; y < yblocks; y++)
+			// Blocks are decoded straight into the image data, cropped at the image edges
+			auto &image_data = GetMutData();
+			image_data.resize(static_cast<size_t>(xsize) * ysize * zsize * 4);
+
+			auto *destination = image_data.data();
+
+			JobSystem::Get().ParallelFor(static_cast<size_t>(zblocks) * yblocks, MIN_BLOCK_ROWS_PER_RANGE, [&](size_t begin, size_t end) {
+				imageblock pb;
+
+				for (auto row = begin; row < end; row++)
 				{
+					int z = static_cast<int>(row / yblocks);
+					int y = static_cast<int>(row % yblocks);
+
 					for (int x = 0; x < xblocks; x++)
 					{
-						int offset = (((z * yblocks + y) * xblocks) + x) * 16;
-						const uint8_t *bp = data_ + offset;
+						size_t offset = ((row * xblocks) + x) * 16;
 
-						physical_compressed_block pcb = *reinterpret_cast<const physical_compressed_block *>(bp);
+						physical_compressed_block pcb;
+						std::memcpy(&pcb, data_ + offset, sizeof(pcb));
 						symbolic_compressed_block scb;
 
 						physical_to_symbolic(xdim, ydim, zdim, pcb, &scb);
 						decompress_symbolic_block(decode_mode, xdim, ydim, zdim, x * xdim, y * ydim, z * zdim, &scb, &pb);
-						write_imageblock(astc_image, &pb, xdim, ydim, zdim, x * xdim, y * ydim, z * zdim, swz_decode);
+
+						int width = std::min(xdim, xsize - x * xdim);
+
+						for (int texel_z = 0; texel_z < zdim && z * zdim + texel_z < zsize; texel_z++)
+						{
+							for (int texel_y = 0; texel_y < ydim && y * ydim + texel_y < ysize; texel_y++)
+							{
+								size_t image_x = x * xdim;
+								size_t image_y = y * ydim + texel_y;
+								size_t image_z = z * zdim + texel_z;
+
+								write_texel_row(pb.orig_data + (texel_z * ydim + texel_y) * xdim * 4, width,
+								                destination + ((image_z * ysize + image_y) * xsize + image_x) * 4);
+							}
+						}
 					}
 				}
-			}
-
-			SetData(astc_image->imagedata8[0][0], astc_image->xsize * astc_image->ysize * astc_image->zsize * 4);
-			SetFormat(VK_FORMAT_R8G8B8A8_SRGB);
-			SetWidth(static_cast<uint32_t>(astc_image->xsize));
-			SetHeight(static_cast<uint32_t>(astc_image->ysize));
-			SetDepth(static_cast<uint32_t>(astc_image->zsize));
+			});
 
-			destroy_image(astc_image);
+			SetFormat(srgb ? VK_FORMAT_R8G8B8A8_SRGB : VK_FORMAT_R8G8B8A8_UNORM);
+			SetWidth(static_cast<uint32_t>(xsize));
+			SetHeight(static_cast<uint32_t>(ysize));
+			SetDepth(static_cast<uint32_t>(zsize));
 		}
 
 		Astc::Astc(const Image &image)
 			: Image{image.GetName()}
 		{
 			init();
-			decode(to_blockdim(image.GetFormat()), image.GetExtent(), image.GetData().data());
+			decode(to_blockdim(image.GetFormat()), image.GetExtent(), image.GetData().data(), IsAstcSrgb(image.GetFormat()));
 		}
 
 		Astc::Astc(const std::string &name, const std::vector<uint8_t> &data)
@@ -207,7 +285,8 @@ namespace engine
 				/* height = */ static_cast<uint32_t>(header.ysize[0] + 256 * header.ysize[1] + 65536 * header.ysize[2]),
 				/* depth  = */ static_cast<uint32_t>(header.zsize[0] + 256 * header.zsize[1] + 65536 * header.zsize[2])};
 
-			decode(blockdim, extent, data.data() + sizeof(AstcHeader));
+			// The file header has no color space, its colors are taken as sRGB
+			decode(blockdim, extent, data.data() + sizeof(AstcHeader), true);
 		}
 
 	}
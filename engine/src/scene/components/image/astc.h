@@ -34,7 +34,7 @@ namespace engine
 		{
 		public:
 			/**
-	 * @brief Decodes an ASTC image
+	 * @brief Decodes an ASTC image to RGBA8 in the color space of its format
 	 * @param image Image to decode
 	 */
 			Astc(const Image &image);
@@ -50,17 +50,24 @@ namespace engine
 
 		private:
 			/**
-	 * @brief Decodes ASTC data
+	 * @brief Decodes ASTC data, block rows are split across the job system's workers
 	 * @param blockdim Dimensions of the block
 	 * @param extent Extent of the image
 	 * @param data Pointer to ASTC image data
+	 * @param srgb Whether the colors are sRGB encoded, the decoded image is UNORM otherwise
 	 */
-			void decode(BlockDim blockdim, VkExtent3D extent, const uint8_t *data);
+			void decode(BlockDim blockdim, VkExtent3D extent, const uint8_t *data, bool srgb);
 
 			/**
 	 * @brief Initializes ASTC library
 	 */
 			void init();
+
+			/**
+	 * @brief Builds the library tables of a block size before blocks are decoded concurrently
+	 * @param blockdim Dimensions of the block
+	 */
+			void prepare_block_tables(BlockDim blockdim);
 		};
 	}
 }
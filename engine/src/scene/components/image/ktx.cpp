@@ -18,6 +18,8 @@
 
 #include "scene/components/image/ktx.h"
 
+#include "vulkan_api/device.h"
+
 ENG_DISABLE_WARNINGS()
 #include <ktx.h>
 #include <ktxvulkan.h>
@@ -59,7 +61,53 @@ namespace engine
 			return KTX_SUCCESS;
 		}
 
-		Ktx::Ktx(const std::string &name, const std::vector<uint8_t> &data) : Image{name}
+		/// Formats Basis Universal images transcode to, the UNORM variant stands for both as libktx picks the sRGB one
+		/// from the transfer function of the image
+		static const std::pair<ktx_transcode_fmt_e, VkFormat> ASTC_TARGET{KTX_TTF_ASTC_4x4_RGBA, VK_FORMAT_ASTC_4x4_UNORM_BLOCK};
+		static const std::pair<ktx_transcode_fmt_e, VkFormat> BC7_TARGET{KTX_TTF_BC7_RGBA, VK_FORMAT_BC7_UNORM_BLOCK};
+		static const std::pair<ktx_transcode_fmt_e, VkFormat> BC3_TARGET{KTX_TTF_BC3_RGBA, VK_FORMAT_BC3_UNORM_BLOCK};
+		static const std::pair<ktx_transcode_fmt_e, VkFormat> BC1_TARGET{KTX_TTF_BC1_RGB, VK_FORMAT_BC1_RGB_UNORM_BLOCK};
+		static const std::pair<ktx_transcode_fmt_e, VkFormat> ETC2_RGBA_TARGET{KTX_TTF_ETC2_RGBA, VK_FORMAT_ETC2_R8G8B8A8_UNORM_BLOCK};
+		static const std::pair<ktx_transcode_fmt_e, VkFormat> ETC2_RGB_TARGET{KTX_TTF_ETC1_RGB, VK_FORMAT_ETC2_R8G8B8_UNORM_BLOCK};
+
+		static ktx_transcode_fmt_e choose_transcode_format(ktxTexture2 *texture, const std::vector<VkFormat> &formats)
+		{
+			auto components = ktxTexture2_GetNumComponents(texture);
+			bool alpha = components == 2 || components == 4;
+
+			auto &etc = alpha ? ETC2_RGBA_TARGET : ETC2_RGB_TARGET;
+			auto &bc = alpha ? BC3_TARGET : BC1_TARGET;
+
+			// UASTC is transcoded to ASTC without loss and to BC7 with little, ETC1S is ETC1 with a shared codebook
+			std::vector<std::pair<ktx_transcode_fmt_e, VkFormat>> candidates;
+			if (ktxTexture2_GetColorModel_e(texture) == KHR_DF_MODEL_UASTC)
+				candidates = {ASTC_TARGET, BC7_TARGET, etc, bc};
+			else
+				candidates = {etc, BC7_TARGET, bc, ASTC_TARGET};
+
+			for (auto &candidate : candidates)
+			{
+				if (std::find(formats.begin(), formats.end(), candidate.second) != formats.end())
+					return candidate.first;
+			}
+
+			return KTX_TTF_RGBA32;
+		}
+
+		std::vector<VkFormat> Ktx::get_transcode_formats(const Device &device)
+		{
+			std::vector<VkFormat> formats;
+
+			for (auto &target : {ASTC_TARGET, BC7_TARGET, BC3_TARGET, BC1_TARGET, ETC2_RGBA_TARGET, ETC2_RGB_TARGET})
+			{
+				if (device.IsImageFormatSupported(target.second))
+					formats.push_back(target.second);
+			}
+
+			return formats;
+		}
+
+		Ktx::Ktx(const std::string &name, const std::vector<uint8_t> &data, const std::vector<VkFormat> &transcode_formats) : Image{name}
 		{
 			auto data_buffer = reinterpret_cast<const ktx_uint8_t *>(data.data());
 			auto data_size = static_cast<ktx_size_t>(data.size());
@@ -74,6 +122,38 @@ namespace engine
 				throw std::runtime_error{"Error loading KTX texture: " + name};
 			}
 
+			if (texture->classId == ktxTexture2_c)
+			{
+				auto texture2 = reinterpret_cast<ktxTexture2 *>(texture);
+				bool transcode = ktxTexture2_NeedsTranscoding(texture2);
+
+				// Supercompressed levels are inflated by libktx into its own copy of the data
+				if (transcode || texture2->supercompressionScheme != KTX_SS_NONE)
+				{
+					if (ktxTexture_LoadImageData(texture, nullptr, 0) != KTX_SUCCESS)
+					{
+						ktxTexture_Destroy(texture);
+						throw std::runtime_error{"Error loading KTX image data: " + name};
+					}
+				}
+
+				if (transcode)
+				{
+					auto target = choose_transcode_format(texture2, transcode_formats);
+
+					if (target == KTX_TTF_RGBA32)
+					{
+						ENG_CORE_WARN("No block compressed format to transcode {} to, falling back to RGBA8", name);
+					}
+
+					if (ktxTexture2_TranscodeBasis(texture2, target, 0) != KTX_SUCCESS)
+					{
+						ktxTexture_Destroy(texture);
+						throw std::runtime_error{"Error transcoding KTX texture: " + name};
+					}
+				}
+			}
+
 			if (texture->pData)
 			{
 				// Already loaded
@@ -120,6 +200,14 @@ namespace engine
 				throw std::runtime_error("Error loading KTX texture");
 			}
 
+			// KTX2 stores the smallest level first, so the offsets can't be summed up from the level sizes
+			for (uint32_t level = 0; level < texture->numLevels; level++)
+			{
+				ktx_size_t offset;
+				ktxTexture_GetImageOffset(texture, level, 0, 0, &offset);
+				mipmap_levels[level].offset = static_cast<uint32_t>(offset);
+			}
+
 			// If the texture contains more than one layer, then populate the offsets otherwise take the mipmap level offsets
 			if (texture->numLayers > 1 || cubemap)
 			{
@@ -26,9 +26,22 @@ namespace engine
 		class Ktx : public Image
 		{
 		public:
-			Ktx(const std::string &name, const std::vector<uint8_t> &data);
+			/**
+			 * @brief Loads a KTX or KTX2 image, Zstd supercompressed levels are inflated
+			 * @param name Name of the component
+			 * @param data KTX data with header
+			 * @param transcode_formats Formats Basis Universal images may be transcoded to, as returned by get_transcode_formats.
+			 *                          Without any of them they are transcoded to RGBA8
+			 */
+			Ktx(const std::string &name, const std::vector<uint8_t> &data, const std::vector<VkFormat> &transcode_formats = {});
 
 			virtual ~Ktx() = default;
+
+			/**
+			 * @brief Block compressed formats the device can sample that Basis Universal images transcode to
+			 * @param device Device the images are created on
+			 */
+			static std::vector<VkFormat> get_transcode_formats(const Device &device);
 		};
 
 	}
@@ -0,0 +1,263 @@
+#include "scene/components/image/transcoded.h"
+
+#include "scene/block_encoder.h"
+#include "scene/components/image/astc.h"
+#include "vulkan_api/device.h"
+
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+
+namespace engine
+{
+	namespace sg
+	{
+		namespace
+		{
+			constexpr uint32_t CACHE_MAGIC = 0x45434E54;
+
+			// Bumped whenever the encoders or the file layout change, older cache files are encoded again
+			constexpr uint32_t CACHE_VERSION = 2;
+
+			struct CacheHeader
+			{
+				uint32_t magic;
+				uint32_t version;
+				uint64_t key;
+				uint32_t format;
+				uint32_t mipmap_count;
+				uint64_t data_size;
+			};
+
+			// Formats in order of preference, sRGB variants after the UNORM ones
+			constexpr VkFormat ENCODABLE_FORMATS[] = {
+			    VK_FORMAT_BC7_UNORM_BLOCK,
+			    VK_FORMAT_BC3_UNORM_BLOCK,
+			    VK_FORMAT_BC1_RGB_UNORM_BLOCK,
+			    VK_FORMAT_ETC2_R8G8B8A8_UNORM_BLOCK,
+			    VK_FORMAT_ETC2_R8G8B8_UNORM_BLOCK,
+			    VK_FORMAT_BC7_SRGB_BLOCK,
+			    VK_FORMAT_BC3_SRGB_BLOCK,
+			    VK_FORMAT_BC1_RGB_SRGB_BLOCK,
+			    VK_FORMAT_ETC2_R8G8B8A8_SRGB_BLOCK,
+			    VK_FORMAT_ETC2_R8G8B8_SRGB_BLOCK};
+
+			bool is_srgb_encodable(VkFormat format)
+			{
+				return format == VK_FORMAT_BC7_SRGB_BLOCK || format == VK_FORMAT_BC3_SRGB_BLOCK || format == VK_FORMAT_BC1_RGB_SRGB_BLOCK ||
+				       format == VK_FORMAT_ETC2_R8G8B8A8_SRGB_BLOCK || format == VK_FORMAT_ETC2_R8G8B8_SRGB_BLOCK;
+			}
+
+			bool has_alpha(VkFormat format)
+			{
+				return format != VK_FORMAT_BC1_RGB_UNORM_BLOCK && format != VK_FORMAT_BC1_RGB_SRGB_BLOCK &&
+				       format != VK_FORMAT_ETC2_R8G8B8_UNORM_BLOCK && format != VK_FORMAT_ETC2_R8G8B8_SRGB_BLOCK;
+			}
+
+			// 64 bit FNV-1a
+			uint64_t hash(uint64_t hash, const void *data, size_t size)
+			{
+				auto bytes = static_cast<const uint8_t *>(data);
+
+				for (size_t i = 0; i < size; i++)
+				{
+					hash ^= bytes[i];
+					hash *= 0x100000001B3ull;
+				}
+
+				return hash;
+			}
+		}
+
+		Transcoded::Transcoded(const Image &image, const std::vector<VkFormat> &formats, const std::filesystem::path &cache_directory)
+			: Image{image.GetName()}
+		{
+			ENG_ASSERT(IsAstc(image.GetFormat()), "Only ASTC images are transcoded");
+
+			// The encoded image depends on the source and on the formats it could be encoded to
+			auto source_format = image.GetFormat();
+			auto &source_extent = image.GetExtent();
+
+			uint64_t key = 0xCBF29CE484222325ull;
+			key = hash(key, &CACHE_VERSION, sizeof(CACHE_VERSION));
+			key = hash(key, &source_format, sizeof(source_format));
+			key = hash(key, &source_extent, sizeof(source_extent));
+			key = hash(key, formats.data(), formats.size() * sizeof(VkFormat));
+			key = hash(key, image.GetData().data(), image.GetData().size());
+
+			std::filesystem::path cache_path;
+
+			if (!cache_directory.empty())
+			{
+				std::stringstream name;
+				name << std::hex << std::setw(16) << std::setfill('0') << key << ".transcoded";
+				cache_path = cache_directory / name.str();
+
+				if (load_cache(cache_path, key))
+					return;
+			}
+
+			Astc decoded{image};
+			decoded.GenerateMipmaps(IsAstcSrgb(source_format));
+
+			auto &decoded_data = decoded.GetData();
+			auto &decoded_mipmaps = decoded.GetMipmaps();
+
+			bool alpha = false;
+			auto &extent = decoded_mipmaps[0].extent;
+			for (size_t texel = 0; texel < static_cast<size_t>(extent.width) * extent.height && !alpha; texel++)
+				alpha = decoded_data[texel * 4 + 3] < 255;
+
+			auto format = choose_format(formats, IsAstcSrgb(source_format), alpha);
+
+			auto &mipmaps = GetMutMipmaps();
+			mipmaps = decoded_mipmaps;
+
+			size_t size = 0;
+			for (auto &mipmap : mipmaps)
+			{
+				mipmap.offset = ToUint32_t(size);
+				size += GetEncodedSize(format, mipmap.extent.width, mipmap.extent.height);
+			}
+
+			auto &data = GetMutData();
+			data.resize(size);
+
+			for (size_t level = 0; level < mipmaps.size(); level++)
+			{
+				auto &mipmap = mipmaps[level];
+				EncodeBlocks(decoded_data.data() + decoded_mipmaps[level].offset, mipmap.extent.width, mipmap.extent.height, format,
+				             data.data() + mipmap.offset);
+			}
+
+			SetFormat(format);
+
+			if (!cache_path.empty())
+				save_cache(cache_path, key);
+		}
+
+		std::vector<VkFormat> Transcoded::get_supported_formats(const Device &device)
+		{
+			std::vector<VkFormat> formats;
+
+			for (auto format : ENCODABLE_FORMATS)
+			{
+				if (device.IsImageFormatSupported(format))
+					formats.push_back(format);
+			}
+
+			return formats;
+		}
+
+		VkFormat Transcoded::choose_format(const std::vector<VkFormat> &formats, bool srgb, bool alpha)
+		{
+			VkFormat preferred[3];
+
+			if (srgb)
+			{
+				preferred[0] = VK_FORMAT_BC7_SRGB_BLOCK;
+				preferred[1] = alpha ? VK_FORMAT_BC3_SRGB_BLOCK : VK_FORMAT_BC1_RGB_SRGB_BLOCK;
+				preferred[2] = alpha ? VK_FORMAT_ETC2_R8G8B8A8_SRGB_BLOCK : VK_FORMAT_ETC2_R8G8B8_SRGB_BLOCK;
+			}
+			else
+			{
+				preferred[0] = VK_FORMAT_BC7_UNORM_BLOCK;
+				preferred[1] = alpha ? VK_FORMAT_BC3_UNORM_BLOCK : VK_FORMAT_BC1_RGB_UNORM_BLOCK;
+				preferred[2] = alpha ? VK_FORMAT_ETC2_R8G8B8A8_UNORM_BLOCK : VK_FORMAT_ETC2_R8G8B8_UNORM_BLOCK;
+			}
+
+			for (auto format : preferred)
+			{
+				if (std::find(formats.begin(), formats.end(), format) != formats.end())
+					return format;
+			}
+
+			// Any other supported format of the color space that holds the image, like BC3 for an opaque one
+			for (auto format : ENCODABLE_FORMATS)
+			{
+				if (is_srgb_encodable(format) == srgb && (!alpha || has_alpha(format)) &&
+				    std::find(formats.begin(), formats.end(), format) != formats.end())
+					return format;
+			}
+
+			throw std::runtime_error{"Error transcoding image: no supported format"};
+		}
+
+		bool Transcoded::load_cache(const std::filesystem::path &path, uint64_t key)
+		{
+			std::ifstream file{path, std::ios::in | std::ios::binary};
+			if (!file.is_open())
+				return false;
+
+			CacheHeader header{};
+			if (!file.read(reinterpret_cast<char *>(&header), sizeof(header)) ||
+			    header.magic != CACHE_MAGIC || header.version != CACHE_VERSION || header.key != key ||
+			    !IsBlockEncodable(static_cast<VkFormat>(header.format)) || header.mipmap_count == 0 ||
+			    header.data_size + header.mipmap_count * sizeof(Mipmap) + sizeof(header) != std::filesystem::file_size(path))
+			{
+				return false;
+			}
+
+			std::vector<Mipmap> mipmaps(header.mipmap_count);
+			std::vector<uint8_t> data(static_cast<size_t>(header.data_size));
+
+			if (!file.read(reinterpret_cast<char *>(mipmaps.data()), mipmaps.size() * sizeof(Mipmap)) ||
+			    !file.read(reinterpret_cast<char *>(data.data()), data.size()))
+			{
+				return false;
+			}
+
+			for (auto &mipmap : mipmaps)
+			{
+				auto format = static_cast<VkFormat>(header.format);
+				if (mipmap.offset + GetEncodedSize(format, mipmap.extent.width, mipmap.extent.height) > data.size())
+					return false;
+			}
+
+			GetMutMipmaps() = std::move(mipmaps);
+			GetMutData() = std::move(data);
+			SetFormat(static_cast<VkFormat>(header.format));
+
+			return true;
+		}
+
+		void Transcoded::save_cache(const std::filesystem::path &path, uint64_t key) const
+		{
+			CacheHeader header{};
+			header.magic = CACHE_MAGIC;
+			header.version = CACHE_VERSION;
+			header.key = key;
+			header.format = static_cast<uint32_t>(GetFormat());
+			header.mipmap_count = ToUint32_t(GetMipmaps().size());
+			header.data_size = GetData().size();
+
+			// Loaders on other threads may write the same image, each to its own temporary file
+			auto temporary_path = path;
+			temporary_path += "." + std::to_string(std::hash<std::thread::id>{}(std::this_thread::get_id())) + ".tmp";
+
+			bool written = false;
+
+			{
+				std::ofstream file{temporary_path, std::ios::out | std::ios::binary | std::ios::trunc};
+
+				file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+				file.write(reinterpret_cast<const char *>(GetMipmaps().data()), GetMipmaps().size() * sizeof(Mipmap));
+				file.write(reinterpret_cast<const char *>(GetData().data()), GetData().size());
+
+				written = static_cast<bool>(file);
+			}
+
+			// A missing cache file only costs encoding the image again
+			std::error_code error;
+
+			if (written)
+				std::filesystem::rename(temporary_path, path, error);
+
+			if (!written || error)
+			{
+				ENG_CORE_WARN("Failed to write transcoded image cache {}", path.generic_string());
+				std::filesystem::remove(temporary_path, error);
+			}
+		}
+	}
+}
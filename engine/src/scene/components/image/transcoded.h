@@ -0,0 +1,54 @@
+#pragma once
+
+#include "scene/components/image.h"
+
+namespace engine
+{
+	namespace sg
+	{
+		/**
+		 * @brief ASTC image encoded on the CPU to a block compressed format the GPU can sample,
+		 *        instead of being decompressed to RGBA8
+		 */
+		class Transcoded : public Image
+		{
+		public:
+			/**
+			 * @brief Decodes an ASTC image, generates its mipmaps and encodes every level
+			 * @param image ASTC image to transcode
+			 * @param formats Formats the device supports, as returned by get_supported_formats
+			 * @param cache_directory Directory encoded images are cached in, keyed by a hash of the source. Empty to always encode
+			 */
+			Transcoded(const Image &image, const std::vector<VkFormat> &formats, const std::filesystem::path &cache_directory = {});
+
+			virtual ~Transcoded() = default;
+
+			/**
+			 * @brief Formats the encoder can write that the device can sample
+			 * @param device Device the images are created on
+			 */
+			static std::vector<VkFormat> get_supported_formats(const Device &device);
+
+		private:
+			/**
+			 * @brief Picks the best supported format, BC7 first, then BC1 or BC3 and then ETC2. Falls back to any
+			 *        supported format of the color space that keeps the alpha channel
+			 * @param formats Supported formats
+			 * @param srgb Whether the colors are sRGB encoded
+			 * @param alpha Whether any texel is not opaque
+			 */
+			static VkFormat choose_format(const std::vector<VkFormat> &formats, bool srgb, bool alpha);
+
+			/**
+			 * @brief Reads the format, mipmaps and data of a previously encoded image
+			 * @return False when the file is missing or doesn't match the key
+			 */
+			bool load_cache(const std::filesystem::path &path, uint64_t key);
+
+			/**
+			 * @brief Writes the encoded image to a temporary file that is renamed once complete
+			 */
+			void save_cache(const std::filesystem::path &path, uint64_t key) const;
+		};
+	}
+}
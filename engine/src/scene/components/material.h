@@ -4,6 +4,11 @@
 
 namespace engine
 {
+    namespace core
+    {
+        class ImageView;
+    }
+
     namespace sg
     {
         class Texture;
@@ -22,6 +27,8 @@ namespace engine
             Material(Material &&other) = default;
 
             std::unordered_map<std::string, Texture *> m_Textures;
+            // Drawn instead of the view of the texture's image, swapped by the texture streamer between frames
+            std::unordered_map<std::string, const core::ImageView *> m_TextureViews;
             glm::vec3 m_Emissive{0.0f, 0.0f, 0.0f};
             bool m_DoubleSided{false};
             float m_AlphaCutoff{0.5f};
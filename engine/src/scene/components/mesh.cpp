@@ -20,6 +20,11 @@ namespace engine
             m_Bounds.Update(vertex_data, index_data);
         }
 
+        void Mesh::UpdateBounds(const AABB &bounds)
+        {
+            m_Bounds.Update(bounds);
+        }
+
         void Mesh::AddSubmesh(Submesh &submesh)
         {
             m_Submeshes.push_back(&submesh);
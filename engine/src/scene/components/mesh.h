@@ -17,6 +17,7 @@ namespace engine
             Mesh(const Mesh &) = default;
 
             void UpdateBounds(const std::vector<glm::vec3> &vertex_data, const std::vector<uint16_t> &index_data = {});
+            void UpdateBounds(const AABB &bounds);
             void AddSubmesh(Submesh &submesh);
 
             const std::vector<Submesh *> &GetSubmeshes() const { return m_Submeshes; }
@@ -0,0 +1,23 @@
+#include "scene/components/skin.h"
+
+namespace engine
+{
+    namespace sg
+    {
+        Skin::Skin(const std::string &name)
+            : m_Name(name)
+        {
+        }
+
+        Skin::~Skin()
+        {
+        }
+
+        void Skin::AddJoint(entt::entity joint, const glm::mat4 &inverse_bind_matrix)
+        {
+            m_Joints.push_back(joint);
+            m_InverseBindMatrices.push_back(inverse_bind_matrix);
+            m_JointMatrices.push_back(glm::mat4{1.0f});
+        }
+    }
+}
@@ -0,0 +1,40 @@
+#pragma once
+
+#include "common/glm.h"
+
+ENG_DISABLE_WARNINGS()
+#include <entt/entt.hpp>
+ENG_ENABLE_WARNINGS()
+
+namespace engine
+{
+    class SkinningSystem;
+
+    namespace sg
+    {
+        // Joints of a skinned mesh node and the matrix palette computed from them every frame
+        class Skin
+        {
+        public:
+            Skin(const std::string &name);
+            ~Skin();
+            Skin(const Skin &) = default;
+
+            void AddJoint(entt::entity joint, const glm::mat4 &inverse_bind_matrix);
+
+            const std::string &GetName() const { return m_Name; }
+            const std::vector<entt::entity> &GetJoints() const { return m_Joints; }
+            const std::vector<glm::mat4> &GetInverseBindMatrices() const { return m_InverseBindMatrices; }
+            // Joint space to mesh space, so the node's own world matrix is still applied when drawing
+            const std::vector<glm::mat4> &GetJointMatrices() const { return m_JointMatrices; }
+
+        private:
+            friend class engine::SkinningSystem;
+
+            std::string m_Name;
+            std::vector<entt::entity> m_Joints;
+            std::vector<glm::mat4> m_InverseBindMatrices;
+            std::vector<glm::mat4> m_JointMatrices;
+        };
+    }
+}
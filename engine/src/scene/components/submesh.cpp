@@ -6,6 +6,18 @@ namespace engine
 {
     namespace sg
     {
+        Submesh::~Submesh()
+        {
+            if (!m_GeometryArena)
+                return;
+
+            for (auto handle : {m_VertexRange, m_PositionRange, m_IndexRange})
+            {
+                if (handle != GeometryArena::NULL_HANDLE)
+                    m_GeometryArena->Free(handle);
+            }
+        }
+
         void Submesh::SetAttribute(const std::string &attribute_name, const VertexAttribute &attribute)
         {
             m_VertexAttributes[attribute_name] = attribute;
@@ -52,6 +64,15 @@ namespace engine
                 m_ShaderVariant.AddDefine("HAS_" + attrib_name);
             }
 
+            // Quantized attributes are told apart by their format, half float texture coordinates need no decoding
+            VertexAttribute attribute;
+
+            if (GetAttribute("position", attribute) && attribute.format == VK_FORMAT_R16G16B16A16_UNORM)
+                m_ShaderVariant.AddDefine("QUANTIZED_POSITION");
+
+            if (GetAttribute("normal", attribute) && attribute.format == VK_FORMAT_R16G16_SNORM)
+                m_ShaderVariant.AddDefine("OCTAHEDRAL_NORMAL");
+
             // ENG_CORE_TRACE("{}", m_ShaderVariant.GetPreamble());
         }
     }
@@ -1,7 +1,9 @@
 #pragma once
 
 #include "vulkan_api/core/buffer.h"
+#include "vulkan_api/core/geometry_arena.h"
 #include "renderer/shader.h"
+#include "common/glm.h"
 
 namespace engine
 {
@@ -16,9 +18,25 @@ namespace engine
             std::uint32_t offset = 0;
         };
 
+        // Bind pose vertex of a skinned submesh, laid out for the skinning compute shader
+        struct SkinVertex
+        {
+            glm::vec4 position;
+            glm::vec4 normal;
+            glm::uvec4 joints;
+            glm::vec4 weights;
+        };
+
         class Submesh
         {
         public:
+            Submesh() = default;
+            // Returns the arena ranges, the scene declares its arena before its submeshes so it outlives them
+            ~Submesh();
+
+            Submesh(const Submesh &) = delete;
+            Submesh &operator=(const Submesh &) = delete;
+
             void SetAttribute(const std::string &attribute_name, const VertexAttribute &attribute);
             bool GetAttribute(const std::string &attribute_name, VertexAttribute &attribute) const;
 
@@ -29,6 +47,8 @@ namespace engine
             ShaderVariant &GetMutShaderVariant() { return m_ShaderVariant; }
             void ComputeShaderVariant();
 
+            bool IsSkinned() const { return !m_SkinVertices.empty(); }
+
             VkIndexType m_IndexType{};
             std::uint32_t m_IndexOffset = 0;
             std::uint32_t m_VerticesCount = 0;
@@ -36,6 +56,27 @@ namespace engine
             std::unordered_map<std::string, core::Buffer> m_VertexBuffers;
             std::unique_ptr<core::Buffer> m_IndexBuffer;
 
+            // Interleaved layout, every attribute at its offset in one buffer instead of m_VertexBuffers
+            std::unique_ptr<core::Buffer> m_InterleavedBuffer;
+            // Positions split out of the interleaved buffer, for passes that read nothing else
+            std::unique_ptr<core::Buffer> m_PositionBuffer;
+            std::uint32_t m_PositionStride = 0;
+
+            // Set when the interleaved vertices, positions and indices are ranges of the scene's arena instead
+            GeometryArena *m_GeometryArena{nullptr};
+            GeometryArena::Handle m_VertexRange{GeometryArena::NULL_HANDLE};
+            GeometryArena::Handle m_PositionRange{GeometryArena::NULL_HANDLE};
+            GeometryArena::Handle m_IndexRange{GeometryArena::NULL_HANDLE};
+            std::uint32_t m_VertexStride = 0;
+
+            // Decodes R16G16B16A16_UNORM positions to m_PositionOffset + position * m_PositionScale
+            glm::vec3 m_PositionOffset{0.0f};
+            glm::vec3 m_PositionScale{1.0f};
+
+            // Kept on the CPU for the reference skinning path, the buffer feeds the compute path
+            std::vector<SkinVertex> m_SkinVertices;
+            std::unique_ptr<core::Buffer> m_SkinVertexBuffer;
+
         private:
             std::unordered_map<std::string, VertexAttribute> m_VertexAttributes;
             const Material *m_Material{nullptr};
@@ -1,9 +1,7 @@
 #include "scene/components/transform.h"
 
-ENG_DISABLE_WARNINGS()
-#include <glm/gtx/matrix_decompose.hpp>
-#include <glm/gtx/string_cast.hpp>
-ENG_ENABLE_WARNINGS()
+#include "scene/systems/transform_batch.h"
+#include "scene/systems/transform_system.h"
 
 namespace engine
 {
@@ -20,47 +18,35 @@ namespace engine
 
         void Transform::SetMatrix(const glm::mat4 &matrix)
         {
-            glm::vec3 skew;
-            glm::vec4 perspective;
-            glm::decompose(matrix, m_Scale, m_Rotation, m_Translation, skew, perspective);
-            m_Rotation = glm::conjugate(m_Rotation);
-            InvalidateWorldMatrix();
-        }
+            // Affine decomposition, glTF node matrices have no shear or projection
+            glm::vec3 x_axis(matrix[0]);
+            glm::vec3 y_axis(matrix[1]);
+            glm::vec3 z_axis(matrix[2]);
 
-        glm::mat4 Transform::GetMatrix() const
-        {
-            auto test = glm::translate(glm::mat4(1.0), m_Translation) *
-                        glm::mat4_cast(m_Rotation) *
-                        glm::scale(glm::mat4(1.0), m_Scale);
+            m_Translation = glm::vec3(matrix[3]);
+            m_Scale = glm::vec3(glm::length(x_axis), glm::length(y_axis), glm::length(z_axis));
+
+            if (glm::dot(glm::cross(x_axis, y_axis), z_axis) < 0.0f)
+                m_Scale.x = -m_Scale.x;
 
-            /* ENG_CORE_INFO(glm::to_string(glm::translate(glm::mat4(1.0), m_Translation)));
-            ENG_CORE_INFO(glm::to_string(m_Rotation));
-            ENG_CORE_INFO(glm::to_string(glm::mat4_cast(m_Rotation)));
-            ENG_CORE_INFO(glm::to_string(glm::scale(glm::mat4(1.0), m_Scale)));
-            ENG_CORE_INFO(glm::to_string(test)); */
+            glm::mat3 rotation(x_axis / m_Scale.x, y_axis / m_Scale.y, z_axis / m_Scale.z);
+            m_Rotation = glm::normalize(glm::quat_cast(rotation));
 
-            return test;
+            InvalidateWorldMatrix();
         }
 
-        glm::mat4 Transform::GetWorldMatrix()
+        glm::mat4 Transform::GetMatrix() const
         {
-            UpdateWorldTransform();
-            /* ENG_CORE_INFO(glm::to_string(m_Translation));
-            ENG_CORE_INFO(glm::to_string(m_Rotation));
-            ENG_CORE_INFO(glm::to_string(m_Scale));
-
-            ENG_CORE_INFO(glm::to_string(m_WorldMatrix)); */
-            return m_WorldMatrix;
+            return ComposeTRS(m_Translation, m_Rotation, m_Scale);
         }
 
-        void Transform::UpdateWorldTransform()
+        void Transform::InvalidateWorldMatrix()
         {
-            if (!m_UpdateWorldMatrix)
+            if (m_UpdateWorldMatrix)
                 return;
 
-            m_WorldMatrix = GetMatrix();
-
-            m_UpdateWorldMatrix = false;
+            m_UpdateWorldMatrix = true;
+            m_Entity.GetScene().GetTransformSystem().Invalidate(m_Entity.GetHandle());
         }
     }
 }
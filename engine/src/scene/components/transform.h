@@ -9,6 +9,8 @@ ENG_ENABLE_WARNINGS()
 
 namespace engine
 {
+    class TransformSystem;
+
     namespace sg
     {
         class Transform
@@ -16,6 +18,7 @@ namespace engine
         public:
             Transform(Entity &entity);
             ~Transform();
+            Transform(const Transform &) = default;
 
             void SetTranslation(const glm::vec3 &translation)
             {
@@ -40,17 +43,19 @@ namespace engine
             const glm::vec3 &GetScale() const { return m_Scale; }
             void SetMatrix(const glm::mat4 &matrix);
             glm::mat4 GetMatrix() const;
-            glm::mat4 GetWorldMatrix();
-            void InvalidateWorldMatrix() { m_UpdateWorldMatrix = true; }
+            const glm::mat4 &GetWorldMatrix() const { return m_WorldMatrix; }
+            void InvalidateWorldMatrix();
 
         private:
+            friend class engine::TransformSystem;
+
             Entity m_Entity;
             glm::vec3 m_Translation = glm::vec3(0.0, 0.0, 0.0);
             glm::quat m_Rotation = glm::quat(0.0, 1.0, 0.0, 0.0);
             glm::vec3 m_Scale = glm::vec3(1.0, 1.0, 1.0);
             glm::mat4 m_WorldMatrix = glm::mat4(1.0);
             bool m_UpdateWorldMatrix = false;
-            void UpdateWorldTransform();
+            uint32_t m_NodeIndex = 0;
         };
     }
 }
@@ -0,0 +1,16 @@
+#include "scene/components/world_bounds.h"
+
+namespace engine
+{
+    namespace sg
+    {
+        WorldBounds::WorldBounds(uint32_t index)
+            : m_Index(index)
+        {
+        }
+
+        WorldBounds::~WorldBounds()
+        {
+        }
+    }
+}
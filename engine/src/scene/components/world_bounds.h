@@ -0,0 +1,26 @@
+#pragma once
+
+namespace engine
+{
+    class BoundsSystem;
+
+    namespace sg
+    {
+        // Marks an entity whose world space bounds are cached by the BoundsSystem
+        class WorldBounds
+        {
+        public:
+            WorldBounds(uint32_t index);
+            ~WorldBounds();
+            WorldBounds(const WorldBounds &) = default;
+
+            // Position of the entity in the dense bounds arrays
+            uint32_t GetIndex() const { return m_Index; }
+
+        private:
+            friend class engine::BoundsSystem;
+
+            uint32_t m_Index{0};
+        };
+    }
+}
@@ -0,0 +1,172 @@
+#include "scene/frustum.h"
+
+#include "common/simd.h"
+
+namespace engine
+{
+    namespace sg
+    {
+        namespace
+        {
+            inline bool IsOutside(const glm::vec4 &plane, const glm::vec3 &center, const glm::vec3 &extent)
+            {
+                float distance = glm::dot(glm::vec3(plane), center) + plane.w;
+                float radius = glm::dot(glm::abs(glm::vec3(plane)), extent);
+                return distance + radius < 0.0f;
+            }
+        }
+
+        void BoundsBatch::Resize(size_t count)
+        {
+            for (auto *array : {&m_CenterX, &m_CenterY, &m_CenterZ, &m_ExtentX, &m_ExtentY, &m_ExtentZ})
+                array->resize(count);
+        }
+
+        void BoundsBatch::Set(size_t index, const AABB &bounds)
+        {
+            auto center = bounds.GetCenter();
+            auto extent = bounds.GetExtent();
+
+            // Boxes without any points are never culled
+            if (!bounds.IsValid())
+            {
+                center = glm::vec3(0.0f);
+                extent = glm::vec3(std::numeric_limits<float>::max());
+            }
+
+            m_CenterX[index] = center.x;
+            m_CenterY[index] = center.y;
+            m_CenterZ[index] = center.z;
+            m_ExtentX[index] = extent.x;
+            m_ExtentY[index] = extent.y;
+            m_ExtentZ[index] = extent.z;
+        }
+
+        Frustum::Frustum(const glm::mat4 &view_projection)
+        {
+            Update(view_projection);
+        }
+
+        void Frustum::Update(const glm::mat4 &view_projection)
+        {
+            // Gribb-Hartmann with a [0, w] clip depth, reversed depth only swaps near and far
+            glm::vec4 row_x{view_projection[0][0], view_projection[1][0], view_projection[2][0], view_projection[3][0]};
+            glm::vec4 row_y{view_projection[0][1], view_projection[1][1], view_projection[2][1], view_projection[3][1]};
+            glm::vec4 row_z{view_projection[0][2], view_projection[1][2], view_projection[2][2], view_projection[3][2]};
+            glm::vec4 row_w{view_projection[0][3], view_projection[1][3], view_projection[2][3], view_projection[3][3]};
+
+            m_Planes[0] = row_w + row_x;
+            m_Planes[1] = row_w - row_x;
+            m_Planes[2] = row_w + row_y;
+            m_Planes[3] = row_w - row_y;
+            m_Planes[4] = row_z;
+            m_Planes[5] = row_w - row_z;
+
+            for (auto &plane : m_Planes)
+                plane /= glm::length(glm::vec3(plane));
+        }
+
+        bool Frustum::Intersects(const AABB &bounds) const
+        {
+            auto center = bounds.GetCenter();
+            auto extent = bounds.GetExtent();
+
+            for (auto &plane : m_Planes)
+            {
+                if (IsOutside(plane, center, extent))
+                    return false;
+            }
+
+            return true;
+        }
+
+        FrustumTest Frustum::Classify(const AABB &bounds) const
+        {
+            auto center = bounds.GetCenter();
+            auto extent = bounds.GetExtent();
+            auto result = FrustumTest::Inside;
+
+            for (auto &plane : m_Planes)
+            {
+                float distance = glm::dot(glm::vec3(plane), center) + plane.w;
+                float radius = glm::dot(glm::abs(glm::vec3(plane)), extent);
+
+                if (distance + radius < 0.0f)
+                    return FrustumTest::Outside;
+
+                if (distance - radius < 0.0f)
+                    result = FrustumTest::Intersects;
+            }
+
+            return result;
+        }
+
+        void Frustum::Intersects(const BoundsBatch &bounds, uint8_t *visible) const
+        {
+            Intersects(bounds, 0, bounds.GetSize(), visible);
+        }
+
+        void Frustum::Intersects(const BoundsBatch &bounds, size_t begin, size_t end, uint8_t *visible) const
+        {
+            size_t count = end;
+            size_t i = begin;
+
+#if defined(ENG_SIMD_SSE) || defined(ENG_SIMD_AVX2)
+            const __m128 sign_mask = _mm_set1_ps(-0.0f);
+            const __m128 zero = _mm_setzero_ps();
+
+            for (; i + 4 <= count; i += 4)
+            {
+                __m128 center_x = _mm_loadu_ps(bounds.m_CenterX.data() + i);
+                __m128 center_y = _mm_loadu_ps(bounds.m_CenterY.data() + i);
+                __m128 center_z = _mm_loadu_ps(bounds.m_CenterZ.data() + i);
+                __m128 extent_x = _mm_loadu_ps(bounds.m_ExtentX.data() + i);
+                __m128 extent_y = _mm_loadu_ps(bounds.m_ExtentY.data() + i);
+                __m128 extent_z = _mm_loadu_ps(bounds.m_ExtentZ.data() + i);
+
+                __m128 outside = _mm_setzero_ps();
+
+                for (auto &plane : m_Planes)
+                {
+                    __m128 normal_x = _mm_set1_ps(plane.x);
+                    __m128 normal_y = _mm_set1_ps(plane.y);
+                    __m128 normal_z = _mm_set1_ps(plane.z);
+
+                    __m128 distance = _mm_add_ps(_mm_add_ps(_mm_mul_ps(center_x, normal_x),
+                                                            _mm_mul_ps(center_y, normal_y)),
+                                                 _mm_add_ps(_mm_mul_ps(center_z, normal_z),
+                                                            _mm_set1_ps(plane.w)));
+
+                    __m128 radius = _mm_add_ps(_mm_add_ps(_mm_mul_ps(extent_x, _mm_andnot_ps(sign_mask, normal_x)),
+                                                          _mm_mul_ps(extent_y, _mm_andnot_ps(sign_mask, normal_y))),
+                                               _mm_mul_ps(extent_z, _mm_andnot_ps(sign_mask, normal_z)));
+
+                    outside = _mm_or_ps(outside, _mm_cmplt_ps(_mm_add_ps(distance, radius), zero));
+                }
+
+                int mask = _mm_movemask_ps(outside);
+                visible[i + 0] = (mask & 1) == 0;
+                visible[i + 1] = (mask & 2) == 0;
+                visible[i + 2] = (mask & 4) == 0;
+                visible[i + 3] = (mask & 8) == 0;
+            }
+#endif
+
+            for (; i < count; i++)
+            {
+                glm::vec3 center{bounds.m_CenterX[i], bounds.m_CenterY[i], bounds.m_CenterZ[i]};
+                glm::vec3 extent{bounds.m_ExtentX[i], bounds.m_ExtentY[i], bounds.m_ExtentZ[i]};
+
+                visible[i] = 1;
+                for (auto &plane : m_Planes)
+                {
+                    if (IsOutside(plane, center, extent))
+                    {
+                        visible[i] = 0;
+                        break;
+                    }
+                }
+            }
+        }
+    }
+}
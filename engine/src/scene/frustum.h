@@ -0,0 +1,49 @@
+#pragma once
+
+#include "scene/components/aabb.h"
+
+namespace engine
+{
+    namespace sg
+    {
+        // World space boxes in center/extent form, laid out for batched tests
+        class BoundsBatch
+        {
+        public:
+            void Resize(size_t count);
+            void Set(size_t index, const AABB &bounds);
+            size_t GetSize() const { return m_CenterX.size(); }
+
+            std::vector<float> m_CenterX, m_CenterY, m_CenterZ;
+            std::vector<float> m_ExtentX, m_ExtentY, m_ExtentZ;
+        };
+
+        enum class FrustumTest
+        {
+            Outside,
+            Intersects,
+            Inside
+        };
+
+        class Frustum
+        {
+        public:
+            Frustum() = default;
+            Frustum(const glm::mat4 &view_projection);
+
+            void Update(const glm::mat4 &view_projection);
+
+            bool Intersects(const AABB &bounds) const;
+            FrustumTest Classify(const AABB &bounds) const;
+            // Writes 1 into visible for every box that is at least partially inside
+            void Intersects(const BoundsBatch &bounds, uint8_t *visible) const;
+            // Only tests the boxes in [begin, end), so ranges can be tested in parallel
+            void Intersects(const BoundsBatch &bounds, size_t begin, size_t end, uint8_t *visible) const;
+
+            const std::array<glm::vec4, 6> &GetPlanes() const { return m_Planes; }
+
+        private:
+            std::array<glm::vec4, 6> m_Planes;
+        };
+    }
+}
@@ -1,37 +1,58 @@
 #define TINYGLTF_IMPLEMENTATION
 #include "scene/gltf_loader.h"
 
+#include "core/job_system.h"
 #include "core/timer.h"
 #include "platform/filesystem.h"
 #include "scene/components/image.h"
 #include "scene/components/image/astc.h"
+#include "scene/components/image/ktx.h"
+#include "scene/components/image/stb.h"
+#include "scene/components/image/transcoded.h"
 #include "scene/components/light.h"
 #include "scene/components/mesh.h"
 #include "scene/components/pbr_material.h"
 #include "scene/components/sampler.h"
+#include "scene/components/skin.h"
 #include "scene/components/submesh.h"
 #include "scene/components/texture.h"
 #include "scene/components/transform.h"
+#include "scene/systems/animation_system.h"
+#include "scene/systems/transform_system.h"
 #include "scene/components/perspective_camera.h"
 #include "scene/entity.h"
+#include "scene/mesh_optimizer.h"
 #include "scene/scene.h"
+#include "vulkan_api/command_buffer.h"
 #include "vulkan_api/command_pool.h"
 #include "vulkan_api/core/buffer.h"
+#include "vulkan_api/core/geometry_arena.h"
 #include "vulkan_api/device.h"
 #include "vulkan_api/fence_pool.h"
+#include "vulkan_api/staging_ring.h"
+#include "vulkan_api/upload_manager.h"
 
 #include "common/glm.h"
 ENG_DISABLE_WARNINGS()
-#include <ThreadPool.h>
 #include <glm/gtc/type_ptr.hpp>
 ENG_ENABLE_WARNINGS()
 
 #define KHR_LIGHTS_PUNCTUAL_EXTENSION "KHR_lights_punctual"
+#define KHR_TEXTURE_BASISU_EXTENSION "KHR_texture_basisu"
+
+#define GLB_MAGIC 0x46546C67
+#define GLB_CHUNK_JSON 0x4E4F534A
+#define GLB_CHUNK_BIN 0x004E4942
+
+// Staging memory used at once when copying geometry into the arena
 
 namespace engine
 {
     namespace
     {
+        // Largest finite half float
+        constexpr float MAX_HALF_FLOAT = 65504.0f;
+
         bool LoadImageData(tinygltf::Image *image, const int image_idx, std::string *err,
                            std::string *warn, int req_width, int req_height,
                            const unsigned char *bytes, int size, void *user_data)
@@ -99,11 +120,10 @@ namespace engine
             }
         };
 
-        inline void UploadImageToGpu(CommandBuffer &command_buffer, core::Buffer &staging_buffer, sg::Image &image)
+        // The levels from the image's base level on are staged at staging_offset, they start at data_offset in the image's data
+        inline void UploadImageToGpu(CommandBuffer &command_buffer, const core::Buffer &staging_buffer, VkDeviceSize staging_offset, sg::Image &image,
+                                     VkDeviceSize data_offset = 0)
         {
-            // Clean up the image data, as they are copied in the staging buffer
-            image.ClearData();
-
             {
                 ImageMemoryBarrier memory_barrier{};
                 memory_barrier.old_layout = VK_IMAGE_LAYOUT_UNDEFINED;
@@ -117,20 +137,22 @@ namespace engine
             }
 
             // Create a buffer image copy for every mip level
-            auto &mipmaps = image.GetMipmaps();
+            std::vector<VkBufferImageCopy> buffer_copy_regions;
 
-            std::vector<VkBufferImageCopy> buffer_copy_regions(mipmaps.size());
-
-            for (size_t i = 0; i < mipmaps.size(); ++i)
+            for (auto &mipmap : image.GetMipmaps())
             {
-                auto &mipmap = mipmaps[i];
-                auto &copy_region = buffer_copy_regions[i];
+                // Streamed images start out without their finest levels
+                if (mipmap.level < image.GetBaseLevel())
+                    continue;
 
-                copy_region.bufferOffset = mipmap.offset;
+                VkBufferImageCopy copy_region{};
+                copy_region.bufferOffset = staging_offset + mipmap.offset - data_offset;
                 copy_region.imageSubresource = image.GetVkImageView().GetSubresourceLayers();
                 // Update miplevel
-                copy_region.imageSubresource.mipLevel = mipmap.level;
+                copy_region.imageSubresource.mipLevel = mipmap.level - image.GetBaseLevel();
                 copy_region.imageExtent = mipmap.extent;
+
+                buffer_copy_regions.push_back(copy_region);
             }
 
             command_buffer.CopyBufferToImage(staging_buffer, image.GetVkImage(), buffer_copy_regions);
@@ -148,17 +170,36 @@ namespace engine
             }
         }
 
-        inline std::vector<uint8_t> GetAttributeData(const tinygltf::Model *model, uint32_t accessorId)
+        // Points into the buffer instead of copying, the range is contiguous even for interleaved accessors
+        // Every element has to lie inside the buffer, only the padding after the last one may be cut off
+        inline void CheckAccessorBounds(const tinygltf::Accessor &accessor, const tinygltf::BufferView &buffer_view, const GLTFSpan &buffer)
+        {
+            auto stride = accessor.ByteStride(buffer_view);
+            auto element_size = tinygltf::GetComponentSizeInBytes(accessor.componentType) * tinygltf::GetNumComponentsInType(accessor.type);
+
+            if (stride <= 0 || element_size <= 0)
+                throw std::runtime_error("glTF accessor has an invalid layout");
+
+            size_t start_byte = accessor.byteOffset + buffer_view.byteOffset;
+            size_t end_byte = accessor.count > 0 ? start_byte + (accessor.count - 1) * static_cast<size_t>(stride) + static_cast<size_t>(element_size) : start_byte;
+
+            if (end_byte > buffer.size)
+                throw std::runtime_error("glTF accessor is outside of its buffer");
+        }
+
+        inline GLTFSpan GetAttributeData(const tinygltf::Model *model, const std::vector<GLTFSpan> &buffers, uint32_t accessorId)
         {
             auto &accessor = model->accessors.at(accessorId);
             auto &bufferView = model->bufferViews.at(accessor.bufferView);
-            auto &buffer = model->buffers.at(bufferView.buffer);
+            auto &buffer = buffers.at(bufferView.buffer);
+
+            CheckAccessorBounds(accessor, bufferView, buffer);
 
             size_t stride = accessor.ByteStride(bufferView);
             size_t startByte = accessor.byteOffset + bufferView.byteOffset;
-            size_t endByte = startByte + accessor.count * stride;
+            size_t endByte = std::min(startByte + accessor.count * stride, buffer.size);
 
-            return {buffer.data.begin() + startByte, buffer.data.begin() + endByte};
+            return {buffer.data + startByte, endByte - startByte};
         };
 
         inline VkFormat GetAttributeFormat(const tinygltf::Model *model, uint32_t accessorId)
@@ -280,17 +321,17 @@ namespace engine
             return format;
         };
 
-        inline std::vector<uint8_t> ConvertUnderlyingDataStride(const std::vector<uint8_t> &src_data, uint32_t src_stride, uint32_t dst_stride)
+        inline std::vector<uint8_t> ConvertUnderlyingDataStride(const GLTFSpan &src_data, uint32_t src_stride, uint32_t dst_stride)
         {
-            auto elem_count = ToUint32_t(src_data.size()) / src_stride;
+            auto elem_count = ToUint32_t(src_data.size) / src_stride;
 
             std::vector<uint8_t> result(elem_count * dst_stride);
 
             for (uint32_t idxSrc = 0, idxDst = 0;
-                 idxSrc < src_data.size() && idxDst < result.size();
+                 idxSrc < src_data.size && idxDst < result.size();
                  idxSrc += src_stride, idxDst += dst_stride)
             {
-                std::copy(src_data.begin() + idxSrc, src_data.begin() + idxSrc + src_stride, result.begin() + idxDst);
+                std::copy(src_data.data + idxSrc, src_data.data + idxSrc + src_stride, result.begin() + idxDst);
             }
 
             return result;
@@ -309,6 +350,138 @@ namespace engine
             return accessor.ByteStride(bufferView);
         };
 
+        // Reads an accessor as floats, normalized integer components are converted as the spec describes
+        inline std::vector<float> GetAccessorFloats(const tinygltf::Model *model, const std::vector<GLTFSpan> &buffers, int accessor_id, uint32_t components)
+        {
+            auto &accessor = model->accessors.at(accessor_id);
+            std::vector<float> result(accessor.count * components);
+
+            if (accessor.bufferView < 0)
+                return result;
+
+            auto &buffer_view = model->bufferViews.at(accessor.bufferView);
+            auto &buffer = buffers.at(buffer_view.buffer);
+
+            CheckAccessorBounds(accessor, buffer_view, buffer);
+
+            size_t stride = accessor.ByteStride(buffer_view);
+            const uint8_t *data = buffer.data + buffer_view.byteOffset + accessor.byteOffset;
+
+            for (size_t element = 0; element < accessor.count; element++)
+            {
+                const uint8_t *element_data = data + element * stride;
+
+                for (uint32_t component = 0; component < components; component++)
+                {
+                    float value = 0.0f;
+
+                    switch (accessor.componentType)
+                    {
+                    case TINYGLTF_COMPONENT_TYPE_FLOAT:
+                        std::memcpy(&value, element_data + component * sizeof(float), sizeof(float));
+                        break;
+                    case TINYGLTF_COMPONENT_TYPE_BYTE:
+                        value = std::max(static_cast<float>(reinterpret_cast<const int8_t *>(element_data)[component]) / 127.0f, -1.0f);
+                        break;
+                    case TINYGLTF_COMPONENT_TYPE_UNSIGNED_BYTE:
+                        value = static_cast<float>(element_data[component]) / 255.0f;
+                        break;
+                    case TINYGLTF_COMPONENT_TYPE_SHORT:
+                    {
+                        int16_t raw;
+                        std::memcpy(&raw, element_data + component * sizeof(int16_t), sizeof(int16_t));
+                        value = std::max(static_cast<float>(raw) / 32767.0f, -1.0f);
+                        break;
+                    }
+                    case TINYGLTF_COMPONENT_TYPE_UNSIGNED_SHORT:
+                    {
+                        uint16_t raw;
+                        std::memcpy(&raw, element_data + component * sizeof(uint16_t), sizeof(uint16_t));
+                        value = static_cast<float>(raw) / 65535.0f;
+                        break;
+                    }
+                    default:
+                        throw std::runtime_error("Unsupported accessor component type for float data");
+                    }
+
+                    result[element * components + component] = value;
+                }
+            }
+
+            return result;
+        }
+
+        inline std::vector<uint32_t> GetAccessorUints(const tinygltf::Model *model, const std::vector<GLTFSpan> &buffers, int accessor_id, uint32_t components)
+        {
+            auto &accessor = model->accessors.at(accessor_id);
+            std::vector<uint32_t> result(accessor.count * components);
+
+            if (accessor.bufferView < 0)
+                return result;
+
+            auto &buffer_view = model->bufferViews.at(accessor.bufferView);
+            auto &buffer = buffers.at(buffer_view.buffer);
+
+            CheckAccessorBounds(accessor, buffer_view, buffer);
+
+            size_t stride = accessor.ByteStride(buffer_view);
+            const uint8_t *data = buffer.data + buffer_view.byteOffset + accessor.byteOffset;
+
+            for (size_t element = 0; element < accessor.count; element++)
+            {
+                const uint8_t *element_data = data + element * stride;
+
+                for (uint32_t component = 0; component < components; component++)
+                {
+                    uint32_t value = 0;
+
+                    switch (accessor.componentType)
+                    {
+                    case TINYGLTF_COMPONENT_TYPE_UNSIGNED_BYTE:
+                        value = element_data[component];
+                        break;
+                    case TINYGLTF_COMPONENT_TYPE_UNSIGNED_SHORT:
+                    {
+                        uint16_t raw;
+                        std::memcpy(&raw, element_data + component * sizeof(uint16_t), sizeof(uint16_t));
+                        value = raw;
+                        break;
+                    }
+                    case TINYGLTF_COMPONENT_TYPE_UNSIGNED_INT:
+                        std::memcpy(&value, element_data + component * sizeof(uint32_t), sizeof(uint32_t));
+                        break;
+                    default:
+                        throw std::runtime_error("Unsupported accessor component type for integer data");
+                    }
+
+                    result[element * components + component] = value;
+                }
+            }
+
+            return result;
+        }
+
+        inline std::string DecodeUri(const std::string &uri)
+        {
+            std::string result;
+            result.reserve(uri.size());
+
+            for (size_t i = 0; i < uri.size(); i++)
+            {
+                if (uri[i] == '%' && i + 2 < uri.size() && std::isxdigit(static_cast<unsigned char>(uri[i + 1])) && std::isxdigit(static_cast<unsigned char>(uri[i + 2])))
+                {
+                    result.push_back(static_cast<char>(std::stoi(uri.substr(i + 1, 2), nullptr, 16)));
+                    i += 2;
+                }
+                else
+                {
+                    result.push_back(uri[i]);
+                }
+            }
+
+            return result;
+        }
+
         inline tinygltf::Value *GetExtension(tinygltf::ExtensionMap &tinygltf_extensions, const std::string &extension)
         {
             auto it = tinygltf_extensions.find(extension);
@@ -318,14 +491,527 @@ namespace engine
             else
                 return nullptr;
         }
+
+        // CPU side result of one glTF primitive, prepared before any GPU resource exists
+        struct PrimitiveData
+        {
+            PrimitiveData() = default;
+
+            // index_data may point into converted_indices, which only a move hands over
+            PrimitiveData(const PrimitiveData &) = delete;
+            PrimitiveData &operator=(const PrimitiveData &) = delete;
+            PrimitiveData(PrimitiveData &&) = default;
+            PrimitiveData &operator=(PrimitiveData &&) = default;
+
+            struct Attribute
+            {
+                std::string name;
+                int accessor;
+                GLTFSpan data;
+                sg::VertexAttribute attribute;
+            };
+
+            std::vector<Attribute> attributes;
+            uint32_t vertex_count{0};
+
+            // Interleaved mode, the attributes then describe their offset in here
+            std::vector<uint8_t> interleaved;
+            std::vector<uint8_t> positions;
+            uint32_t position_stride{0};
+
+            // Points into the glTF buffer, or into converted_indices when they had to be widened
+            GLTFSpan index_data;
+            std::vector<uint8_t> converted_indices;
+            VkIndexType index_type{VK_INDEX_TYPE_UINT16};
+            uint32_t index_count{0};
+
+            sg::AABB bounds;
+            std::vector<sg::SkinVertex> skin_vertices;
+
+            // Quantized positions decode to position_offset + value * position_scale
+            glm::vec3 position_offset{0.0f};
+            glm::vec3 position_scale{1.0f};
+
+            // Vertex cache efficiency before and after the mesh optimization, 0 when it didn't run
+            float acmr_before{0.0f};
+            float acmr_after{0.0f};
+        };
+
+        std::vector<sg::SkinVertex> ExtractSkinVertices(const tinygltf::Model *model, const std::vector<GLTFSpan> &buffers, const tinygltf::Primitive &gltf_primitive)
+        {
+            auto &attributes = gltf_primitive.attributes;
+
+            auto positions = GetAccessorFloats(model, buffers, attributes.at("POSITION"), 3);
+            auto joints = GetAccessorUints(model, buffers, attributes.at("JOINTS_0"), 4);
+            auto weights = GetAccessorFloats(model, buffers, attributes.at("WEIGHTS_0"), 4);
+
+            std::vector<float> normals;
+            if (attributes.count("NORMAL"))
+                normals = GetAccessorFloats(model, buffers, attributes.at("NORMAL"), 3);
+
+            size_t vertex_count = positions.size() / 3;
+            if (joints.size() != vertex_count * 4 || weights.size() != vertex_count * 4)
+            {
+                ENG_CORE_WARN("Skinned glTF primitive has mismatched joint attributes, drawing it unskinned");
+                return {};
+            }
+
+            std::vector<sg::SkinVertex> skin_vertices(vertex_count);
+
+            for (size_t vertex_index = 0; vertex_index < vertex_count; vertex_index++)
+            {
+                auto &vertex = skin_vertices[vertex_index];
+                auto *position = &positions[vertex_index * 3];
+                auto *joint = &joints[vertex_index * 4];
+                auto *weight = &weights[vertex_index * 4];
+
+                vertex.position = glm::vec4(position[0], position[1], position[2], 1.0f);
+                vertex.normal = normals.empty() ? glm::vec4(0.0f, 0.0f, 1.0f, 0.0f)
+                                                : glm::vec4(normals[vertex_index * 3], normals[vertex_index * 3 + 1], normals[vertex_index * 3 + 2], 0.0f);
+                vertex.joints = glm::uvec4(joint[0], joint[1], joint[2], joint[3]);
+                vertex.weights = glm::vec4(weight[0], weight[1], weight[2], weight[3]);
+            }
+
+            return skin_vertices;
+        }
+
+        // Attribute offsets are four byte aligned, as Vulkan requires for most formats
+        void InterleaveAttributes(const tinygltf::Model *model, PrimitiveData &primitive)
+        {
+            std::vector<uint32_t> element_sizes;
+            std::vector<uint32_t> offsets;
+            uint32_t stride = 0;
+
+            for (auto &attribute : primitive.attributes)
+            {
+                auto &accessor = model->accessors.at(attribute.accessor);
+
+                int component_size = tinygltf::GetComponentSizeInBytes(accessor.componentType);
+                int component_count = tinygltf::GetNumComponentsInType(accessor.type);
+
+                if (accessor.count != primitive.vertex_count || component_size <= 0 || component_count <= 0)
+                    return;
+
+                element_sizes.push_back(ToUint32_t(component_size * component_count));
+                offsets.push_back(stride);
+                stride += (element_sizes.back() + 3) & ~3u;
+            }
+
+            if (stride == 0)
+                return;
+
+            primitive.interleaved.resize(static_cast<size_t>(primitive.vertex_count) * stride);
+
+            for (size_t attribute_index = 0; attribute_index < primitive.attributes.size(); attribute_index++)
+            {
+                auto &attribute = primitive.attributes[attribute_index];
+                auto element_size = element_sizes[attribute_index];
+                auto *destination = primitive.interleaved.data() + offsets[attribute_index];
+
+                for (size_t vertex_index = 0; vertex_index < primitive.vertex_count; vertex_index++)
+                    std::memcpy(destination + vertex_index * stride, attribute.data.data + vertex_index * attribute.attribute.stride, element_size);
+
+                if (attribute.name == "position")
+                {
+                    primitive.positions.resize(static_cast<size_t>(primitive.vertex_count) * element_size);
+                    primitive.position_stride = element_size;
+
+                    for (size_t vertex_index = 0; vertex_index < primitive.vertex_count; vertex_index++)
+                        std::memcpy(primitive.positions.data() + vertex_index * element_size, attribute.data.data + vertex_index * attribute.attribute.stride, element_size);
+                }
+
+                attribute.attribute.offset = offsets[attribute_index];
+                attribute.attribute.stride = stride;
+            }
+        }
+
+        // Reorders the triangles, and the vertices when the primitive owns them. The indices are written into converted_indices
+        void OptimizePrimitive(PrimitiveData &primitive)
+        {
+            if (primitive.index_count < 3 || primitive.vertex_count == 0)
+                return;
+
+            auto index_size = primitive.index_type == VK_INDEX_TYPE_UINT32 ? sizeof(uint32_t) : sizeof(uint16_t);
+            std::vector<uint32_t> indices(primitive.index_count - primitive.index_count % 3);
+
+            for (size_t i = 0; i < indices.size(); i++)
+            {
+                if (index_size == sizeof(uint32_t))
+                {
+                    std::memcpy(&indices[i], primitive.index_data.data + i * index_size, index_size);
+                }
+                else
+                {
+                    uint16_t index;
+                    std::memcpy(&index, primitive.index_data.data + i * index_size, index_size);
+                    indices[i] = index;
+                }
+
+                // Invalid content is uploaded as it is
+                if (indices[i] >= primitive.vertex_count)
+                    return;
+            }
+
+            primitive.acmr_before = sg::ComputeACMR(indices, primitive.vertex_count);
+
+            std::vector<uint32_t> clusters;
+            sg::OptimizeVertexCache(indices, primitive.vertex_count, clusters);
+
+            const uint8_t *positions = nullptr;
+            size_t position_stride = 0;
+
+            if (!primitive.positions.empty())
+            {
+                positions = primitive.positions.data();
+                position_stride = primitive.position_stride;
+            }
+            else
+            {
+                for (auto &attribute : primitive.attributes)
+                {
+                    if (attribute.name == "position")
+                    {
+                        positions = attribute.data.data;
+                        position_stride = attribute.attribute.stride;
+                    }
+                }
+            }
+
+            if (positions && position_stride >= sizeof(glm::vec3))
+                sg::OptimizeOverdraw(indices, clusters, positions, position_stride, primitive.vertex_count);
+
+            // Split attributes still point into the glTF buffers, only interleaved vertices can be moved
+            if (!primitive.interleaved.empty())
+            {
+                std::vector<uint32_t> remap;
+                sg::OptimizeVertexFetch(indices, primitive.vertex_count, remap);
+
+                sg::RemapVertices(primitive.interleaved, primitive.interleaved.size() / primitive.vertex_count, remap);
+
+                if (!primitive.positions.empty())
+                    sg::RemapVertices(primitive.positions, primitive.position_stride, remap);
+            }
+
+            primitive.acmr_after = sg::ComputeACMR(indices, primitive.vertex_count);
+
+            primitive.converted_indices.resize(indices.size() * index_size);
+
+            for (size_t i = 0; i < indices.size(); i++)
+            {
+                if (index_size == sizeof(uint32_t))
+                {
+                    std::memcpy(primitive.converted_indices.data() + i * index_size, &indices[i], index_size);
+                }
+                else
+                {
+                    auto index = static_cast<uint16_t>(indices[i]);
+                    std::memcpy(primitive.converted_indices.data() + i * index_size, &index, index_size);
+                }
+            }
+
+            primitive.index_data = {primitive.converted_indices.data(), primitive.converted_indices.size()};
+            primitive.index_count = ToUint32_t(indices.size());
+        }
+
+        // Octahedral mapping of a unit vector onto [-1, 1]^2, Cigolle et al. 2014
+        glm::vec2 EncodeOctahedral(glm::vec3 vector)
+        {
+            auto length = std::abs(vector.x) + std::abs(vector.y) + std::abs(vector.z);
+            if (length == 0.0f)
+                return glm::vec2(0.0f);
+
+            vector /= length;
+
+            glm::vec2 result(vector.x, vector.y);
+
+            if (vector.z < 0.0f)
+            {
+                result = glm::vec2((1.0f - std::abs(vector.y)) * (vector.x >= 0.0f ? 1.0f : -1.0f),
+                                   (1.0f - std::abs(vector.x)) * (vector.y >= 0.0f ? 1.0f : -1.0f));
+            }
+
+            return result;
+        }
+
+        // Format an interleaved float attribute is stored in, VK_FORMAT_UNDEFINED keeps it as it is
+        VkFormat GetQuantizedFormat(const PrimitiveData &primitive, const PrimitiveData::Attribute &attribute)
+        {
+            auto format = attribute.attribute.format;
+
+            if (attribute.name == "position" && format == VK_FORMAT_R32G32B32_SFLOAT && primitive.bounds.IsValid())
+                return VK_FORMAT_R16G16B16A16_UNORM;
+
+            if (attribute.name == "normal" && format == VK_FORMAT_R32G32B32_SFLOAT)
+                return VK_FORMAT_R16G16_SNORM;
+
+            if (attribute.name.rfind("texcoord_", 0) == 0 && format == VK_FORMAT_R32G32_SFLOAT)
+            {
+                // Coordinates past the half float range stay at full precision
+                for (size_t vertex_index = 0; vertex_index < primitive.vertex_count; vertex_index++)
+                {
+                    glm::vec2 texcoord;
+                    std::memcpy(&texcoord, primitive.interleaved.data() + vertex_index * attribute.attribute.stride + attribute.attribute.offset, sizeof(glm::vec2));
+
+                    if (!(std::abs(texcoord.x) <= MAX_HALF_FLOAT && std::abs(texcoord.y) <= MAX_HALF_FLOAT))
+                        return VK_FORMAT_UNDEFINED;
+                }
+
+                return VK_FORMAT_R16G16_SFLOAT;
+            }
+
+            return VK_FORMAT_UNDEFINED;
+        }
+
+        // Writes the float attribute at source into its quantized format
+        void QuantizeElement(const PrimitiveData &primitive, VkFormat format, const uint8_t *source, uint8_t *destination)
+        {
+            switch (format)
+            {
+            case VK_FORMAT_R16G16B16A16_UNORM:
+            {
+                glm::vec3 position;
+                std::memcpy(&position, source, sizeof(glm::vec3));
+
+                auto extent = primitive.bounds.GetMax() - primitive.bounds.GetMin();
+                auto scale = glm::vec3(extent.x > 0.0f ? 1.0f / extent.x : 0.0f,
+                                       extent.y > 0.0f ? 1.0f / extent.y : 0.0f,
+                                       extent.z > 0.0f ? 1.0f / extent.z : 0.0f);
+                auto normalized = (position - primitive.bounds.GetMin()) * scale;
+
+                uint32_t packed[2] = {glm::packUnorm2x16(glm::vec2(normalized.x, normalized.y)),
+                                      glm::packUnorm2x16(glm::vec2(normalized.z, 1.0f))};
+                std::memcpy(destination, packed, sizeof(packed));
+                break;
+            }
+            case VK_FORMAT_R16G16_SNORM:
+            {
+                glm::vec3 normal;
+                std::memcpy(&normal, source, sizeof(glm::vec3));
+
+                auto packed = glm::packSnorm2x16(EncodeOctahedral(normal));
+                std::memcpy(destination, &packed, sizeof(packed));
+                break;
+            }
+            case VK_FORMAT_R16G16_SFLOAT:
+            {
+                glm::vec2 texcoord;
+                std::memcpy(&texcoord, source, sizeof(glm::vec2));
+
+                auto packed = glm::packHalf2x16(texcoord);
+                std::memcpy(destination, &packed, sizeof(packed));
+                break;
+            }
+            default:
+                break;
+            }
+        }
+
+        // Packs the interleaved float attributes into smaller formats the shader variants decode. Runs after
+        // the optimization, which reads the positions as floats
+        void QuantizeAttributes(PrimitiveData &primitive)
+        {
+            if (primitive.interleaved.empty() || primitive.vertex_count == 0)
+                return;
+
+            auto source_stride = primitive.attributes.front().attribute.stride;
+
+            std::vector<VkFormat> formats;
+            std::vector<uint32_t> source_sizes;
+            std::vector<uint32_t> offsets;
+            std::vector<bool> kept;
+            uint32_t stride = 0;
+
+            for (size_t attribute_index = 0; attribute_index < primitive.attributes.size(); attribute_index++)
+            {
+                auto &attribute = primitive.attributes[attribute_index];
+
+                // Offsets are aligned already, so the distance to the next attribute covers the element and its padding
+                auto next_offset = attribute_index + 1 < primitive.attributes.size() ? primitive.attributes[attribute_index + 1].attribute.offset : source_stride;
+                auto format = GetQuantizedFormat(primitive, attribute);
+
+                formats.push_back(format);
+                source_sizes.push_back(next_offset - attribute.attribute.offset);
+                offsets.push_back(stride);
+
+                // No shader variant reads tangents, the quantized vertices leave them out
+                kept.push_back(attribute.name != "tangent");
+                if (!kept.back())
+                    continue;
+
+                // Every quantized format is 4 or 8 bytes
+                stride += format == VK_FORMAT_UNDEFINED ? source_sizes.back() : format == VK_FORMAT_R16G16B16A16_UNORM ? 8 : 4;
+            }
+
+            if (stride == source_stride)
+                return;
+
+            std::vector<uint8_t> interleaved(static_cast<size_t>(primitive.vertex_count) * stride);
+
+            for (size_t attribute_index = 0; attribute_index < primitive.attributes.size(); attribute_index++)
+            {
+                auto &attribute = primitive.attributes[attribute_index];
+                auto format = formats[attribute_index];
+
+                if (!kept[attribute_index])
+                    continue;
+
+                for (size_t vertex_index = 0; vertex_index < primitive.vertex_count; vertex_index++)
+                {
+                    auto *source = primitive.interleaved.data() + vertex_index * source_stride + attribute.attribute.offset;
+                    auto *destination = interleaved.data() + vertex_index * stride + offsets[attribute_index];
+
+                    if (format == VK_FORMAT_UNDEFINED)
+                        std::memcpy(destination, source, source_sizes[attribute_index]);
+                    else
+                        QuantizeElement(primitive, format, source, destination);
+                }
+
+                if (format == VK_FORMAT_R16G16B16A16_UNORM)
+                {
+                    primitive.position_offset = primitive.bounds.GetMin();
+                    primitive.position_scale = primitive.bounds.GetMax() - primitive.bounds.GetMin();
+
+                    // The split position stream has to match the format the shader variant decodes
+                    if (!primitive.positions.empty())
+                    {
+                        std::vector<uint8_t> positions(static_cast<size_t>(primitive.vertex_count) * 8);
+
+                        for (size_t vertex_index = 0; vertex_index < primitive.vertex_count; vertex_index++)
+                            QuantizeElement(primitive, format, primitive.positions.data() + vertex_index * primitive.position_stride, positions.data() + vertex_index * 8);
+
+                        primitive.positions.swap(positions);
+                        primitive.position_stride = 8;
+                    }
+                }
+
+                if (format != VK_FORMAT_UNDEFINED)
+                    attribute.attribute.format = format;
+
+                attribute.attribute.offset = offsets[attribute_index];
+                attribute.attribute.stride = stride;
+            }
+
+            std::vector<PrimitiveData::Attribute> attributes;
+            for (size_t attribute_index = 0; attribute_index < primitive.attributes.size(); attribute_index++)
+            {
+                if (kept[attribute_index])
+                    attributes.push_back(std::move(primitive.attributes[attribute_index]));
+            }
+
+            primitive.attributes.swap(attributes);
+            primitive.interleaved.swap(interleaved);
+        }
+
+        // Only reads the model, so primitives can be processed concurrently
+        PrimitiveData ProcessPrimitive(const tinygltf::Model *model, const std::vector<GLTFSpan> &buffers, const tinygltf::Primitive &gltf_primitive, const GLTFLoaderSettings &settings)
+        {
+            PrimitiveData primitive;
+
+            for (auto &attribute : gltf_primitive.attributes)
+            {
+                std::string attrib_name = attribute.first;
+                std::transform(attrib_name.begin(), attrib_name.end(), attrib_name.begin(), ::tolower);
+
+                auto vertex_data = GetAttributeData(model, buffers, attribute.second);
+
+                if (attrib_name == "position")
+                {
+                    auto &accessor = model->accessors.at(attribute.second);
+                    primitive.vertex_count = ToUint32_t(accessor.count);
+
+                    // POSITION accessors are required to declare their bounds
+                    if (accessor.minValues.size() == 3 && accessor.maxValues.size() == 3)
+                    {
+                        primitive.bounds = sg::AABB{glm::vec3(accessor.minValues[0], accessor.minValues[1], accessor.minValues[2]),
+                                                    glm::vec3(accessor.maxValues[0], accessor.maxValues[1], accessor.maxValues[2])};
+                    }
+                    else
+                    {
+                        auto stride = GetAttributeStride(model, attribute.second);
+
+                        for (size_t vertex_index = 0; vertex_index < accessor.count; vertex_index++)
+                        {
+                            glm::vec3 position;
+                            std::memcpy(&position, vertex_data.data + vertex_index * stride, sizeof(glm::vec3));
+                            primitive.bounds.Update(position);
+                        }
+                    }
+                }
+
+                sg::VertexAttribute attrib;
+                attrib.format = GetAttributeFormat(model, attribute.second);
+                attrib.stride = ToUint32_t(GetAttributeStride(model, attribute.second));
+
+                primitive.attributes.push_back({attrib_name, attribute.second, vertex_data, attrib});
+            }
+
+            if (gltf_primitive.indices >= 0)
+            {
+                primitive.index_count = ToUint32_t(GetAttributeSize(model, gltf_primitive.indices));
+                primitive.index_data = GetAttributeData(model, buffers, gltf_primitive.indices);
+
+                switch (GetAttributeFormat(model, gltf_primitive.indices))
+                {
+                case VK_FORMAT_R8_UINT:
+                    // Converts uint8 data into uint16 data, still represented by a uint8 vector
+                    primitive.converted_indices = ConvertUnderlyingDataStride(primitive.index_data, 1, 2);
+                    primitive.index_data = {primitive.converted_indices.data(), primitive.converted_indices.size()};
+                    primitive.index_type = VK_INDEX_TYPE_UINT16;
+                    break;
+                case VK_FORMAT_R16_UINT:
+                    primitive.index_type = VK_INDEX_TYPE_UINT16;
+                    break;
+                case VK_FORMAT_R32_UINT:
+                    primitive.index_type = VK_INDEX_TYPE_UINT32;
+                    break;
+                default:
+                    ENG_CORE_ERROR("gltf primitive has invalid format type");
+                    break;
+                }
+            }
+            else
+            {
+                primitive.vertex_count = ToUint32_t(GetAttributeSize(model, gltf_primitive.attributes.at("POSITION")));
+            }
+
+            if (gltf_primitive.attributes.count("JOINTS_0") && gltf_primitive.attributes.count("WEIGHTS_0"))
+                primitive.skin_vertices = ExtractSkinVertices(model, buffers, gltf_primitive);
+
+            // The skinning paths replace positions and normals with their own split streams
+            if (settings.interleave_vertices && primitive.skin_vertices.empty())
+                InterleaveAttributes(model, primitive);
+
+            bool triangle_list = gltf_primitive.mode == TINYGLTF_MODE_TRIANGLES || gltf_primitive.mode == -1;
+
+            if (settings.optimize_meshes && triangle_list && gltf_primitive.indices >= 0)
+                OptimizePrimitive(primitive);
+
+            if (settings.quantize_vertices)
+                QuantizeAttributes(primitive);
+
+            return primitive;
+        }
     }
 
     std::unordered_map<std::string, bool> GLTFLoader::m_SupportedExtensions = {
-        {KHR_LIGHTS_PUNCTUAL_EXTENSION, false}};
+        {KHR_LIGHTS_PUNCTUAL_EXTENSION, false},
+        {KHR_TEXTURE_BASISU_EXTENSION, false}};
 
-    GLTFLoader::GLTFLoader(Device &device)
-        : m_Device(device)
+    GLTFLoader::GLTFLoader(Device &device, const GLTFLoaderSettings &settings)
+        : m_Device(device),
+          m_Settings(settings),
+          m_Extensions(m_SupportedExtensions)
     {
+        m_CommandPool = std::make_unique<CommandPool>(m_Device, m_Device.GetQueueFamilyByFlags(VK_QUEUE_GRAPHICS_BIT).GetFamilyIndex());
+        m_BasisFormats = sg::Ktx::get_transcode_formats(m_Device);
+
+        if (m_Settings.transcode_textures)
+        {
+            m_TranscodeFormats = sg::Transcoded::get_supported_formats(m_Device);
+
+            if (m_Settings.cache_transcoded_textures)
+                m_TranscodeCacheDirectory = fs::path::Get(fs::path::Type::Cache);
+        }
     }
 
     GLTFLoader::~GLTFLoader()
@@ -333,6 +1019,41 @@ namespace engine
     }
 
     std::unique_ptr<Scene> GLTFLoader::ReadSceneFromFile(const std::string &file_name, int scene_index)
+    {
+        if (!ReadModel(file_name))
+            return nullptr;
+
+        auto scene = std::make_unique<Scene>();
+        m_Scene = scene.get();
+        m_Progressive = false;
+
+        LoadScene(scene_index);
+
+        m_Buffers.clear();
+        m_MappedFiles.clear();
+        m_Scene = nullptr;
+
+        return scene;
+    }
+
+    bool GLTFLoader::ReadSceneFromFile(const std::string &file_name, Scene &scene, int scene_index)
+    {
+        if (!ReadModel(file_name))
+            return false;
+
+        m_Scene = &scene;
+        m_Progressive = true;
+
+        LoadScene(scene_index);
+
+        m_Buffers.clear();
+        m_MappedFiles.clear();
+        m_Scene = nullptr;
+
+        return true;
+    }
+
+    bool GLTFLoader::ReadModel(const std::string &file_name)
     {
         std::string err;
         std::string warn;
@@ -346,7 +1067,9 @@ namespace engine
         bool binary = gltf_file.extension() == ".glb";
 
         bool import_result = false;
-        if (binary)
+        if (m_Settings.map_buffers)
+            import_result = ReadMappedModel(gltf_file, binary, err, warn);
+        else if (binary)
             import_result = gltf_loader.LoadBinaryFromFile(&m_Model, &err, &warn, gltf_file.generic_string());
         else
             import_result = gltf_loader.LoadASCIIFromFile(&m_Model, &err, &warn, gltf_file.generic_string());
@@ -358,7 +1081,7 @@ namespace engine
         {
             ENG_CORE_ERROR("Error loading gltf model: {}.", err.c_str());
 
-            return nullptr;
+            return false;
         }
 
         if (!warn.empty())
@@ -366,15 +1089,175 @@ namespace engine
             ENG_CORE_WARN("{}", warn.c_str());
         }
 
-        if (import_result)
+        if (!import_result)
+            return false;
+
+        m_ModelPath = gltf_file.parent_path();
+
+        // Buffers tinygltf read itself, all of them unless they were mapped
+        m_Buffers.resize(m_Model.buffers.size());
+        for (size_t buffer_index = 0; buffer_index < m_Buffers.size(); buffer_index++)
+        {
+            auto &data = m_Model.buffers[buffer_index].data;
+            if (!m_Buffers[buffer_index].data)
+                m_Buffers[buffer_index] = {data.data(), data.size()};
+        }
+
+        return true;
+    }
+
+    bool GLTFLoader::ReadMappedModel(const std::filesystem::path &gltf_file, bool binary, std::string &err, std::string &warn)
+    {
+        auto base_dir = gltf_file.parent_path();
+
+        std::string json_text;
+        GLTFSpan binary_chunk{};
+
+        if (binary)
+        {
+            auto file = std::make_unique<fs::MappedFile>(gltf_file);
+            const uint8_t *data = file->GetData();
+            size_t size = file->GetSize();
+
+            auto read_uint32 = [data](size_t offset)
+            {
+                uint32_t value;
+                std::memcpy(&value, data + offset, sizeof(uint32_t));
+                return value;
+            };
+
+            if (size < 20 || read_uint32(0) != GLB_MAGIC || read_uint32(4) != 2)
+            {
+                err = "Invalid GLB header in " + gltf_file.generic_string();
+                return false;
+            }
+
+            // Chunks are padded to four bytes, their length includes the padding
+            for (size_t offset = 12; offset + 8 <= size;)
+            {
+                uint32_t chunk_length = read_uint32(offset);
+                uint32_t chunk_type = read_uint32(offset + 4);
+                offset += 8;
+
+                if (offset + chunk_length > size)
+                {
+                    err = "Truncated GLB chunk in " + gltf_file.generic_string();
+                    return false;
+                }
+
+                if (chunk_type == GLB_CHUNK_JSON)
+                    json_text.assign(reinterpret_cast<const char *>(data + offset), chunk_length);
+                else if (chunk_type == GLB_CHUNK_BIN && !binary_chunk.data)
+                    binary_chunk = {data + offset, chunk_length};
+
+                offset += chunk_length;
+            }
+
+            m_MappedFiles.push_back(std::move(file));
+        }
+        else
+        {
+            json_text = fs::ReadTextFile(gltf_file);
+        }
+
+        auto json = nlohmann::json::parse(json_text, nullptr, false);
+        if (json.is_discarded())
+        {
+            err = "Invalid glTF JSON in " + gltf_file.generic_string();
+            return false;
+        }
+
+        m_Buffers.clear();
+
+        if (json.contains("buffers") && json["buffers"].is_array())
+        {
+            auto &buffers = json["buffers"];
+            m_Buffers.resize(buffers.size());
+
+            for (size_t buffer_index = 0; buffer_index < buffers.size(); buffer_index++)
+            {
+                auto &buffer = buffers[buffer_index];
+                auto byte_length = buffer.value("byteLength", size_t{0});
+
+                if (buffer.contains("uri"))
+                {
+                    auto uri = buffer["uri"].get<std::string>();
+
+                    // Base64 buffers have to be decoded anyway, tinygltf takes care of them
+                    if (uri.rfind("data:", 0) == 0)
+                        continue;
+
+                    auto file = std::make_unique<fs::MappedFile>(base_dir / DecodeUri(uri));
+                    if (file->GetSize() < byte_length)
+                    {
+                        err = "glTF buffer file " + uri + " is smaller than its byteLength";
+                        return false;
+                    }
+
+                    m_Buffers[buffer_index] = {file->GetData(), byte_length};
+                    m_MappedFiles.push_back(std::move(file));
+                }
+                else if (buffer_index == 0 && binary_chunk.data && binary_chunk.size >= byte_length)
+                {
+                    m_Buffers[buffer_index] = {binary_chunk.data, byte_length};
+                }
+                else
+                {
+                    err = "glTF buffer " + std::to_string(buffer_index) + " has no data";
+                    return false;
+                }
+
+                // Hand tinygltf an empty embedded buffer so it doesn't read the file into memory
+                buffer["uri"] = "data:application/octet-stream;base64,";
+                buffer["byteLength"] = 0;
+            }
+        }
+
+        // tinygltf indexes the buffer of an image buffer view, which is empty now. Images point at a small placeholder
+        // buffer view instead and get their own back afterwards, ParseImage reads them from the mapped buffers
+        std::vector<std::pair<size_t, int>> image_buffer_views;
+
+        if (json.contains("images") && json["images"].is_array())
+        {
+            auto &images = json["images"];
+            size_t placeholder_view = json.contains("bufferViews") ? json["bufferViews"].size() : 0;
+            size_t placeholder_buffer = m_Buffers.size();
+
+            for (size_t image_index = 0; image_index < images.size(); image_index++)
+            {
+                auto &image = images[image_index];
+                if (!image.contains("bufferView"))
+                    continue;
+
+                image_buffer_views.emplace_back(image_index, image["bufferView"].get<int>());
+                image["bufferView"] = placeholder_view;
+            }
+
+            if (!image_buffer_views.empty())
+            {
+                json["buffers"].push_back({{"uri", "data:application/octet-stream;base64,AAAAAA=="}, {"byteLength", 4}});
+                json["bufferViews"].push_back({{"buffer", placeholder_buffer}, {"byteLength", 4}});
+            }
+        }
+
+        json_text = json.dump();
+
+        tinygltf::TinyGLTF gltf_loader;
+        gltf_loader.SetImageLoader(LoadImageData, this);
+
+        if (!gltf_loader.LoadASCIIFromString(&m_Model, &err, &warn, json_text.c_str(), ToUint32_t(json_text.size()), base_dir.generic_string()))
+            return false;
+
+        if (!image_buffer_views.empty())
         {
-            m_ModelPath = fs::path::Get(fs::path::Type::Assets, file_name).parent_path();
+            for (auto &image_buffer_view : image_buffer_views)
+                m_Model.images[image_buffer_view.first].bufferView = image_buffer_view.second;
 
-            LoadScene(scene_index);
-            return std::move(m_Scene);
+            m_Model.bufferViews.pop_back();
+            m_Model.buffers.pop_back();
         }
 
-        return nullptr;
+        return true;
     }
 
     void GLTFLoader::LoadScene(int scene_index)
@@ -383,21 +1266,34 @@ namespace engine
         LoadScenes(scene_index);
         LoadLights();
         LoadSamplers();
-        LoadImages();
+
+        if (!m_Progressive)
+        {
+            for (auto &image : LoadImages())
+                m_Scene->GetImages().push_back(std::move(image));
+        }
+
         LoadTextures();
         LoadMaterials();
         LoadMeshes();
         LoadCameras();
         LoadNodes();
+        LoadSkins();
+        LoadAnimations();
+
+        if (m_Progressive)
+            PublishImages();
+        else if (m_Settings.stream_textures)
+            m_Scene->SetTextureStreamer(std::make_unique<TextureStreamer>(m_Device, *m_Scene, m_Settings.texture_streaming));
     }
 
     void GLTFLoader::CheckExtensions()
     {
         for (auto &used_extension : m_Model.extensionsUsed)
         {
-            auto it = m_SupportedExtensions.find(used_extension);
+            auto it = m_Extensions.find(used_extension);
 
-            if (it == m_SupportedExtensions.end())
+            if (it == m_Extensions.end())
             {
                 if (std::find(m_Model.extensionsRequired.begin(), m_Model.extensionsRequired.end(), used_extension) != m_Model.extensionsRequired.end())
                     throw std::runtime_error("Cannot load glTF file. Contains a required unsupported extension: " + used_extension);
@@ -406,9 +1302,22 @@ namespace engine
             }
             else
             {
-                // Extension is supported, so enable it
-                ENG_CORE_INFO("glTF file contains extension: {}", used_extension);
-                it->second = true;
+                // Extension is supported, so enable it
+                ENG_CORE_INFO("glTF file contains extension: {}", used_extension);
+                it->second = true;
+            }
+        }
+
+        // KTX2 images replace the fallback source of textures, which clients without the extension load
+        if (IsExtensionEnabled(KHR_TEXTURE_BASISU_EXTENSION))
+        {
+            for (auto &gltf_texture : m_Model.textures)
+            {
+                if (auto extension = GetExtension(gltf_texture.extensions, KHR_TEXTURE_BASISU_EXTENSION))
+                {
+                    if (extension->Has("source"))
+                        gltf_texture.source = extension->Get("source").Get<int>();
+                }
             }
         }
     }
@@ -430,88 +1339,311 @@ namespace engine
         }
     }
 
-    void GLTFLoader::LoadImages()
+    std::vector<std::unique_ptr<sg::Image>> GLTFLoader::LoadImages()
     {
         Timer timer;
         timer.Start();
 
-        auto thread_count = std::thread::hardware_concurrency();
-
-        // TODO: have central thread pool
-        thread_count = thread_count == 0 ? 1 : thread_count;
-        // thread_count = 1;
-        ThreadPool thread_pool(thread_count);
+        auto &job_system = JobSystem::Get();
 
         auto image_count = ToUint32_t(m_Model.images.size());
 
-        std::vector<std::future<std::unique_ptr<sg::Image>>> image_component_futures;
+        // Decoded images wait here with their staging allocation until their copies are recorded
+        struct DecodedImage
+        {
+            size_t index;
+            std::unique_ptr<sg::Image> image;
+            StagingRing::Allocation allocation;
+            // Where the staged levels start in the image's data
+            VkDeviceSize data_offset{0};
+            std::exception_ptr exception;
+        };
+
+        std::mutex decoded_mutex;
+        std::condition_variable decoded_condition;
+        std::deque<DecodedImage> decoded_images;
+
+        StagingRing staging_ring(m_Device, m_Settings.texture_staging_budget);
+        staging_ring.SetWaitCallback([&decoded_mutex, &decoded_condition]()
+                                     {
+                                         std::lock_guard<std::mutex> lock(decoded_mutex);
+                                         decoded_condition.notify_one();
+                                     });
+
+        // Mipmaps of color images are filtered in linear space, whatever format the decoder tagged them with
+        auto srgb_images = GetSrgbImages();
+
+        // Waited for before anything the decode jobs use goes out of scope
+        JobCounter decode_counter;
+
         for (size_t image_index = 0; image_index < image_count; image_index++)
         {
-            auto fut = thread_pool.enqueue(
-                [this, image_index]()
+            // Decoding takes long, so only workers run it and the main thread's waits between frames never pick it up.
+            // Loads run on their own threads, see Application::LoadSceneAsync, so the workers are free for it
+            job_system.RunBackground(
+                [this, image_index, &srgb_images, &staging_ring, &decoded_mutex, &decoded_condition, &decoded_images]()
                 {
-                    auto image = ParseImage(m_Model.images.at(image_index));
+                    DecodedImage decoded{};
+                    decoded.index = image_index;
+
+                    try
+                    {
+                        bool generate_mipmaps = false;
+                        auto image = ParseImage(m_Model.images.at(image_index), generate_mipmaps);
+                        bool srgb = srgb_images[image_index];
+
+                        // Streamed images keep their whole chain, the GPU starts out with the smallest levels
+                        bool streamed = m_Settings.stream_textures && image->GetLayers() == 1;
+
+                        if (streamed)
+                        {
+                            if (generate_mipmaps)
+                                image->GenerateMipmaps(srgb);
+
+                            generate_mipmaps = false;
+                            image->SetBaseLevel(TextureStreamer::GetTailLevel(*image, m_Settings.texture_streaming.tail_size));
+                            streamed = image->GetBaseLevel() > 0;
+                        }
+
+                        size_t size = 0;
+
+                        if (streamed)
+                            std::tie(decoded.data_offset, size) = image->GetLevelRange(image->GetBaseLevel());
+                        else
+                            size = generate_mipmaps ? image->LayoutMipmaps() : image->GetData().size();
+
+                        image->CreateVkImage(m_Device);
+
+                        // Only this image's decoded pixels live outside the staging budget
+                        decoded.allocation = staging_ring.Allocate(size);
+
+                        if (generate_mipmaps)
+                            image->WriteMipmaps(decoded.allocation.data, srgb);
+                        else
+                            std::memcpy(decoded.allocation.data, image->GetData().data() + decoded.data_offset, size);
+
+                        if (!streamed)
+                            image->ClearData();
+
+                        decoded.image = std::move(image);
+
+                        ENG_CORE_TRACE("Loaded gltf image #{} ({})", image_index, m_Model.images.at(image_index).uri.c_str());
+                    }
+                    catch (...)
+                    {
+                        decoded.exception = std::current_exception();
 
-                    ENG_CORE_TRACE("Loaded gltf image #{} ({})", image_index, m_Model.images.at(image_index).uri.c_str());
+                        // Failed images are never recorded, so their staging memory is given back here
+                        if (decoded.allocation.buffer)
+                            staging_ring.Free(decoded.allocation);
 
-                    return image;
-                });
+                        decoded.allocation = {};
+                    }
 
-            image_component_futures.push_back(std::move(fut));
+                    std::lock_guard<std::mutex> lock(decoded_mutex);
+                    decoded_images.push_back(std::move(decoded));
+                    decoded_condition.notify_one();
+                },
+                &decode_counter);
         }
 
-        for (auto &fut : image_component_futures)
+        auto &queue = m_Device.GetQueueFamilyByFlags(VK_QUEUE_GRAPHICS_BIT).GetQueues()[0];
+
+        std::vector<std::unique_ptr<sg::Image>> images(image_count);
+        std::exception_ptr exception;
+
+        CommandBuffer *command_buffer = nullptr;
+        std::vector<StagingRing::Allocation> recorded_allocations;
+        std::vector<size_t> recorded_images;
+        VkDeviceSize recorded_size = 0;
+        uint32_t batch_count = 0;
+
+        auto submit = [&]()
         {
-            m_Scene->GetImages().push_back(fut.get());
-        }
+            if (!command_buffer)
+                return;
 
-        auto &command_buffer = m_Device.RequestCommandBuffer();
+            command_buffer->End();
 
-        command_buffer.Begin(VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT, 0);
+            // Progressive loads hand the images of a batch to the scene once its copies executed
+            std::function<void()> finished;
+            if (m_Progressive)
+            {
+                auto batch = std::make_shared<std::vector<std::pair<size_t, std::unique_ptr<sg::Image>>>>();
+                for (auto index : recorded_images)
+                    batch->emplace_back(index, std::move(images[index]));
 
-        for (size_t image_index = 0; image_index < image_count; image_index++)
+                finished = [this, batch]()
+                { PublishImageBatch(std::move(*batch)); };
+            }
+
+            staging_ring.Submit(queue, *command_buffer, std::move(recorded_allocations), std::move(finished));
+
+            command_buffer = nullptr;
+            recorded_allocations.clear();
+            recorded_images.clear();
+            recorded_size = 0;
+            batch_count++;
+        };
+
+        for (size_t uploaded_count = 0; uploaded_count < image_count;)
         {
-            auto &image = m_Scene->GetImages().at(image_index);
+            DecodedImage decoded{};
+            bool has_decoded = false;
+
+            {
+                std::unique_lock<std::mutex> lock(decoded_mutex);
+                decoded_condition.wait(lock, [&]()
+                                       { return !decoded_images.empty() ||
+                                                (staging_ring.GetWaitingCount() > 0 && (command_buffer || staging_ring.HasPendingSubmits())); });
+
+                if (!decoded_images.empty())
+                {
+                    decoded = std::move(decoded_images.front());
+                    decoded_images.pop_front();
+                    has_decoded = true;
+                }
+            }
 
-            core::Buffer stage_buffer{m_Device,
-                                      image->GetData().size(),
-                                      VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
-                                      VMA_MEMORY_USAGE_CPU_ONLY};
+            if (!has_decoded)
+            {
+                // A decoder waits for staging memory, which recorded copies only give back once they executed
+                submit();
+                staging_ring.Retire(true);
+                continue;
+            }
 
-            stage_buffer.Update(image->GetData());
+            uploaded_count++;
 
-            UploadImageToGpu(command_buffer, stage_buffer, *image);
+            if (decoded.exception)
+            {
+                if (!exception)
+                    exception = decoded.exception;
 
-            m_TransientBuffers.push_back(std::move(stage_buffer));
-        }
+                continue;
+            }
 
-        command_buffer.End();
+            if (!command_buffer)
+            {
+                command_buffer = &m_CommandPool->RequestCommandBuffer();
+                command_buffer->Begin(VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT, 0);
+            }
+
+            UploadImageToGpu(*command_buffer, *decoded.allocation.buffer, decoded.allocation.offset, *decoded.image, decoded.data_offset);
 
-        auto &queue_family = m_Device.GetQueueFamilyByFlags(VK_QUEUE_GRAPHICS_BIT);
+            recorded_size += decoded.allocation.size;
+            recorded_allocations.push_back(decoded.allocation);
+            recorded_images.push_back(decoded.index);
+            images[decoded.index] = std::move(decoded.image);
 
-        queue_family.GetQueues()[0].Submit(command_buffer, m_Device.RequestFence());
+            // Several batches in flight keep decoding, recording and copying overlapped
+            if (recorded_size >= staging_ring.GetCapacity() / 4)
+                submit();
 
-        m_Device.GetFencePool().Wait();
-        m_Device.GetFencePool().Reset();
-        m_Device.GetCommandPool().ResetPool();
-        m_Device.WaitIdle();
+            staging_ring.Retire(false);
+        }
+
+        submit();
+        staging_ring.WaitIdle();
+        m_CommandPool->ResetPool();
 
-        m_TransientBuffers.clear();
+        // Every job already handed over its image, they only have to let go of the locals
+        job_system.Wait(decode_counter);
+
+        if (exception)
+            std::rethrow_exception(exception);
 
         auto elapsed_time = timer.Stop();
 
-        ENG_CORE_INFO("Time spent loading images: {} seconds across {} threads.", engine::ToString(elapsed_time), thread_count);
+        ENG_CORE_INFO("Time spent loading images: {} seconds across {} threads, {} upload batches, {} bytes of staging memory at peak.",
+                      engine::ToString(elapsed_time), job_system.GetWorkerCount(), batch_count, staging_ring.GetPeakUsage());
+
+        return images;
+    }
+
+    void GLTFLoader::PublishImages()
+    {
+        m_Scene->SetLoaded(true);
+
+        // Every batch of images is swapped in on its own once its copies executed
+        LoadImages();
+
+        if (m_Settings.stream_textures)
+        {
+            // The streamer finds the images through the textures, so it starts after the last swap
+            auto *device = &m_Device;
+            auto *scene = m_Scene;
+            auto texture_streaming = m_Settings.texture_streaming;
+
+            JobSystem::Get().RunOnMainThread([device, scene, texture_streaming]()
+                                             { scene->SetTextureStreamer(std::make_unique<TextureStreamer>(*device, *scene, texture_streaming)); });
+        }
+    }
+
+    void GLTFLoader::PublishImageBatch(std::vector<std::pair<size_t, std::unique_ptr<sg::Image>>> &&batch)
+    {
+        // Textures draw with the fallback image until the swap below ran on the main thread
+        std::vector<std::pair<sg::Texture *, sg::Image *>> bindings;
+        for (auto &image : batch)
+        {
+            for (size_t texture_index = 0; texture_index < m_Model.textures.size(); texture_index++)
+            {
+                if (m_Model.textures[texture_index].source == static_cast<int>(image.first))
+                    bindings.emplace_back(m_Scene->GetTextures()[texture_index].get(), image.second.get());
+            }
+        }
+
+        auto images = std::make_shared<std::vector<std::pair<size_t, std::unique_ptr<sg::Image>>>>(std::move(batch));
+        auto *scene = m_Scene;
+
+        JobSystem::Get().RunOnMainThread([scene, images, bindings]()
+                                         {
+                                             for (auto &binding : bindings)
+                                                 binding.first->SetImage(*binding.second);
+
+                                             for (auto &image : *images)
+                                                 scene->GetImages().push_back(std::move(image.second));
+                                         });
     }
 
     void GLTFLoader::LoadTextures()
     {
         auto default_sampler = CreateDefaultSampler();
 
-        for (auto &gltf_texture : m_Model.textures)
+        sg::Image *fallback_image = nullptr;
+        sg::Image *fallback_normal_image = nullptr;
+        std::vector<bool> normal_textures(m_Model.textures.size(), false);
+
+        if (m_Progressive && !m_Model.textures.empty())
+        {
+            m_Scene->GetImages().push_back(CreateFallbackImage("fallback", {255, 255, 255, 255}));
+            fallback_image = m_Scene->GetImages().back().get();
+
+            // Normal maps sample a flat normal until they are resident, white would tilt every normal
+            m_Scene->GetImages().push_back(CreateFallbackImage("fallback normal", {128, 128, 255, 255}));
+            fallback_normal_image = m_Scene->GetImages().back().get();
+
+            for (auto &gltf_material : m_Model.materials)
+            {
+                auto normal = gltf_material.additionalValues.find("normalTexture");
+                if (normal == gltf_material.additionalValues.end())
+                    continue;
+
+                auto texture_index = normal->second.TextureIndex();
+                if (texture_index >= 0 && static_cast<size_t>(texture_index) < normal_textures.size())
+                    normal_textures[texture_index] = true;
+            }
+        }
+
+        for (size_t texture_index = 0; texture_index < m_Model.textures.size(); texture_index++)
         {
+            auto &gltf_texture = m_Model.textures[texture_index];
             auto texture = ParseTexture(gltf_texture);
 
-            texture->SetImage(*m_Scene->GetImages().at(gltf_texture.source));
+            if (fallback_image)
+                texture->SetImage(normal_textures[texture_index] ? *fallback_normal_image : *fallback_image);
+            else
+                texture->SetImage(*m_Scene->GetImages().at(gltf_texture.source));
 
             if (gltf_texture.sampler >= 0 && gltf_texture.sampler < static_cast<int>(m_Scene->GetSamplers().size()))
             {
@@ -521,7 +1653,7 @@ namespace engine
             {
                 if (gltf_texture.name.empty())
                 {
-                    gltf_texture.name = m_Scene->GetImages().at(gltf_texture.source)->GetName();
+                    gltf_texture.name = m_Model.images.at(gltf_texture.source).name;
                 }
 
                 texture->SetSampler(*default_sampler);
@@ -565,83 +1697,189 @@ namespace engine
 
     void GLTFLoader::LoadMeshes()
     {
+        Timer timer;
+        timer.Start();
+
+        auto &job_system = JobSystem::Get();
+
+        // CPU phase, every primitive is extracted, converted and bounded on its own
+        std::vector<std::vector<PrimitiveData>> primitives(m_Model.meshes.size());
+        size_t primitive_count = 0;
+
+        JobCounter primitive_counter;
+
+        for (size_t mesh_index = 0; mesh_index < m_Model.meshes.size(); mesh_index++)
+        {
+            auto &gltf_primitives = m_Model.meshes[mesh_index].primitives;
+            primitives[mesh_index].resize(gltf_primitives.size());
+
+            for (size_t primitive_index = 0; primitive_index < gltf_primitives.size(); primitive_index++)
+            {
+                job_system.RunBackground(
+                    [this, &gltf_primitive = gltf_primitives[primitive_index], &primitive = primitives[mesh_index][primitive_index]]()
+                    { primitive = ProcessPrimitive(&m_Model, m_Buffers, gltf_primitive, m_Settings); },
+                    &primitive_counter);
+
+                primitive_count++;
+            }
+        }
+
+        job_system.Wait(primitive_counter);
+
+        if (m_Settings.optimize_meshes)
+        {
+            // Weighted by triangle count, as the GPU transforms the vertices
+            double triangle_count = 0.0, acmr_before = 0.0, acmr_after = 0.0;
+
+            for (auto &mesh_primitives : primitives)
+            {
+                for (auto &primitive : mesh_primitives)
+                {
+                    if (primitive.acmr_after == 0.0f)
+                        continue;
+
+                    triangle_count += primitive.index_count / 3;
+                    acmr_before += primitive.acmr_before * (primitive.index_count / 3);
+                    acmr_after += primitive.acmr_after * (primitive.index_count / 3);
+                }
+            }
+
+            if (triangle_count > 0.0)
+                ENG_CORE_INFO("Optimized {} triangles for the vertex cache, ACMR {:.3f} before and {:.3f} after.",
+                              triangle_count, acmr_before / triangle_count, acmr_after / triangle_count);
+        }
+
+        auto cpu_time = timer.Stop();
+        timer.Start();
+
+        // GPU phase, buffers are created and filled serially from the prepared data
         auto default_material = CreateDefaultMaterial();
 
-        for (auto &gltf_mesh : m_Model.meshes)
+        // Every buffer is device local, filled through batched staging copies on the transfer queue
+        UploadManager upload_manager(m_Device);
+        auto &queue_families = upload_manager.GetQueueFamilies();
+
+        auto create_buffer = [this, &queue_families](VkDeviceSize size, VkBufferUsageFlags usage)
+        {
+            return std::make_unique<core::Buffer>(m_Device, size, usage | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+                                                  VMA_MEMORY_USAGE_GPU_ONLY, 0, queue_families);
+        };
+
+        GeometryArena *arena = nullptr;
+
+        if (m_Settings.geometry_arena)
+        {
+            if (!m_Scene->GetGeometryArena())
+                m_Scene->SetGeometryArena(std::make_unique<GeometryArena>(m_Device, queue_families));
+
+            arena = m_Scene->GetGeometryArena();
+        }
+
+        for (size_t mesh_index = 0; mesh_index < m_Model.meshes.size(); mesh_index++)
         {
+            auto &gltf_mesh = m_Model.meshes[mesh_index];
+
             auto entity = ParseMesh(gltf_mesh);
             m_Scene->GetMeshes().emplace_back(std::make_unique<Entity>(entity));
 
             auto &mesh = entity.GetComponent<sg::Mesh>();
 
-            for (auto &gltf_primitive : gltf_mesh.primitives)
+            for (size_t primitive_index = 0; primitive_index < gltf_mesh.primitives.size(); primitive_index++)
             {
+                auto &gltf_primitive = gltf_mesh.primitives[primitive_index];
+                auto &primitive = primitives[mesh_index][primitive_index];
+
                 auto submesh = std::make_unique<sg::Submesh>();
+                submesh->m_VerticesCount = primitive.vertex_count;
+                submesh->m_PositionOffset = primitive.position_offset;
+                submesh->m_PositionScale = primitive.position_scale;
+
+                if (primitive.bounds.IsValid())
+                    mesh.UpdateBounds(primitive.bounds);
+
+                bool in_arena = arena && !primitive.interleaved.empty();
 
-                for (auto &attribute : gltf_primitive.attributes)
+                if (in_arena)
                 {
-                    std::string attrib_name = attribute.first;
-                    std::transform(attrib_name.begin(), attrib_name.end(), attrib_name.begin(), ::tolower);
+                    submesh->m_GeometryArena = arena;
+                    submesh->m_VertexStride = primitive.attributes.front().attribute.stride;
 
-                    auto vertex_data = GetAttributeData(&m_Model, attribute.second);
+                    submesh->m_VertexRange = arena->AllocateVertices(primitive.interleaved.size(), submesh->m_VertexStride);
+                    auto &vertex_range = arena->GetRange(submesh->m_VertexRange);
+                    upload_manager.Upload(arena->GetBuffer(submesh->m_VertexRange), vertex_range.offset, primitive.interleaved.data(), primitive.interleaved.size());
 
-                    if (attrib_name == "position")
+                    if (!primitive.positions.empty())
                     {
-                        submesh->m_VerticesCount = ToUint32_t(m_Model.accessors.at(attribute.second).count);
+                        submesh->m_PositionStride = primitive.position_stride;
+                        submesh->m_PositionRange = arena->AllocateVertices(primitive.positions.size(), primitive.position_stride);
+                        auto &position_range = arena->GetRange(submesh->m_PositionRange);
+                        upload_manager.Upload(arena->GetBuffer(submesh->m_PositionRange), position_range.offset, primitive.positions.data(), primitive.positions.size());
                     }
 
-                    core::Buffer buffer{m_Device,
-                                        vertex_data.size(),
-                                        VK_BUFFER_USAGE_VERTEX_BUFFER_BIT,
-                                        VMA_MEMORY_USAGE_GPU_TO_CPU};
-                    buffer.Update(vertex_data);
-
-                    submesh->m_VertexBuffers.insert(std::make_pair(attrib_name, std::move(buffer)));
-
-                    sg::VertexAttribute attrib;
-                    attrib.format = GetAttributeFormat(&m_Model, attribute.second);
-                    attrib.stride = ToUint32_t(GetAttributeStride(&m_Model, attribute.second));
-
-                    submesh->SetAttribute(attrib_name, attrib);
+                    for (auto &attribute : primitive.attributes)
+                        submesh->SetAttribute(attribute.name, attribute.attribute);
                 }
-
-                if (gltf_primitive.indices >= 0)
+                else if (!primitive.interleaved.empty())
                 {
-                    submesh->m_VertexIndices = ToUint32_t(GetAttributeSize(&m_Model, gltf_primitive.indices));
+                    submesh->m_InterleavedBuffer = create_buffer(primitive.interleaved.size(), VK_BUFFER_USAGE_VERTEX_BUFFER_BIT);
+                    upload_manager.Upload(*submesh->m_InterleavedBuffer, 0, primitive.interleaved.data(), primitive.interleaved.size());
 
-                    auto format = GetAttributeFormat(&m_Model, gltf_primitive.indices);
-
-                    auto vertex_data = GetAttributeData(&m_Model, gltf_primitive.indices);
-                    auto index_data = GetAttributeData(&m_Model, gltf_primitive.indices);
+                    if (!primitive.positions.empty())
+                    {
+                        submesh->m_PositionBuffer = create_buffer(primitive.positions.size(), VK_BUFFER_USAGE_VERTEX_BUFFER_BIT);
+                        upload_manager.Upload(*submesh->m_PositionBuffer, 0, primitive.positions.data(), primitive.positions.size());
+                        submesh->m_PositionStride = primitive.position_stride;
+                    }
 
-                    switch (format)
+                    for (auto &attribute : primitive.attributes)
+                        submesh->SetAttribute(attribute.name, attribute.attribute);
+                }
+                else
+                {
+                    for (auto &attribute : primitive.attributes)
                     {
-                    case VK_FORMAT_R8_UINT:
-                        // Converts uint8 data into uint16 data, still represented by a uint8 vector
-                        index_data = ConvertUnderlyingDataStride(index_data, 1, 2);
-                        submesh->m_IndexType = VK_INDEX_TYPE_UINT16;
-                        break;
-                    case VK_FORMAT_R16_UINT:
-                        submesh->m_IndexType = VK_INDEX_TYPE_UINT16;
-                        break;
-                    case VK_FORMAT_R32_UINT:
-                        submesh->m_IndexType = VK_INDEX_TYPE_UINT32;
-                        break;
-                    default:
-                        ENG_CORE_ERROR("gltf primitive has invalid format type");
-                        break;
+                        core::Buffer buffer{m_Device,
+                                            attribute.data.size,
+                                            VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+                                            VMA_MEMORY_USAGE_GPU_ONLY,
+                                            0,
+                                            queue_families};
+
+                        // Recorded copies refer to the buffer in the map, which keeps its address
+                        auto &vertex_buffer = submesh->m_VertexBuffers.insert(std::make_pair(attribute.name, std::move(buffer))).first->second;
+                        upload_manager.Upload(vertex_buffer, 0, attribute.data.data, attribute.data.size);
+
+                        submesh->SetAttribute(attribute.name, attribute.attribute);
                     }
+                }
 
-                    submesh->m_IndexBuffer = std::make_unique<core::Buffer>(m_Device,
-                                                                            index_data.size(),
-                                                                            VK_BUFFER_USAGE_INDEX_BUFFER_BIT,
-                                                                            VMA_MEMORY_USAGE_GPU_TO_CPU);
+                if (primitive.index_count > 0 && in_arena)
+                {
+                    submesh->m_VertexIndices = primitive.index_count;
+                    submesh->m_IndexType = primitive.index_type;
 
-                    submesh->m_IndexBuffer->Update(index_data);
+                    uint32_t index_size = primitive.index_type == VK_INDEX_TYPE_UINT32 ? 4 : 2;
+                    submesh->m_IndexRange = arena->AllocateIndices(primitive.index_data.size, index_size);
+                    auto &index_range = arena->GetRange(submesh->m_IndexRange);
+                    upload_manager.Upload(arena->GetBuffer(submesh->m_IndexRange), index_range.offset, primitive.index_data.data, primitive.index_data.size);
                 }
-                else
+                else if (primitive.index_count > 0)
+                {
+                    submesh->m_VertexIndices = primitive.index_count;
+                    submesh->m_IndexType = primitive.index_type;
+
+                    submesh->m_IndexBuffer = create_buffer(primitive.index_data.size, VK_BUFFER_USAGE_INDEX_BUFFER_BIT);
+                    upload_manager.Upload(*submesh->m_IndexBuffer, 0, primitive.index_data.data, primitive.index_data.size);
+                }
+
+                if (!primitive.skin_vertices.empty())
                 {
-                    submesh->m_VerticesCount = ToUint32_t(GetAttributeSize(&m_Model, gltf_primitive.attributes.at("POSITION")));
+                    submesh->m_SkinVertices = std::move(primitive.skin_vertices);
+
+                    auto size = submesh->m_SkinVertices.size() * sizeof(sg::SkinVertex);
+
+                    submesh->m_SkinVertexBuffer = create_buffer(size, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT);
+                    upload_manager.Upload(*submesh->m_SkinVertexBuffer, 0, reinterpret_cast<const uint8_t *>(submesh->m_SkinVertices.data()), size);
                 }
 
                 if (gltf_primitive.material < 0)
@@ -658,11 +1896,42 @@ namespace engine
             }
         }
 
-        m_Device.GetFencePool().Wait();
-        m_Device.GetFencePool().Reset();
-        m_Device.GetCommandPool().ResetPool();
+        upload_manager.Wait();
+
+        auto gpu_time = timer.Stop();
+
+        ENG_CORE_INFO("Time spent loading meshes: {} seconds processing {} primitives across {} threads, {} seconds creating buffers.",
+                      engine::ToString(cpu_time), primitive_count, job_system.GetWorkerCount(), engine::ToString(gpu_time));
+    }
+
+    void GLTFLoader::LoadSkins()
+    {
+        for (size_t node_index = 0; node_index < m_Model.nodes.size(); ++node_index)
+        {
+            auto &gltf_node = m_Model.nodes[node_index];
+            auto &entity = m_NodeEntities[node_index];
+
+            if (gltf_node.skin < 0 || !entity || !entity.HasComponent<sg::Mesh>())
+                continue;
+
+            auto &gltf_skin = m_Model.skins.at(gltf_node.skin);
+
+            std::vector<float> inverse_bind_matrices;
+            if (gltf_skin.inverseBindMatrices >= 0)
+                inverse_bind_matrices = GetAccessorFloats(&m_Model, m_Buffers, gltf_skin.inverseBindMatrices, 16);
+
+            auto &skin = entity.AddComponent<sg::Skin>(gltf_skin.name);
+
+            for (size_t joint_index = 0; joint_index < gltf_skin.joints.size(); joint_index++)
+            {
+                glm::mat4 inverse_bind_matrix{1.0f};
+                if (inverse_bind_matrices.size() >= (joint_index + 1) * 16)
+                    inverse_bind_matrix = glm::make_mat4(&inverse_bind_matrices[joint_index * 16]);
 
-        m_TransientBuffers.clear();
+                auto &joint = m_NodeEntities.at(gltf_skin.joints[joint_index]);
+                skin.AddJoint(joint ? joint.GetHandle() : entt::null, inverse_bind_matrix);
+            }
+        }
     }
 
     void GLTFLoader::LoadCameras()
@@ -676,6 +1945,73 @@ namespace engine
 
     void GLTFLoader::LoadAnimations()
     {
+        auto &animation_system = m_Scene->GetAnimationSystem();
+
+        for (auto &gltf_animation : m_Model.animations)
+        {
+            std::vector<AnimationTrack> tracks;
+            tracks.reserve(gltf_animation.channels.size());
+
+            for (auto &gltf_channel : gltf_animation.channels)
+            {
+                if (gltf_channel.target_node < 0)
+                    continue;
+
+                AnimationTrack track{};
+
+                if (gltf_channel.target_path == "translation")
+                    track.path = AnimationPath::Translation;
+                else if (gltf_channel.target_path == "rotation")
+                    track.path = AnimationPath::Rotation;
+                else if (gltf_channel.target_path == "scale")
+                    track.path = AnimationPath::Scale;
+                else
+                {
+                    ENG_CORE_WARN("Unsupported glTF animation path: {}", gltf_channel.target_path);
+                    continue;
+                }
+
+                auto &target = m_NodeEntities.at(gltf_channel.target_node);
+                if (!target)
+                {
+                    ENG_CORE_WARN("glTF animation {} targets a shared node, skipping channel", gltf_animation.name);
+                    continue;
+                }
+
+                track.target = target;
+
+                auto &gltf_sampler = gltf_animation.samplers.at(gltf_channel.sampler);
+
+                if (gltf_sampler.interpolation == "STEP")
+                    track.interpolation = AnimationInterpolation::Step;
+                else if (gltf_sampler.interpolation == "CUBICSPLINE")
+                    track.interpolation = AnimationInterpolation::CubicSpline;
+                else
+                    track.interpolation = AnimationInterpolation::Linear;
+
+                track.times = GetAccessorFloats(&m_Model, m_Buffers, gltf_sampler.input, 1);
+
+                uint32_t components = track.path == AnimationPath::Rotation ? 4 : 3;
+                auto values = GetAccessorFloats(&m_Model, m_Buffers, gltf_sampler.output, components);
+
+                track.values.resize(values.size() / components);
+                for (size_t i = 0; i < track.values.size(); i++)
+                {
+                    auto *value = &values[i * components];
+                    track.values[i] = glm::vec4(value[0], value[1], value[2], components == 4 ? value[3] : 0.0f);
+                }
+
+                tracks.push_back(std::move(track));
+            }
+
+            auto clip = animation_system.AddClip(gltf_animation.name, tracks);
+
+            // Clips usually animate the same nodes, playing all of them at once lets the last one win
+            if (m_Settings.play_first_animation && &gltf_animation == &m_Model.animations.front())
+                animation_system.Play(clip);
+
+            ENG_CORE_TRACE("Loaded gltf animation {} with {} channels", gltf_animation.name, tracks.size());
+        }
     }
 
     void GLTFLoader::LoadScenes(int scene_index)
@@ -693,11 +2029,13 @@ namespace engine
         if (!gltf_scene)
             throw std::runtime_error("Couldn't determine which scene to load!");
 
-        m_Scene = std::make_unique<Scene>(gltf_scene->name);
+        m_Scene->SetName(gltf_scene->name);
     }
 
     void GLTFLoader::LoadNodes()
     {
+        m_NodeEntities.assign(m_Model.nodes.size(), Entity{});
+
         for (size_t node_index = 0; node_index < m_Model.nodes.size(); ++node_index)
         {
             auto gltf_node = m_Model.nodes[node_index];
@@ -705,14 +2043,6 @@ namespace engine
             Entity entity;
             bool identified = false;
 
-            if (gltf_node.mesh >= 0)
-            {
-                /* if (gltf_node.mesh == 361)
-                    ENG_CORE_ERROR("loaded the same node"); */
-                entity = *m_Scene->GetMeshes().at(gltf_node.mesh);
-                identified = true;
-            }
-
             if (gltf_node.camera >= 0)
             {
                 entity = *m_Scene->GetCameras().at(gltf_node.camera);
@@ -731,9 +2061,40 @@ namespace engine
                 entity = m_Scene->CreateEntity();
             }
 
+            // A camera or light referenced by several nodes keeps the first node's transform,
+            // so it can't be parented under the other nodes as well
+            bool shared = entity.HasComponent<sg::Transform>();
+
+            // Every node gets its own copy of the mesh component, the submeshes stay shared
+            // so repeated meshes end up as instances of the same draw
+            if (gltf_node.mesh >= 0 && !shared)
+            {
+                auto &prototype = m_Scene->GetMeshes().at(gltf_node.mesh)->GetComponent<sg::Mesh>();
+                entity.AddComponent<sg::Mesh>(prototype);
+            }
+
             ParseNode(gltf_node, entity);
 
             ENG_ASSERT(entity.HasComponent<sg::Transform>());
+
+            if (!shared)
+                m_NodeEntities[node_index] = entity;
+        }
+
+        auto &transform_system = m_Scene->GetTransformSystem();
+
+        for (size_t node_index = 0; node_index < m_Model.nodes.size(); ++node_index)
+        {
+            auto &parent = m_NodeEntities[node_index];
+            if (!parent)
+                continue;
+
+            for (auto child_index : m_Model.nodes[node_index].children)
+            {
+                auto &child = m_NodeEntities.at(child_index);
+                if (child)
+                    transform_system.SetParent(child, parent);
+            }
         }
     }
 
@@ -880,8 +2241,10 @@ namespace engine
         return std::make_unique<sg::Sampler>(name, std::move(vk_sampler));
     }
 
-    std::unique_ptr<sg::Image> GLTFLoader::ParseImage(tinygltf::Image &gltf_image) const
+    std::unique_ptr<sg::Image> GLTFLoader::ParseImage(tinygltf::Image &gltf_image, bool &generate_mipmaps) const
     {
+        generate_mipmaps = false;
+
         std::unique_ptr<sg::Image> image{nullptr};
         auto image_uri = m_ModelPath / gltf_image.uri;
 
@@ -893,10 +2256,27 @@ namespace engine
             std::vector<sg::Mipmap> mipmaps{mipmap};
             image = std::make_unique<sg::Image>(gltf_image.name, std::move(gltf_image.image), std::move(mipmaps));
         }
+        else if (gltf_image.bufferView >= 0)
+        {
+            // Image stored in a buffer view, the image loader callback leaves it encoded
+            auto &buffer_view = m_Model.bufferViews.at(gltf_image.bufferView);
+            auto &buffer = m_Buffers.at(buffer_view.buffer);
+
+            if (buffer_view.byteOffset + buffer_view.byteLength > buffer.size)
+                throw std::runtime_error("Image buffer view of " + gltf_image.name + " exceeds its buffer");
+
+            const uint8_t *begin = buffer.data + buffer_view.byteOffset;
+            std::vector<uint8_t> data(begin, begin + buffer_view.byteLength);
+
+            if (gltf_image.mimeType == "image/ktx2")
+                image = std::make_unique<sg::Ktx>(gltf_image.name, data, m_BasisFormats);
+            else
+                image = std::make_unique<sg::Stb>(gltf_image.name, data);
+        }
         else
         {
             // Load image from uri
-            image = sg::Image::Load(gltf_image.name, image_uri);
+            image = sg::Image::Load(gltf_image.name, image_uri, m_BasisFormats);
         }
 
         // TODO: astc old commit
@@ -905,17 +2285,52 @@ namespace engine
         {
             if (!m_Device.IsImageFormatSupported(image->GetFormat()))
             {
-                ENG_CORE_WARN("ASTC not supported: decoding {}", image_uri.generic_string());
-                image = std::make_unique<sg::Astc>(*image);
-                image->GenerateMipmaps();
+                if (!m_TranscodeFormats.empty())
+                {
+                    // The transcoded image comes with its whole mipmap chain
+                    ENG_CORE_WARN("ASTC not supported: transcoding {}", image_uri.generic_string());
+                    image = std::make_unique<sg::Transcoded>(*image, m_TranscodeFormats, m_TranscodeCacheDirectory);
+                }
+                else
+                {
+                    ENG_CORE_WARN("ASTC not supported: decoding {}", image_uri.generic_string());
+                    image = std::make_unique<sg::Astc>(*image);
+                    generate_mipmaps = true;
+                }
             }
         }
 
-        image->CreateVkImage(m_Device);
-
         return image;
     }
 
+    std::vector<bool> GLTFLoader::GetSrgbImages() const
+    {
+        std::vector<bool> srgb_images(m_Model.images.size(), false);
+
+        auto add_texture = [this, &srgb_images](int texture_index)
+        {
+            if (texture_index < 0 || static_cast<size_t>(texture_index) >= m_Model.textures.size())
+                return;
+
+            auto source = m_Model.textures[texture_index].source;
+            if (source >= 0 && static_cast<size_t>(source) < srgb_images.size())
+                srgb_images[source] = true;
+        };
+
+        for (auto &gltf_material : m_Model.materials)
+        {
+            auto base_color = gltf_material.values.find("baseColorTexture");
+            if (base_color != gltf_material.values.end())
+                add_texture(base_color->second.TextureIndex());
+
+            auto emissive = gltf_material.additionalValues.find("emissiveTexture");
+            if (emissive != gltf_material.additionalValues.end())
+                add_texture(emissive->second.TextureIndex());
+        }
+
+        return srgb_images;
+    }
+
     std::unique_ptr<sg::Texture> GLTFLoader::ParseTexture(const tinygltf::Texture &gltf_texture) const
     {
         return std::make_unique<sg::Texture>(gltf_texture.name);
@@ -923,9 +2338,9 @@ namespace engine
 
     bool GLTFLoader::IsExtensionEnabled(const std::string &requested_extension)
     {
-        auto it = m_SupportedExtensions.find(requested_extension);
+        auto it = m_Extensions.find(requested_extension);
 
-        if (it != m_SupportedExtensions.end())
+        if (it != m_Extensions.end())
             return it->second;
         else
             return false;
@@ -1100,4 +2515,30 @@ namespace engine
         tinygltf::Material gltf_material;
         return ParseMaterial(gltf_material);
     }
+
+    std::unique_ptr<sg::Image> GLTFLoader::CreateFallbackImage(const std::string &name, std::vector<uint8_t> &&texel)
+    {
+        // A single R8G8B8A8_UNORM level
+        auto image = std::make_unique<sg::Image>(name, std::move(texel), std::vector<sg::Mipmap>{{0, 0, {1, 1, 1}}});
+        image->CreateVkImage(m_Device);
+
+        core::Buffer staging_buffer(m_Device, image->GetData().size(), VK_BUFFER_USAGE_TRANSFER_SRC_BIT, VMA_MEMORY_USAGE_CPU_ONLY);
+        staging_buffer.Update(image->GetData());
+
+        auto &command_buffer = m_CommandPool->RequestCommandBuffer();
+        command_buffer.Begin(VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT, 0);
+        UploadImageToGpu(command_buffer, staging_buffer, 0, *image);
+        command_buffer.End();
+
+        image->ClearData();
+
+        FencePool fence_pool(m_Device);
+        auto &queue = m_Device.GetQueueFamilyByFlags(VK_QUEUE_GRAPHICS_BIT).GetQueues()[0];
+        queue.Submit(command_buffer, fence_pool.RequestFence());
+
+        fence_pool.Wait();
+        m_CommandPool->ResetPool();
+
+        return image;
+    }
 }
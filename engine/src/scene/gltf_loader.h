@@ -8,11 +8,13 @@ ENG_DISABLE_WARNINGS()
 ENG_ENABLE_WARNINGS()
 
 #include "scene/entity.h"
+#include "vulkan_api/texture_streamer.h"
 
 namespace engine
 {
     class Device;
     class Scene;
+    class CommandPool;
 
     namespace sg
     {
@@ -32,20 +34,83 @@ namespace engine
         class Buffer;
     }
 
+    namespace fs
+    {
+        class MappedFile;
+    }
+
+    struct GLTFLoaderSettings
+    {
+        // Map external .bin buffers and the GLB binary chunk instead of letting tinygltf copy them into memory
+        bool map_buffers{true};
+        // Pack the attributes of a primitive into one vertex buffer, skinned primitives stay split
+        bool interleave_vertices{true};
+        // Place interleaved vertices and indices in the scene's device local geometry arena
+        bool geometry_arena{true};
+        // Reorder the triangles of indexed triangle lists for the post transform cache and overdraw,
+        // and interleaved vertices in the order they are fetched
+        bool optimize_meshes{true};
+        // Store interleaved positions as 16 bit values relative to the primitive bounds, normals octahedral
+        // encoded and texture coordinates as half floats. Tangents are dropped, no shader variant reads them
+        bool quantize_vertices{true};
+        // Encode ASTC images the device can't sample to BC or ETC2 instead of decompressing them to RGBA8
+        bool transcode_textures{true};
+        // Keep transcoded images in the cache directory, keyed by a hash of the source image
+        bool cache_transcoded_textures{true};
+        // Staging memory decoded images are written to, uploads are submitted in batches as it fills up
+        VkDeviceSize texture_staging_budget{128 * 1024 * 1024};
+        // Create only the smallest levels of 2D images and stream the finer ones in by their on screen size.
+        // Off by default, the whole chain of a streamed image stays in host memory for the life of the scene
+        bool stream_textures{false};
+        TextureStreamerSettings texture_streaming{};
+        // Loop the first animation of the file, the other clips are left to the caller through the animation system
+        bool play_first_animation{true};
+    };
+
+    // Bytes inside a glTF buffer, owned by tinygltf or by a mapped file
+    struct GLTFSpan
+    {
+        const uint8_t *data{nullptr};
+        size_t size{0};
+    };
+
     class GLTFLoader
     {
     public:
-        GLTFLoader(Device &device);
+        GLTFLoader(Device &device, const GLTFLoaderSettings &settings = {});
         ~GLTFLoader();
 
         std::unique_ptr<Scene> ReadSceneFromFile(const std::string &file_name, int scene_index = -1);
+        // Loads into an existing scene, meant for a background job while the scene is not loaded. The scene is marked
+        // loaded as soon as its meshes are resident, drawn with fallback textures until the images were decoded
+        bool ReadSceneFromFile(const std::string &file_name, Scene &scene, int scene_index = -1);
 
     private:
         Device &m_Device;
+        GLTFLoaderSettings m_Settings;
         tinygltf::Model m_Model;
         std::filesystem::path m_ModelPath;
         static std::unordered_map<std::string, bool> m_SupportedExtensions;
-        std::vector<core::Buffer> m_TransientBuffers;
+        // Copy of the supported extensions enabled for this model, loaders may run concurrently
+        std::unordered_map<std::string, bool> m_Extensions;
+        // Entity created for every glTF node, null for nodes sharing another node's entity
+        std::vector<Entity> m_NodeEntities;
+        // Data of every glTF buffer, valid until the scene finished loading
+        std::vector<GLTFSpan> m_Buffers;
+        std::vector<std::unique_ptr<fs::MappedFile>> m_MappedFiles;
+        // Formats Basis Universal KTX2 images are transcoded to
+        std::vector<VkFormat> m_BasisFormats;
+        // Formats unsupported ASTC images are transcoded to, empty to decompress them instead
+        std::vector<VkFormat> m_TranscodeFormats;
+        std::filesystem::path m_TranscodeCacheDirectory;
+
+        // Own pool for image uploads, the device's pools belong to the main thread
+        std::unique_ptr<CommandPool> m_CommandPool;
+        // Set when the scene is published before its images are loaded
+        bool m_Progressive{false};
+
+        bool ReadModel(const std::string &file_name);
+        bool ReadMappedModel(const std::filesystem::path &gltf_file, bool binary, std::string &err, std::string &warn);
 
         void LoadScene(int scene_index = -1);
 
@@ -53,19 +118,26 @@ namespace engine
         void LoadScenes(int scene_index);
         void LoadLights();
         void LoadSamplers();
-        void LoadImages();
+        // Progressive loads publish the images batch by batch instead of returning them
+        std::vector<std::unique_ptr<sg::Image>> LoadImages();
+        void PublishImages();
+        void PublishImageBatch(std::vector<std::pair<size_t, std::unique_ptr<sg::Image>>> &&batch);
         void LoadTextures();
         void LoadMaterials();
         void LoadMeshes();
         void LoadCameras();
         void LoadAnimations();
         void LoadNodes();
+        void LoadSkins();
 
-        std::unique_ptr<Scene> m_Scene;
+        Scene *m_Scene{nullptr};
 
         std::vector<std::unique_ptr<Entity>> ParseKHRLightsPunctual();
         std::unique_ptr<sg::Sampler> ParseSampler(const tinygltf::Sampler &gltf_sampler) const;
-        std::unique_ptr<sg::Image> ParseImage(tinygltf::Image &gltf_image) const;
+        // Decodes the image, the mipmaps of decoded ASTC images are left to be generated into staging memory
+        std::unique_ptr<sg::Image> ParseImage(tinygltf::Image &gltf_image, bool &generate_mipmaps) const;
+        // Images the materials sample as colors, base color and emissive textures, the others hold linear data
+        std::vector<bool> GetSrgbImages() const;
         std::unique_ptr<sg::Texture> ParseTexture(const tinygltf::Texture &gltf_texture) const;
         std::unique_ptr<sg::PBRMaterial> ParseMaterial(const tinygltf::Material &gltf_material) const;
         Entity ParseMesh(const tinygltf::Mesh &gltf_mesh) const;
@@ -75,5 +147,7 @@ namespace engine
         bool IsExtensionEnabled(const std::string &requested_extension);
         std::unique_ptr<sg::Sampler> CreateDefaultSampler();
         std::unique_ptr<sg::PBRMaterial> CreateDefaultMaterial();
+        // 1x1 RGBA8 image textures point at until their image is resident
+        std::unique_ptr<sg::Image> CreateFallbackImage(const std::string &name, std::vector<uint8_t> &&texel);
     };
 }
@@ -0,0 +1,332 @@
+#include "scene/mesh_optimizer.h"
+
+#include "common/glm.h"
+
+namespace engine
+{
+    namespace sg
+    {
+        namespace
+        {
+            constexpr uint32_t NO_VERTEX = std::numeric_limits<uint32_t>::max();
+
+            // A cluster ends once its own ACMR is within this factor of the whole mesh's
+            constexpr float SOFT_BOUNDARY_FACTOR = 1.05f;
+
+            // Timestamps of a FIFO cache, a vertex is cached while fewer than cache_size vertices were added after it
+            class CacheSimulation
+            {
+            public:
+                CacheSimulation(size_t vertex_count, uint32_t cache_size)
+                    : m_Timestamps(vertex_count, 0), m_CacheSize(cache_size), m_Time(cache_size + 1)
+                {
+                }
+
+                bool Access(uint32_t vertex)
+                {
+                    if (m_Time - m_Timestamps[vertex] <= m_CacheSize)
+                        return true;
+
+                    m_Timestamps[vertex] = m_Time++;
+                    return false;
+                }
+
+                void Clear() { m_Time += m_CacheSize + 1; }
+
+            private:
+                std::vector<uint32_t> m_Timestamps;
+                uint32_t m_CacheSize;
+                uint32_t m_Time;
+            };
+
+            void SplitSoftBoundaries(const std::vector<uint32_t> &indices, size_t vertex_count, std::vector<uint32_t> &clusters, uint32_t cache_size)
+            {
+                auto triangle_count = ToUint32_t(indices.size() / 3);
+                auto threshold = ComputeACMR(indices, vertex_count, cache_size) * SOFT_BOUNDARY_FACTOR;
+
+                CacheSimulation cache(vertex_count, cache_size);
+                std::vector<uint32_t> result;
+
+                for (size_t cluster = 0; cluster < clusters.size(); cluster++)
+                {
+                    auto end = cluster + 1 < clusters.size() ? clusters[cluster + 1] : triangle_count;
+                    auto first = clusters[cluster];
+                    uint32_t misses = 0;
+
+                    cache.Clear();
+                    result.push_back(first);
+
+                    for (auto triangle = first; triangle < end; triangle++)
+                    {
+                        for (uint32_t corner = 0; corner < 3; corner++)
+                            misses += cache.Access(indices[triangle * 3 + corner]) ? 0 : 1;
+
+                        if (triangle + 1 < end && misses <= threshold * static_cast<float>(triangle + 1 - first))
+                        {
+                            first = triangle + 1;
+                            misses = 0;
+
+                            cache.Clear();
+                            result.push_back(first);
+                        }
+                    }
+                }
+
+                clusters.swap(result);
+            }
+        }
+
+        float ComputeACMR(const std::vector<uint32_t> &indices, size_t vertex_count, uint32_t cache_size)
+        {
+            if (indices.size() < 3)
+                return 0.0f;
+
+            CacheSimulation cache(vertex_count, cache_size);
+            uint32_t misses = 0;
+
+            for (auto index : indices)
+                misses += cache.Access(index) ? 0 : 1;
+
+            return static_cast<float>(misses) / static_cast<float>(indices.size() / 3);
+        }
+
+        void OptimizeVertexCache(std::vector<uint32_t> &indices, size_t vertex_count, std::vector<uint32_t> &clusters, uint32_t cache_size)
+        {
+            clusters.clear();
+
+            auto triangle_count = indices.size() / 3;
+            if (triangle_count == 0)
+                return;
+
+            // Triangles using every vertex, live counts the ones not emitted yet
+            std::vector<uint32_t> live(vertex_count, 0);
+            for (auto index : indices)
+                live[index]++;
+
+            std::vector<uint32_t> offsets(vertex_count + 1, 0);
+            for (size_t vertex = 0; vertex < vertex_count; vertex++)
+                offsets[vertex + 1] = offsets[vertex] + live[vertex];
+
+            std::vector<uint32_t> adjacency(indices.size());
+            std::vector<uint32_t> fill(offsets.begin(), offsets.end() - 1);
+
+            for (size_t triangle = 0; triangle < triangle_count; triangle++)
+            {
+                for (size_t corner = 0; corner < 3; corner++)
+                    adjacency[fill[indices[triangle * 3 + corner]]++] = ToUint32_t(triangle);
+            }
+
+            std::vector<uint32_t> cache_time(vertex_count, 0);
+            std::vector<uint8_t> emitted(triangle_count, 0);
+            std::vector<uint32_t> dead_end;
+            std::vector<uint32_t> candidates;
+            std::vector<uint32_t> result;
+            result.reserve(indices.size());
+
+            uint32_t time = cache_size + 1;
+            uint32_t cursor = 0;
+
+            // Recently used vertices with triangles left first, then the next one in input order
+            auto skip_dead_end = [&]()
+            {
+                while (!dead_end.empty())
+                {
+                    auto vertex = dead_end.back();
+                    dead_end.pop_back();
+
+                    if (live[vertex] > 0)
+                        return vertex;
+                }
+
+                for (; cursor < vertex_count; cursor++)
+                {
+                    if (live[cursor] > 0)
+                        return cursor;
+                }
+
+                return NO_VERTEX;
+            };
+
+            auto fanning = skip_dead_end();
+            bool new_cluster = true;
+
+            while (fanning != NO_VERTEX)
+            {
+                // Jumps to a vertex outside of the cache are the hard boundaries overdraw ordering may reorder at
+                if (new_cluster)
+                {
+                    clusters.push_back(ToUint32_t(result.size() / 3));
+                    new_cluster = false;
+                }
+
+                candidates.clear();
+
+                for (auto adjacent = offsets[fanning]; adjacent < offsets[fanning + 1]; adjacent++)
+                {
+                    auto triangle = adjacency[adjacent];
+                    if (emitted[triangle])
+                        continue;
+
+                    emitted[triangle] = 1;
+
+                    for (size_t corner = 0; corner < 3; corner++)
+                    {
+                        auto vertex = indices[triangle * 3 + corner];
+
+                        result.push_back(vertex);
+                        dead_end.push_back(vertex);
+                        candidates.push_back(vertex);
+                        live[vertex]--;
+
+                        if (time - cache_time[vertex] > cache_size)
+                            cache_time[vertex] = time++;
+                    }
+                }
+
+                // Prefer the oldest candidate that stays cached while its remaining triangles are fanned
+                auto next = NO_VERTEX;
+                int64_t best_priority = -1;
+
+                for (auto vertex : candidates)
+                {
+                    if (live[vertex] == 0)
+                        continue;
+
+                    int64_t priority = 0;
+                    if (time - cache_time[vertex] + 2 * live[vertex] <= cache_size)
+                        priority = time - cache_time[vertex];
+
+                    if (priority > best_priority)
+                    {
+                        best_priority = priority;
+                        next = vertex;
+                    }
+                }
+
+                if (next == NO_VERTEX)
+                {
+                    next = skip_dead_end();
+                    new_cluster = true;
+                }
+
+                fanning = next;
+            }
+
+            indices.swap(result);
+
+            SplitSoftBoundaries(indices, vertex_count, clusters, cache_size);
+        }
+
+        void OptimizeOverdraw(std::vector<uint32_t> &indices, const std::vector<uint32_t> &clusters,
+                              const uint8_t *positions, size_t position_stride, size_t vertex_count)
+        {
+            auto triangle_count = ToUint32_t(indices.size() / 3);
+            if (clusters.size() < 2)
+                return;
+
+            auto position = [positions, position_stride](uint32_t vertex)
+            {
+                glm::vec3 result;
+                std::memcpy(&result, positions + vertex * position_stride, sizeof(glm::vec3));
+                return result;
+            };
+
+            struct Cluster
+            {
+                uint32_t first;
+                uint32_t end;
+                glm::vec3 centroid{0.0f};
+                glm::vec3 normal{0.0f};
+                float area{0.0f};
+                float sort_key{0.0f};
+            };
+
+            std::vector<Cluster> sorted_clusters(clusters.size());
+            glm::vec3 mesh_centroid{0.0f};
+            float mesh_area = 0.0f;
+
+            for (size_t cluster_index = 0; cluster_index < clusters.size(); cluster_index++)
+            {
+                auto &cluster = sorted_clusters[cluster_index];
+                cluster.first = clusters[cluster_index];
+                cluster.end = cluster_index + 1 < clusters.size() ? clusters[cluster_index + 1] : triangle_count;
+
+                for (auto triangle = cluster.first; triangle < cluster.end; triangle++)
+                {
+                    auto a = position(indices[triangle * 3 + 0]);
+                    auto b = position(indices[triangle * 3 + 1]);
+                    auto c = position(indices[triangle * 3 + 2]);
+
+                    // Twice the area weighted normal
+                    auto normal = glm::cross(b - a, c - a);
+                    auto area = glm::length(normal);
+
+                    cluster.centroid += (a + b + c) * (area / 3.0f);
+                    cluster.normal += normal;
+                    cluster.area += area;
+                }
+
+                mesh_centroid += cluster.centroid;
+                mesh_area += cluster.area;
+
+                if (cluster.area > 0.0f)
+                    cluster.centroid /= cluster.area;
+            }
+
+            if (mesh_area <= 0.0f)
+                return;
+
+            mesh_centroid /= mesh_area;
+
+            // Clusters far out along their normal are the likely occluders of the rest
+            for (auto &cluster : sorted_clusters)
+            {
+                auto length = glm::length(cluster.normal);
+                cluster.sort_key = length > 0.0f ? glm::dot(cluster.centroid - mesh_centroid, cluster.normal / length) : 0.0f;
+            }
+
+            std::stable_sort(sorted_clusters.begin(), sorted_clusters.end(),
+                             [](const Cluster &a, const Cluster &b)
+                             { return a.sort_key > b.sort_key; });
+
+            std::vector<uint32_t> result;
+            result.reserve(indices.size());
+
+            for (auto &cluster : sorted_clusters)
+                result.insert(result.end(), indices.begin() + cluster.first * 3, indices.begin() + cluster.end * 3);
+
+            indices.swap(result);
+        }
+
+        void OptimizeVertexFetch(std::vector<uint32_t> &indices, size_t vertex_count, std::vector<uint32_t> &remap)
+        {
+            remap.assign(vertex_count, NO_VERTEX);
+            uint32_t next_vertex = 0;
+
+            for (auto &index : indices)
+            {
+                if (remap[index] == NO_VERTEX)
+                    remap[index] = next_vertex++;
+
+                index = remap[index];
+            }
+
+            // Unreferenced vertices keep their relative order at the end, the vertex count doesn't change
+            for (auto &new_index : remap)
+            {
+                if (new_index == NO_VERTEX)
+                    new_index = next_vertex++;
+            }
+        }
+
+        void RemapVertices(std::vector<uint8_t> &vertices, size_t stride, const std::vector<uint32_t> &remap)
+        {
+            std::vector<uint8_t> result(vertices.size());
+
+            for (size_t vertex = 0; vertex < remap.size(); vertex++)
+                std::memcpy(result.data() + remap[vertex] * stride, vertices.data() + vertex * stride, stride);
+
+            vertices.swap(result);
+        }
+    }
+}
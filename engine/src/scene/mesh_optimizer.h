@@ -0,0 +1,29 @@
+#pragma once
+
+namespace engine
+{
+    namespace sg
+    {
+        // Post transform cache size the reordering targets, small enough to suit every current GPU
+        constexpr uint32_t VERTEX_CACHE_SIZE = 16;
+
+        // Average count of vertices transformed per triangle with a FIFO cache, 0.5 at best and 3 at worst
+        float ComputeACMR(const std::vector<uint32_t> &indices, size_t vertex_count, uint32_t cache_size = VERTEX_CACHE_SIZE);
+
+        // Tipsify, Sander et al. 2007. Reorders triangles for post transform cache hits and writes the first
+        // triangle of every cluster that can be drawn in any order without losing much of the cache efficiency
+        void OptimizeVertexCache(std::vector<uint32_t> &indices, size_t vertex_count, std::vector<uint32_t> &clusters,
+                                 uint32_t cache_size = VERTEX_CACHE_SIZE);
+
+        // Sorts the clusters so the ones likely to occlude the rest of the mesh are drawn first, view independently.
+        // Positions are read as three floats at the given stride
+        void OptimizeOverdraw(std::vector<uint32_t> &indices, const std::vector<uint32_t> &clusters,
+                              const uint8_t *positions, size_t position_stride, size_t vertex_count);
+
+        // Renumbers vertices in the order the indices first use them, remap holds the new index of every old vertex
+        void OptimizeVertexFetch(std::vector<uint32_t> &indices, size_t vertex_count, std::vector<uint32_t> &remap);
+
+        // Moves every element of size stride to its remapped position
+        void RemapVertices(std::vector<uint8_t> &vertices, size_t stride, const std::vector<uint32_t> &remap);
+    }
+}
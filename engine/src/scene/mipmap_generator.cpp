@@ -0,0 +1,265 @@
+#include "scene/mipmap_generator.h"
+
+#include "common/simd.h"
+#include "core/job_system.h"
+
+namespace engine
+{
+    namespace sg
+    {
+        namespace
+        {
+            constexpr uint32_t CHANNELS = 4;
+
+            // Destination pixels a job filters at least, smaller levels stay on the calling thread
+            constexpr size_t MIN_PIXELS_PER_RANGE = 64 * 1024;
+
+            // Linear colors are 16 bit fixed point, fine enough for every sRGB value to map back to itself
+            constexpr uint32_t LINEAR_MAX = 65535;
+
+            class SrgbTables
+            {
+            public:
+                static const SrgbTables &Get()
+                {
+                    static const SrgbTables tables;
+                    return tables;
+                }
+
+                uint32_t ToLinear(uint8_t color) const { return m_ToLinear[color]; }
+                uint8_t ToSrgb(uint32_t linear) const { return m_ToSrgb[linear]; }
+
+            private:
+                SrgbTables()
+                    : m_ToSrgb(LINEAR_MAX + 1)
+                {
+                    for (uint32_t color = 0; color < 256; color++)
+                    {
+                        auto value = static_cast<float>(color) / 255.0f;
+                        auto linear = value <= 0.04045f ? value / 12.92f : std::pow((value + 0.055f) / 1.055f, 2.4f);
+                        m_ToLinear[color] = static_cast<uint16_t>(std::lround(linear * LINEAR_MAX));
+                    }
+
+                    for (uint32_t linear = 0; linear <= LINEAR_MAX; linear++)
+                    {
+                        auto value = static_cast<float>(linear) / LINEAR_MAX;
+                        auto color = value <= 0.0031308f ? value * 12.92f : 1.055f * std::pow(value, 1.0f / 2.4f) - 0.055f;
+                        m_ToSrgb[linear] = static_cast<uint8_t>(std::lround(std::clamp(color, 0.0f, 1.0f) * 255.0f));
+                    }
+                }
+
+                uint16_t m_ToLinear[256];
+                std::vector<uint8_t> m_ToSrgb;
+            };
+
+            // Source pixels along one axis a destination pixel is filtered from
+            struct Taps
+            {
+                uint32_t first{0};
+                uint32_t count{1};
+                float weights[3]{1.0f, 0.0f, 0.0f};
+            };
+
+            Taps ComputeTaps(uint32_t destination, uint32_t source_size, uint32_t destination_size)
+            {
+                Taps taps;
+
+                if (source_size == destination_size)
+                {
+                    taps.first = destination;
+                }
+                else if (source_size == destination_size * 2)
+                {
+                    taps.first = destination * 2;
+                    taps.count = 2;
+                    taps.weights[0] = 0.5f;
+                    taps.weights[1] = 0.5f;
+                }
+                else
+                {
+                    // Odd sizes, every destination pixel covers 2 + 1 / destination_size source pixels
+                    auto size = static_cast<float>(source_size);
+
+                    taps.first = destination * 2;
+                    taps.count = 3;
+                    taps.weights[0] = static_cast<float>(destination_size - destination) / size;
+                    taps.weights[1] = static_cast<float>(destination_size) / size;
+                    taps.weights[2] = static_cast<float>(destination + 1) / size;
+                }
+
+                return taps;
+            }
+
+            // 2x2 box of two RGBA8 rows, rounded to nearest
+            void BoxRow(const uint8_t *row0, const uint8_t *row1, uint8_t *destination, uint32_t width)
+            {
+                uint32_t x = 0;
+
+#if defined(ENG_SIMD_SSE) || defined(ENG_SIMD_AVX2)
+                const __m128i zero = _mm_setzero_si128();
+                const __m128i two = _mm_set1_epi16(2);
+
+                // 4 destination pixels from 8 source pixels of each row
+                for (; x + 4 <= width; x += 4)
+                {
+                    __m128i a0 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(row0 + x * 8));
+                    __m128i a1 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(row0 + x * 8 + 16));
+                    __m128i b0 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(row1 + x * 8));
+                    __m128i b1 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(row1 + x * 8 + 16));
+
+                    // Vertical sums with 16 bits per channel, two pixels per register
+                    __m128i low0 = _mm_add_epi16(_mm_unpacklo_epi8(a0, zero), _mm_unpacklo_epi8(b0, zero));
+                    __m128i high0 = _mm_add_epi16(_mm_unpackhi_epi8(a0, zero), _mm_unpackhi_epi8(b0, zero));
+                    __m128i low1 = _mm_add_epi16(_mm_unpacklo_epi8(a1, zero), _mm_unpacklo_epi8(b1, zero));
+                    __m128i high1 = _mm_add_epi16(_mm_unpackhi_epi8(a1, zero), _mm_unpackhi_epi8(b1, zero));
+
+                    // Neighbouring pixels added up, the even pixels are in the low halves and the odd ones in the high halves
+                    __m128i sum0 = _mm_add_epi16(_mm_unpacklo_epi64(low0, high0), _mm_unpackhi_epi64(low0, high0));
+                    __m128i sum1 = _mm_add_epi16(_mm_unpacklo_epi64(low1, high1), _mm_unpackhi_epi64(low1, high1));
+
+                    sum0 = _mm_srli_epi16(_mm_add_epi16(sum0, two), 2);
+                    sum1 = _mm_srli_epi16(_mm_add_epi16(sum1, two), 2);
+
+                    _mm_storeu_si128(reinterpret_cast<__m128i *>(destination + x * 4), _mm_packus_epi16(sum0, sum1));
+                }
+#endif
+
+                for (; x < width; x++)
+                {
+                    for (uint32_t channel = 0; channel < CHANNELS; channel++)
+                    {
+                        auto sum = row0[x * 8 + channel] + row0[x * 8 + 4 + channel] + row1[x * 8 + channel] + row1[x * 8 + 4 + channel];
+                        destination[x * 4 + channel] = static_cast<uint8_t>((sum + 2) >> 2);
+                    }
+                }
+            }
+
+            // 2x2 box averaging the colors in linear space, alpha is linear already
+            void BoxRowSrgb(const uint8_t *row0, const uint8_t *row1, uint8_t *destination, uint32_t width, const SrgbTables &tables)
+            {
+                for (uint32_t x = 0; x < width; x++)
+                {
+                    auto *a = row0 + x * 8;
+                    auto *b = row1 + x * 8;
+
+                    for (uint32_t channel = 0; channel < 3; channel++)
+                    {
+                        auto sum = tables.ToLinear(a[channel]) + tables.ToLinear(a[4 + channel]) +
+                                   tables.ToLinear(b[channel]) + tables.ToLinear(b[4 + channel]);
+                        destination[x * 4 + channel] = tables.ToSrgb((sum + 2) >> 2);
+                    }
+
+                    destination[x * 4 + 3] = static_cast<uint8_t>((a[3] + a[7] + b[3] + b[7] + 2) >> 2);
+                }
+            }
+
+            // Any size, up to 3x3 taps per destination pixel
+            void FilterRow(const uint8_t *source, uint32_t source_width, const Taps &row_taps, const std::vector<Taps> &column_taps,
+                           uint8_t *destination, bool srgb, const SrgbTables &tables)
+            {
+                for (size_t x = 0; x < column_taps.size(); x++)
+                {
+                    auto &taps = column_taps[x];
+                    float sums[CHANNELS]{};
+
+                    for (uint32_t row = 0; row < row_taps.count; row++)
+                    {
+                        auto *source_row = source + static_cast<size_t>(row_taps.first + row) * source_width * CHANNELS;
+
+                        for (uint32_t column = 0; column < taps.count; column++)
+                        {
+                            auto *pixel = source_row + static_cast<size_t>(taps.first + column) * CHANNELS;
+                            auto weight = row_taps.weights[row] * taps.weights[column];
+
+                            for (uint32_t channel = 0; channel < CHANNELS; channel++)
+                            {
+                                auto value = srgb && channel < 3 ? tables.ToLinear(pixel[channel]) : pixel[channel];
+                                sums[channel] += static_cast<float>(value) * weight;
+                            }
+                        }
+                    }
+
+                    for (uint32_t channel = 0; channel < CHANNELS; channel++)
+                    {
+                        if (srgb && channel < 3)
+                            destination[x * 4 + channel] = tables.ToSrgb(std::min<uint32_t>(static_cast<uint32_t>(sums[channel] + 0.5f), LINEAR_MAX));
+                        else
+                            destination[x * 4 + channel] = static_cast<uint8_t>(std::min(sums[channel] + 0.5f, 255.0f));
+                    }
+                }
+            }
+
+            void FilterRows(const uint8_t *source, const VkExtent3D &source_extent, uint8_t *destination, const VkExtent3D &extent,
+                            bool srgb, size_t begin, size_t end)
+            {
+                auto &tables = SrgbTables::Get();
+                auto source_row_size = static_cast<size_t>(source_extent.width) * CHANNELS;
+                auto row_size = static_cast<size_t>(extent.width) * CHANNELS;
+
+                if (source_extent.width == extent.width * 2 && source_extent.height == extent.height * 2)
+                {
+                    for (auto y = begin; y < end; y++)
+                    {
+                        auto *row0 = source + y * 2 * source_row_size;
+
+                        if (srgb)
+                            BoxRowSrgb(row0, row0 + source_row_size, destination + y * row_size, extent.width, tables);
+                        else
+                            BoxRow(row0, row0 + source_row_size, destination + y * row_size, extent.width);
+                    }
+
+                    return;
+                }
+
+                std::vector<Taps> column_taps(extent.width);
+                for (uint32_t x = 0; x < extent.width; x++)
+                    column_taps[x] = ComputeTaps(x, source_extent.width, extent.width);
+
+                for (auto y = begin; y < end; y++)
+                {
+                    auto row_taps = ComputeTaps(ToUint32_t(y), source_extent.height, extent.height);
+                    FilterRow(source, source_extent.width, row_taps, column_taps, destination + y * row_size, srgb, tables);
+                }
+            }
+        }
+
+        void WriteMipmapChain(const uint8_t *base, const std::vector<Mipmap> &mipmaps, bool srgb, uint8_t *data)
+        {
+            auto level_size = [&mipmaps](size_t level)
+            {
+                auto &extent = mipmaps[level].extent;
+                return static_cast<size_t>(extent.width) * extent.height * CHANNELS;
+            };
+
+            std::memcpy(data + mipmaps[0].offset, base, level_size(0));
+
+            if (mipmaps.size() < 2)
+                return;
+
+            // Levels alternate between the two parts of one allocation, level 1 is the largest of them
+            std::vector<uint8_t> scratch(level_size(1) + (mipmaps.size() > 2 ? level_size(2) : 0));
+
+            auto &job_system = JobSystem::Get();
+            const uint8_t *source = base;
+
+            for (size_t level = 1; level < mipmaps.size(); level++)
+            {
+                auto &source_extent = mipmaps[level - 1].extent;
+                auto &extent = mipmaps[level].extent;
+
+                auto *destination = scratch.data() + (level % 2 == 1 ? 0 : level_size(1));
+                auto *output = data + mipmaps[level].offset;
+                auto row_size = static_cast<size_t>(extent.width) * CHANNELS;
+
+                job_system.ParallelFor(extent.height, std::max<size_t>(1, MIN_PIXELS_PER_RANGE / extent.width),
+                                       [&](size_t begin, size_t end)
+                                       {
+                                           FilterRows(source, source_extent, destination, extent, srgb, begin, end);
+                                           std::memcpy(output + begin * row_size, destination + begin * row_size, (end - begin) * row_size);
+                                       });
+
+                source = destination;
+            }
+        }
+    }
+}
@@ -0,0 +1,15 @@
+#pragma once
+
+#include "scene/components/image.h"
+
+namespace engine
+{
+    namespace sg
+    {
+        // Writes an RGBA8 chain laid out by mipmaps to data, level 0 is copied from base and every other level is
+        // filtered from the one before it. The previous level is kept in CPU memory, so data is only written to.
+        // Levels twice as large as the next one use a 2x2 box, odd sizes a 3 tap polyphase box. sRGB colors are
+        // averaged in linear space, large levels are split across the job system's workers
+        void WriteMipmapChain(const uint8_t *base, const std::vector<Mipmap> &mipmaps, bool srgb, uint8_t *data);
+    }
+}
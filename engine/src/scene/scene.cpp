@@ -6,26 +6,52 @@
 #include "vulkan_api/render_context.h"
 #include "vulkan_api/subpasses/forward_subpass.h"
 #include "vulkan_api/device.h"
+#include "vulkan_api/core/geometry_arena.h"
+#include "vulkan_api/texture_streamer.h"
 #include "window/window.h"
 #include "scene/components/image.h"
 #include "scene/scripts/free_camera.h"
 #include "scene/components/perspective_camera.h"
 #include "scene/components/transform.h"
 #include "scene/components/light.h"
+#include "scene/components/hierarchy.h"
+#include "scene/components/mesh.h"
+#include "scene/components/skin.h"
+#include "scene/components/world_bounds.h"
 #include "scene/components/pbr_material.h"
 #include "scene/components/sampler.h"
 #include "scene/components/submesh.h"
 #include "scene/components/texture.h"
+#include "scene/systems/animation_system.h"
+#include "scene/systems/bounds_system.h"
+#include "scene/systems/skinning_system.h"
+#include "scene/systems/spatial_system.h"
+#include "scene/systems/system_scheduler.h"
+#include "scene/systems/transform_system.h"
 
 namespace engine
 {
     Scene::Scene()
+        : m_TransformSystem(std::make_unique<TransformSystem>(*this)),
+          m_BoundsSystem(std::make_unique<BoundsSystem>(*this)),
+          m_SpatialSystem(std::make_unique<SpatialSystem>(*this)),
+          m_AnimationSystem(std::make_unique<AnimationSystem>(*this)),
+          m_SkinningSystem(std::make_unique<SkinningSystem>(*this)),
+          m_Scheduler(std::make_unique<SystemScheduler>(m_Registry))
     {
+        RegisterSystems();
     }
 
     Scene::Scene(const std::string &name)
-        : m_Name(name)
+        : m_Name(name),
+          m_TransformSystem(std::make_unique<TransformSystem>(*this)),
+          m_BoundsSystem(std::make_unique<BoundsSystem>(*this)),
+          m_SpatialSystem(std::make_unique<SpatialSystem>(*this)),
+          m_AnimationSystem(std::make_unique<AnimationSystem>(*this)),
+          m_SkinningSystem(std::make_unique<SkinningSystem>(*this)),
+          m_Scheduler(std::make_unique<SystemScheduler>(m_Registry))
     {
+        RegisterSystems();
     }
 
     Scene::~Scene()
@@ -34,13 +60,55 @@ namespace engine
 
     void Scene::Update(float delta_time)
     {
-        auto view = m_Registry.view<sg::FreeCamera>();
+        m_Scheduler->Run(delta_time);
 
-        for (auto &entity : view)
-        {
-            auto &camera = view.get<sg::FreeCamera>(entity);
-            camera.Update(delta_time);
-        }
+        if (m_TextureStreamer)
+            m_TextureStreamer->Update();
+    }
+
+    void Scene::RegisterSystems()
+    {
+        // Systems writing the same component run in the order they are added here. Scripts poll GLFW input,
+        // which is main thread only
+        m_Scheduler->AddSystem("Scripts", SystemAccess{}.Read<sg::FreeCamera>().Write<sg::Transform>(),
+                               [this](float delta_time)
+                               {
+                                   auto view = m_Registry.view<sg::FreeCamera>();
+
+                                   for (auto &entity : view)
+                                       view.get<sg::FreeCamera>(entity).Update(delta_time);
+                               },
+                               true);
+
+        m_Scheduler->AddSystem("Animation", SystemAccess{}.Write<sg::Transform>(),
+                               [this](float delta_time)
+                               { m_AnimationSystem->Update(delta_time); });
+
+        m_Scheduler->AddSystem("Transform", SystemAccess{}.Read<sg::Hierarchy>().Write<sg::Transform>(),
+                               [this](float)
+                               { m_TransformSystem->Update(); });
+
+        m_Scheduler->AddSystem("Skinning", SystemAccess{}.Read<sg::Transform>().Write<sg::Skin>(),
+                               [this](float)
+                               { m_SkinningSystem->Update(); });
+
+        m_Scheduler->AddSystem("Bounds", SystemAccess{}.Read<sg::Mesh, sg::Transform>().Write<sg::WorldBounds>(),
+                               [this](float)
+                               { m_BoundsSystem->Update(); });
+
+        m_Scheduler->AddSystem("Spatial", SystemAccess{}.Read<sg::WorldBounds, sg::Light, sg::Transform>(),
+                               [this](float)
+                               { m_SpatialSystem->Update(); });
+    }
+
+    void Scene::SetGeometryArena(std::unique_ptr<GeometryArena> &&geometry_arena)
+    {
+        m_GeometryArena = std::move(geometry_arena);
+    }
+
+    void Scene::SetTextureStreamer(std::unique_ptr<TextureStreamer> &&texture_streamer)
+    {
+        m_TextureStreamer = std::move(texture_streamer);
     }
 
     Entity Scene::CreateEntity()
@@ -4,6 +4,8 @@ ENG_DISABLE_WARNINGS()
 #include <entt/entt.hpp>
 ENG_ENABLE_WARNINGS()
 
+#include <atomic>
+
 namespace engine
 {
     class Entity;
@@ -15,6 +17,14 @@ namespace engine
     class CommandBuffer;
     class RenderTarget;
     class Layer;
+    class TransformSystem;
+    class BoundsSystem;
+    class SpatialSystem;
+    class AnimationSystem;
+    class SkinningSystem;
+    class SystemScheduler;
+    class GeometryArena;
+    class TextureStreamer;
 
     namespace sg
     {
@@ -36,7 +46,20 @@ namespace engine
 
         void Update(float delta_time);
         Entity CreateEntity();
+
+        // A scene loading on another thread is owned by its loader until it is marked loaded,
+        // only its render pipelines may be set up meanwhile
+        bool IsLoaded() const { return m_Loaded; }
+        void SetLoaded(bool loaded) { m_Loaded = loaded; }
+
+        const std::string &GetName() const { return m_Name; }
+        void SetName(const std::string &name) { m_Name = name; }
         entt::registry &GetRegistry() { return m_Registry; }
+        TransformSystem &GetTransformSystem() { return *m_TransformSystem; }
+        BoundsSystem &GetBoundsSystem() { return *m_BoundsSystem; }
+        SpatialSystem &GetSpatialSystem() { return *m_SpatialSystem; }
+        AnimationSystem &GetAnimationSystem() { return *m_AnimationSystem; }
+        SkinningSystem &GetSkinningSystem() { return *m_SkinningSystem; }
 
         std::vector<std::unique_ptr<Entity>> &GetLights() { return m_Lights; }
         std::vector<std::unique_ptr<sg::Sampler>> &GetSamplers() { return m_Samplers; }
@@ -48,9 +71,27 @@ namespace engine
         std::vector<std::unique_ptr<sg::Submesh>> &GetSubmeshes() { return m_Submeshes; }
         std::vector<std::unique_ptr<RenderPipeline>> &GetRenderPipelines() { return m_RenderPipelines; }
 
+        // Null until a loader placed geometry in it
+        GeometryArena *GetGeometryArena() { return m_GeometryArena.get(); }
+        void SetGeometryArena(std::unique_ptr<GeometryArena> &&geometry_arena);
+
+        // Null unless a loader streams the scene's images, updated with the scene
+        TextureStreamer *GetTextureStreamer() { return m_TextureStreamer.get(); }
+        void SetTextureStreamer(std::unique_ptr<TextureStreamer> &&texture_streamer);
+
     private:
+        void RegisterSystems();
+
         std::string m_Name{"Unnamed scene"};
         entt::registry m_Registry{};
+        std::unique_ptr<TransformSystem> m_TransformSystem;
+        std::unique_ptr<BoundsSystem> m_BoundsSystem;
+        std::unique_ptr<SpatialSystem> m_SpatialSystem;
+        std::unique_ptr<AnimationSystem> m_AnimationSystem;
+        std::unique_ptr<SkinningSystem> m_SkinningSystem;
+        std::unique_ptr<SystemScheduler> m_Scheduler;
+        // Declared before the submeshes, which return their ranges to it when destroyed
+        std::unique_ptr<GeometryArena> m_GeometryArena;
 
         std::vector<std::unique_ptr<Entity>> m_Lights;
         std::vector<std::unique_ptr<sg::Sampler>> m_Samplers;
@@ -61,5 +102,9 @@ namespace engine
         std::vector<std::unique_ptr<Entity>> m_Cameras;
         std::vector<std::unique_ptr<sg::Submesh>> m_Submeshes;
         std::vector<std::unique_ptr<RenderPipeline>> m_RenderPipelines;
+        // Declared after the images and materials it refers to, so it is destroyed first
+        std::unique_ptr<TextureStreamer> m_TextureStreamer;
+
+        std::atomic<bool> m_Loaded{true};
     };
 }
@@ -15,7 +15,8 @@ namespace engine
     {
         class PerspectiveCamera;
 
-        class FreeCamera : public Script
+        // Final so the scheduler's script pass calls Update without a virtual dispatch
+        class FreeCamera final : public Script
         {
         public:
             FreeCamera(Application &application, std::string &layer_name);
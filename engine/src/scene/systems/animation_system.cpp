@@ -0,0 +1,224 @@
+#include "scene/systems/animation_system.h"
+
+#include "scene/components/transform.h"
+#include "scene/scene.h"
+
+namespace engine
+{
+    AnimationSystem::AnimationSystem(Scene &scene)
+        : m_Scene(scene)
+    {
+    }
+
+    AnimationSystem::~AnimationSystem()
+    {
+    }
+
+    uint32_t AnimationSystem::AddClip(const std::string &name, const std::vector<AnimationTrack> &tracks)
+    {
+        AnimationClip clip{};
+        clip.name = name;
+        clip.first_channel = ToUint32_t(m_Channels.size());
+
+        for (auto &track : tracks)
+        {
+            size_t values_per_key = track.interpolation == AnimationInterpolation::CubicSpline ? 3 : 1;
+
+            if (track.times.empty() || track.values.size() != track.times.size() * values_per_key)
+            {
+                ENG_CORE_WARN("Skipping animation track with mismatched keyframes in clip {}", name);
+                continue;
+            }
+
+            Channel channel{};
+            channel.target = track.target;
+            channel.path = track.path;
+            channel.interpolation = track.interpolation;
+            channel.first_key = ToUint32_t(m_KeyTimes.size());
+            channel.key_count = ToUint32_t(track.times.size());
+            channel.first_value = ToUint32_t(m_KeyValues.size());
+            channel.last_key = 0;
+
+            m_KeyTimes.insert(m_KeyTimes.end(), track.times.begin(), track.times.end());
+            m_KeyValues.insert(m_KeyValues.end(), track.values.begin(), track.values.end());
+            m_Channels.push_back(channel);
+
+            clip.duration = std::max(clip.duration, track.times.back());
+        }
+
+        clip.channel_count = ToUint32_t(m_Channels.size()) - clip.first_channel;
+        m_Clips.push_back(std::move(clip));
+
+        return ToUint32_t(m_Clips.size() - 1);
+    }
+
+    void AnimationSystem::Play(uint32_t clip, bool loop)
+    {
+        auto &animation = m_Clips.at(clip);
+        animation.playing = true;
+        animation.loop = loop;
+    }
+
+    void AnimationSystem::Stop(uint32_t clip)
+    {
+        auto &animation = m_Clips.at(clip);
+        animation.playing = false;
+        animation.time = 0.0f;
+    }
+
+    void AnimationSystem::Update(float delta_time)
+    {
+        m_LerpBatch.Clear();
+        m_SlerpBatch.Clear();
+        m_LerpChannels.clear();
+        m_SlerpChannels.clear();
+
+        for (auto &clip : m_Clips)
+        {
+            if (!clip.playing)
+                continue;
+
+            AdvanceTime(clip, delta_time);
+
+            for (uint32_t index = clip.first_channel; index < clip.first_channel + clip.channel_count; index++)
+            {
+                auto &channel = m_Channels[index];
+
+                if (channel.path == AnimationPath::Rotation)
+                {
+                    Sample(channel, clip.time, m_SlerpBatch);
+                    m_SlerpChannels.push_back(index);
+                }
+                else
+                {
+                    Sample(channel, clip.time, m_LerpBatch);
+                    m_LerpChannels.push_back(index);
+                }
+            }
+        }
+
+        if (m_LerpChannels.empty() && m_SlerpChannels.empty())
+            return;
+
+        auto &registry = m_Scene.GetRegistry();
+
+        m_Results.resize(m_LerpBatch.GetSize());
+        m_LerpBatch.Lerp(m_Results.data());
+
+        for (size_t i = 0; i < m_LerpChannels.size(); i++)
+        {
+            auto &channel = m_Channels[m_LerpChannels[i]];
+            if (!registry.valid(channel.target))
+                continue;
+
+            if (auto *transform = registry.try_get<sg::Transform>(channel.target))
+            {
+                glm::vec3 value{m_Results[i]};
+
+                if (channel.path == AnimationPath::Translation)
+                    transform->SetTranslation(value);
+                else
+                    transform->SetScale(value);
+            }
+        }
+
+        m_Results.resize(m_SlerpBatch.GetSize());
+        m_SlerpBatch.Slerp(m_Results.data());
+
+        for (size_t i = 0; i < m_SlerpChannels.size(); i++)
+        {
+            auto &channel = m_Channels[m_SlerpChannels[i]];
+            if (!registry.valid(channel.target))
+                continue;
+
+            if (auto *transform = registry.try_get<sg::Transform>(channel.target))
+            {
+                auto &value = m_Results[i];
+                transform->SetRotation(glm::quat{value.w, value.x, value.y, value.z});
+            }
+        }
+    }
+
+    void AnimationSystem::AdvanceTime(AnimationClip &clip, float delta_time)
+    {
+        clip.time += delta_time * clip.speed;
+
+        if (clip.time >= 0.0f && clip.time <= clip.duration)
+            return;
+
+        if (clip.loop && clip.duration > 0.0f)
+        {
+            clip.time = std::fmod(clip.time, clip.duration);
+            if (clip.time < 0.0f)
+                clip.time += clip.duration;
+        }
+        else
+        {
+            // The last pose is still sampled this frame
+            clip.time = glm::clamp(clip.time, 0.0f, clip.duration);
+            clip.playing = false;
+        }
+    }
+
+    void AnimationSystem::Sample(Channel &channel, float time, KeyframeBatch &batch)
+    {
+        const float *times = &m_KeyTimes[channel.first_key];
+        const glm::vec4 *values = &m_KeyValues[channel.first_value];
+        uint32_t count = channel.key_count;
+
+        if (count == 1)
+        {
+            auto &value = channel.interpolation == AnimationInterpolation::CubicSpline ? values[1] : values[0];
+            batch.Push(value, value, 0.0f);
+            return;
+        }
+
+        // Playback mostly moves forward by less than a key, so the cached key is usually a hit
+        uint32_t key = channel.last_key;
+        if (key + 1 >= count || time < times[key])
+            key = 0;
+
+        while (key + 2 < count && time >= times[key + 1])
+            key++;
+
+        channel.last_key = key;
+
+        float span = times[key + 1] - times[key];
+        float t = span > 0.0f ? glm::clamp((time - times[key]) / span, 0.0f, 1.0f) : 0.0f;
+
+        switch (channel.interpolation)
+        {
+        case AnimationInterpolation::Linear:
+            batch.Push(values[key], values[key + 1], t);
+            break;
+
+        case AnimationInterpolation::Step:
+        {
+            auto &value = values[t >= 1.0f ? key + 1 : key];
+            batch.Push(value, value, 0.0f);
+            break;
+        }
+
+        case AnimationInterpolation::CubicSpline:
+        {
+            // Hermite spline between the values of both keys, tangents are scaled by the key span
+            const auto &from = values[key * 3 + 1];
+            const auto &from_out_tangent = values[key * 3 + 2];
+            const auto &to_in_tangent = values[(key + 1) * 3];
+            const auto &to = values[(key + 1) * 3 + 1];
+
+            float t2 = t * t;
+            float t3 = t2 * t;
+
+            glm::vec4 value = (2.0f * t3 - 3.0f * t2 + 1.0f) * from +
+                              (t3 - 2.0f * t2 + t) * span * from_out_tangent +
+                              (-2.0f * t3 + 3.0f * t2) * to +
+                              (t3 - t2) * span * to_in_tangent;
+
+            // A zero factor leaves the value as is, rotations still get normalized by the slerp pass
+            batch.Push(value, value, 0.0f);
+            break;
+        }
+        }
+    }
+}
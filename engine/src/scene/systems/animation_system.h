@@ -0,0 +1,99 @@
+#pragma once
+
+#include "scene/systems/keyframe_batch.h"
+
+ENG_DISABLE_WARNINGS()
+#include <entt/entt.hpp>
+ENG_ENABLE_WARNINGS()
+
+namespace engine
+{
+    class Scene;
+
+    enum class AnimationPath : uint8_t
+    {
+        Translation,
+        Rotation,
+        Scale
+    };
+
+    enum class AnimationInterpolation : uint8_t
+    {
+        Linear,
+        Step,
+        CubicSpline
+    };
+
+    struct AnimationTrack
+    {
+        entt::entity target{entt::null};
+        AnimationPath path{AnimationPath::Translation};
+        AnimationInterpolation interpolation{AnimationInterpolation::Linear};
+        std::vector<float> times;
+        // One value per key, cubic splines store in-tangent, value, out-tangent per key.
+        // Rotations are xyzw quaternions
+        std::vector<glm::vec4> values;
+    };
+
+    struct AnimationClip
+    {
+        std::string name;
+        uint32_t first_channel{0};
+        uint32_t channel_count{0};
+        float duration{0.0f};
+        float time{0.0f};
+        float speed{1.0f};
+        bool playing{false};
+        bool loop{true};
+    };
+
+    class AnimationSystem
+    {
+    public:
+        AnimationSystem(Scene &scene);
+        ~AnimationSystem();
+
+        AnimationSystem(const AnimationSystem &) = delete;
+        AnimationSystem &operator=(const AnimationSystem &) = delete;
+
+        uint32_t AddClip(const std::string &name, const std::vector<AnimationTrack> &tracks);
+        void Play(uint32_t clip, bool loop = true);
+        void Stop(uint32_t clip);
+
+        // Samples every playing clip and writes the results into the target transforms
+        void Update(float delta_time);
+
+        std::vector<AnimationClip> &GetClips() { return m_Clips; }
+        size_t GetChannelCount() const { return m_Channels.size(); }
+
+    private:
+        struct Channel
+        {
+            entt::entity target;
+            AnimationPath path;
+            AnimationInterpolation interpolation;
+            uint32_t first_key;
+            uint32_t key_count;
+            uint32_t first_value;
+            // Keyframe found by the last sample, the search starts from it
+            uint32_t last_key;
+        };
+
+        void Sample(Channel &channel, float time, KeyframeBatch &batch);
+        void AdvanceTime(AnimationClip &clip, float delta_time);
+
+        Scene &m_Scene;
+
+        std::vector<AnimationClip> m_Clips;
+        std::vector<Channel> m_Channels;
+        std::vector<float> m_KeyTimes;
+        std::vector<glm::vec4> m_KeyValues;
+
+        // Rotations are slerped, translations and scales lerped
+        KeyframeBatch m_LerpBatch;
+        KeyframeBatch m_SlerpBatch;
+        std::vector<uint32_t> m_LerpChannels;
+        std::vector<uint32_t> m_SlerpChannels;
+        std::vector<glm::vec4> m_Results;
+    };
+}
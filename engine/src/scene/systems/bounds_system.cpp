@@ -0,0 +1,107 @@
+#include "scene/systems/bounds_system.h"
+
+#include "scene/scene.h"
+#include "scene/components/mesh.h"
+#include "scene/components/transform.h"
+#include "scene/components/world_bounds.h"
+#include "scene/systems/transform_system.h"
+
+namespace engine
+{
+    BoundsSystem::BoundsSystem(Scene &scene)
+        : m_Scene(scene)
+    {
+        auto &registry = m_Scene.GetRegistry();
+        registry.on_construct<sg::Mesh>().connect<&BoundsSystem::OnTopologyChanged>(*this);
+        registry.on_destroy<sg::Mesh>().connect<&BoundsSystem::OnTopologyChanged>(*this);
+        registry.on_construct<sg::Transform>().connect<&BoundsSystem::OnTopologyChanged>(*this);
+        registry.on_destroy<sg::Transform>().connect<&BoundsSystem::OnTopologyChanged>(*this);
+    }
+
+    BoundsSystem::~BoundsSystem()
+    {
+        auto &registry = m_Scene.GetRegistry();
+        registry.on_construct<sg::Mesh>().disconnect<&BoundsSystem::OnTopologyChanged>(*this);
+        registry.on_destroy<sg::Mesh>().disconnect<&BoundsSystem::OnTopologyChanged>(*this);
+        registry.on_construct<sg::Transform>().disconnect<&BoundsSystem::OnTopologyChanged>(*this);
+        registry.on_destroy<sg::Transform>().disconnect<&BoundsSystem::OnTopologyChanged>(*this);
+    }
+
+    void BoundsSystem::Update()
+    {
+        m_ChangedIndices.clear();
+        m_Rebuilt = false;
+
+        if (m_TopologyDirty)
+        {
+            Rebuild();
+            return;
+        }
+
+        auto &registry = m_Scene.GetRegistry();
+
+        for (auto entity : m_Scene.GetTransformSystem().GetChangedEntities())
+        {
+            if (auto *world_bounds = registry.try_get<sg::WorldBounds>(entity))
+            {
+                ComputeBounds(world_bounds->GetIndex());
+                m_ChangedIndices.push_back(world_bounds->GetIndex());
+            }
+        }
+    }
+
+    void BoundsSystem::OnTopologyChanged(entt::registry & /*registry*/, entt::entity /*entity*/)
+    {
+        m_TopologyDirty = true;
+    }
+
+    void BoundsSystem::Rebuild()
+    {
+        auto &registry = m_Scene.GetRegistry();
+
+        registry.clear<sg::WorldBounds>();
+        m_Entities.clear();
+        m_SubmeshCount = 0;
+
+        auto view = registry.view<sg::Mesh, sg::Transform>();
+        for (auto entity : view)
+        {
+            registry.emplace<sg::WorldBounds>(entity, ToUint32_t(m_Entities.size()));
+            m_Entities.push_back(entity);
+            m_SubmeshCount += view.get<sg::Mesh>(entity).GetSubmeshes().size();
+        }
+
+        m_Bounds.resize(m_Entities.size());
+        m_BoundsBatch.Resize(m_Entities.size());
+
+        for (uint32_t index = 0; index < m_Entities.size(); index++)
+            ComputeBounds(index);
+
+        m_TopologyDirty = false;
+        m_Rebuilt = true;
+    }
+
+    void BoundsSystem::ComputeBounds(uint32_t index)
+    {
+        auto &registry = m_Scene.GetRegistry();
+        auto entity = m_Entities[index];
+
+        auto &mesh_bounds = registry.get<sg::Mesh>(entity).GetBounds();
+        auto &world_matrix = registry.get<sg::Transform>(entity).GetWorldMatrix();
+
+        auto &bounds = m_Bounds[index];
+
+        if (mesh_bounds.IsValid())
+        {
+            bounds = sg::AABB{mesh_bounds.GetMin(), mesh_bounds.GetMax()};
+            bounds.Transform(world_matrix);
+        }
+        else
+        {
+            glm::vec3 position{world_matrix[3]};
+            bounds = sg::AABB{position, position};
+        }
+
+        m_BoundsBatch.Set(index, bounds);
+    }
+}
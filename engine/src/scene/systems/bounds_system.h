@@ -0,0 +1,53 @@
+#pragma once
+
+#include "scene/frustum.h"
+
+ENG_DISABLE_WARNINGS()
+#include <entt/entt.hpp>
+ENG_ENABLE_WARNINGS()
+
+namespace engine
+{
+    class Scene;
+
+    // Caches the world space bounds of every mesh entity in dense arrays, only
+    // recomputing entries whose transform changed
+    class BoundsSystem
+    {
+    public:
+        BoundsSystem(Scene &scene);
+        ~BoundsSystem();
+
+        BoundsSystem(const BoundsSystem &) = delete;
+        BoundsSystem &operator=(const BoundsSystem &) = delete;
+
+        void Update();
+
+        const std::vector<entt::entity> &GetEntities() const { return m_Entities; }
+        const std::vector<sg::AABB> &GetBounds() const { return m_Bounds; }
+        // The same bounds in center/extent form
+        const sg::BoundsBatch &GetBoundsBatch() const { return m_BoundsBatch; }
+        size_t GetSubmeshCount() const { return m_SubmeshCount; }
+
+        // Set when the last Update reassigned every index
+        bool WasRebuilt() const { return m_Rebuilt; }
+        // Indices recomputed by the last Update, empty after a rebuild
+        const std::vector<uint32_t> &GetChangedIndices() const { return m_ChangedIndices; }
+
+    private:
+        void OnTopologyChanged(entt::registry &registry, entt::entity entity);
+        void Rebuild();
+        void ComputeBounds(uint32_t index);
+
+        Scene &m_Scene;
+        bool m_TopologyDirty{true};
+        bool m_Rebuilt{false};
+
+        std::vector<entt::entity> m_Entities;
+        std::vector<sg::AABB> m_Bounds;
+        sg::BoundsBatch m_BoundsBatch;
+        size_t m_SubmeshCount{0};
+
+        std::vector<uint32_t> m_ChangedIndices;
+    };
+}
@@ -0,0 +1,181 @@
+#include "scene/systems/keyframe_batch.h"
+
+#include "common/simd.h"
+
+namespace engine
+{
+    namespace
+    {
+        // Polynomial fit of the slerp angle correction, stays within a tenth of a degree of slerp
+        inline float CorrectSlerpFactor(float t, float cos_angle)
+        {
+            float d = std::abs(cos_angle);
+            float a = 1.0904f + d * (-3.2452f + d * (3.55645f - d * 1.43519f));
+            float b = 0.848013f + d * (-1.06021f + d * 0.215638f);
+            float h = t - 0.5f;
+            float k = a * h * h + b;
+
+            return t + t * h * (t - 1.0f) * k;
+        }
+
+#if defined(ENG_SIMD_SSE) || defined(ENG_SIMD_AVX2)
+        inline void StoreResults(__m128 x, __m128 y, __m128 z, __m128 w, glm::vec4 *results)
+        {
+            _MM_TRANSPOSE4_PS(x, y, z, w);
+            _mm_storeu_ps(&results[0][0], x);
+            _mm_storeu_ps(&results[1][0], y);
+            _mm_storeu_ps(&results[2][0], z);
+            _mm_storeu_ps(&results[3][0], w);
+        }
+
+        inline __m128 Lerp(__m128 from, __m128 to, __m128 t)
+        {
+            return _mm_add_ps(from, _mm_mul_ps(_mm_sub_ps(to, from), t));
+        }
+
+        // 4 keyframes per iteration, returns the first index left for the scalar tail
+        size_t LerpSSE(const float *fx, const float *fy, const float *fz, const float *fw,
+                       const float *tx, const float *ty, const float *tz, const float *tw,
+                       const float *factors, size_t count, glm::vec4 *results)
+        {
+            size_t i = 0;
+            for (; i + 4 <= count; i += 4)
+            {
+                __m128 t = _mm_loadu_ps(factors + i);
+
+                StoreResults(Lerp(_mm_loadu_ps(fx + i), _mm_loadu_ps(tx + i), t),
+                             Lerp(_mm_loadu_ps(fy + i), _mm_loadu_ps(ty + i), t),
+                             Lerp(_mm_loadu_ps(fz + i), _mm_loadu_ps(tz + i), t),
+                             Lerp(_mm_loadu_ps(fw + i), _mm_loadu_ps(tw + i), t),
+                             results + i);
+            }
+
+            return i;
+        }
+
+        size_t SlerpSSE(const float *fx, const float *fy, const float *fz, const float *fw,
+                        const float *tx, const float *ty, const float *tz, const float *tw,
+                        const float *factors, size_t count, glm::vec4 *results)
+        {
+            const __m128 sign_mask = _mm_set1_ps(-0.0f);
+            const __m128 half = _mm_set1_ps(0.5f);
+            const __m128 one = _mm_set1_ps(1.0f);
+
+            size_t i = 0;
+            for (; i + 4 <= count; i += 4)
+            {
+                __m128 from_x = _mm_loadu_ps(fx + i);
+                __m128 from_y = _mm_loadu_ps(fy + i);
+                __m128 from_z = _mm_loadu_ps(fz + i);
+                __m128 from_w = _mm_loadu_ps(fw + i);
+                __m128 to_x = _mm_loadu_ps(tx + i);
+                __m128 to_y = _mm_loadu_ps(ty + i);
+                __m128 to_z = _mm_loadu_ps(tz + i);
+                __m128 to_w = _mm_loadu_ps(tw + i);
+                __m128 t = _mm_loadu_ps(factors + i);
+
+                __m128 cos_angle = _mm_add_ps(_mm_add_ps(_mm_mul_ps(from_x, to_x), _mm_mul_ps(from_y, to_y)),
+                                              _mm_add_ps(_mm_mul_ps(from_z, to_z), _mm_mul_ps(from_w, to_w)));
+
+                // Flip the target onto the same hemisphere to take the shortest arc
+                __m128 sign = _mm_and_ps(cos_angle, sign_mask);
+                to_x = _mm_xor_ps(to_x, sign);
+                to_y = _mm_xor_ps(to_y, sign);
+                to_z = _mm_xor_ps(to_z, sign);
+                to_w = _mm_xor_ps(to_w, sign);
+
+                __m128 d = _mm_andnot_ps(sign_mask, cos_angle);
+                __m128 a = _mm_add_ps(_mm_set1_ps(1.0904f),
+                                      _mm_mul_ps(d, _mm_add_ps(_mm_set1_ps(-3.2452f),
+                                                               _mm_mul_ps(d, _mm_sub_ps(_mm_set1_ps(3.55645f),
+                                                                                        _mm_mul_ps(d, _mm_set1_ps(1.43519f)))))));
+                __m128 b = _mm_add_ps(_mm_set1_ps(0.848013f),
+                                      _mm_mul_ps(d, _mm_add_ps(_mm_set1_ps(-1.06021f),
+                                                               _mm_mul_ps(d, _mm_set1_ps(0.215638f)))));
+                __m128 h = _mm_sub_ps(t, half);
+                __m128 k = _mm_add_ps(_mm_mul_ps(a, _mm_mul_ps(h, h)), b);
+                t = _mm_add_ps(t, _mm_mul_ps(_mm_mul_ps(t, h), _mm_mul_ps(_mm_sub_ps(t, one), k)));
+
+                __m128 x = Lerp(from_x, to_x, t);
+                __m128 y = Lerp(from_y, to_y, t);
+                __m128 z = Lerp(from_z, to_z, t);
+                __m128 w = Lerp(from_w, to_w, t);
+
+                __m128 length = _mm_sqrt_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(x, x), _mm_mul_ps(y, y)),
+                                                       _mm_add_ps(_mm_mul_ps(z, z), _mm_mul_ps(w, w))));
+
+                StoreResults(_mm_div_ps(x, length), _mm_div_ps(y, length),
+                             _mm_div_ps(z, length), _mm_div_ps(w, length),
+                             results + i);
+            }
+
+            return i;
+        }
+#endif
+    }
+
+    void KeyframeBatch::Clear()
+    {
+        for (auto *array : {&m_FromX, &m_FromY, &m_FromZ, &m_FromW,
+                            &m_ToX, &m_ToY, &m_ToZ, &m_ToW, &m_T})
+            array->clear();
+    }
+
+    void KeyframeBatch::Push(const glm::vec4 &from, const glm::vec4 &to, float t)
+    {
+        m_FromX.push_back(from.x);
+        m_FromY.push_back(from.y);
+        m_FromZ.push_back(from.z);
+        m_FromW.push_back(from.w);
+
+        m_ToX.push_back(to.x);
+        m_ToY.push_back(to.y);
+        m_ToZ.push_back(to.z);
+        m_ToW.push_back(to.w);
+
+        m_T.push_back(t);
+    }
+
+    void KeyframeBatch::Lerp(glm::vec4 *results) const
+    {
+        size_t i = 0;
+
+#if defined(ENG_SIMD_SSE) || defined(ENG_SIMD_AVX2)
+        i = LerpSSE(m_FromX.data(), m_FromY.data(), m_FromZ.data(), m_FromW.data(),
+                    m_ToX.data(), m_ToY.data(), m_ToZ.data(), m_ToW.data(),
+                    m_T.data(), GetSize(), results);
+#endif
+
+        for (; i < GetSize(); i++)
+        {
+            glm::vec4 from{m_FromX[i], m_FromY[i], m_FromZ[i], m_FromW[i]};
+            glm::vec4 to{m_ToX[i], m_ToY[i], m_ToZ[i], m_ToW[i]};
+
+            results[i] = from + (to - from) * m_T[i];
+        }
+    }
+
+    void KeyframeBatch::Slerp(glm::vec4 *results) const
+    {
+        size_t i = 0;
+
+#if defined(ENG_SIMD_SSE) || defined(ENG_SIMD_AVX2)
+        i = SlerpSSE(m_FromX.data(), m_FromY.data(), m_FromZ.data(), m_FromW.data(),
+                     m_ToX.data(), m_ToY.data(), m_ToZ.data(), m_ToW.data(),
+                     m_T.data(), GetSize(), results);
+#endif
+
+        for (; i < GetSize(); i++)
+        {
+            glm::vec4 from{m_FromX[i], m_FromY[i], m_FromZ[i], m_FromW[i]};
+            glm::vec4 to{m_ToX[i], m_ToY[i], m_ToZ[i], m_ToW[i]};
+
+            float cos_angle = glm::dot(from, to);
+            if (cos_angle < 0.0f)
+                to = -to;
+
+            float t = CorrectSlerpFactor(m_T[i], cos_angle);
+            results[i] = glm::normalize(from + (to - from) * t);
+        }
+    }
+}
@@ -0,0 +1,28 @@
+#pragma once
+
+#include "common/glm.h"
+
+namespace engine
+{
+    // Structure of arrays list of keyframe pairs, interpolated all at once
+    class KeyframeBatch
+    {
+    public:
+        KeyframeBatch() = default;
+        ~KeyframeBatch() = default;
+
+        void Clear();
+        void Push(const glm::vec4 &from, const glm::vec4 &to, float t);
+        size_t GetSize() const { return m_T.size(); }
+
+        // Component wise from + (to - from) * t
+        void Lerp(glm::vec4 *results) const;
+        // Quaternions stored as xyzw, shortest arc nlerp with t corrected to follow slerp
+        void Slerp(glm::vec4 *results) const;
+
+    private:
+        std::vector<float> m_FromX, m_FromY, m_FromZ, m_FromW;
+        std::vector<float> m_ToX, m_ToY, m_ToZ, m_ToW;
+        std::vector<float> m_T;
+    };
+}
@@ -0,0 +1,48 @@
+#include "scene/systems/skinning_system.h"
+
+#include "scene/scene.h"
+#include "scene/components/skin.h"
+#include "scene/components/transform.h"
+
+namespace engine
+{
+    SkinningSystem::SkinningSystem(Scene &scene)
+        : m_Scene(scene)
+    {
+        // Skins own their group so the update walks packed storage, created here since
+        // creating a group later would change the registry while other systems run
+        static_cast<void>(m_Scene.GetRegistry().group<sg::Skin>(entt::get<sg::Transform>));
+    }
+
+    SkinningSystem::~SkinningSystem()
+    {
+    }
+
+    void SkinningSystem::Update()
+    {
+        auto &registry = m_Scene.GetRegistry();
+        auto group = registry.group<sg::Skin>(entt::get<sg::Transform>);
+
+        for (auto entity : group)
+        {
+            auto &skin = group.get<sg::Skin>(entity);
+            auto inverse_world = glm::inverse(group.get<sg::Transform>(entity).GetWorldMatrix());
+
+            for (size_t joint_index = 0; joint_index < skin.m_Joints.size(); joint_index++)
+            {
+                auto joint = skin.m_Joints[joint_index];
+                auto *joint_transform = registry.valid(joint) ? registry.try_get<sg::Transform>(joint) : nullptr;
+
+                if (!joint_transform)
+                {
+                    skin.m_JointMatrices[joint_index] = glm::mat4{1.0f};
+                    continue;
+                }
+
+                skin.m_JointMatrices[joint_index] = inverse_world *
+                                                    joint_transform->GetWorldMatrix() *
+                                                    skin.m_InverseBindMatrices[joint_index];
+            }
+        }
+    }
+}
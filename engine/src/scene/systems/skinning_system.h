@@ -0,0 +1,22 @@
+#pragma once
+
+namespace engine
+{
+    class Scene;
+
+    // Computes the joint matrix palette of every skinned node, after the world matrices are resolved
+    class SkinningSystem
+    {
+    public:
+        SkinningSystem(Scene &scene);
+        ~SkinningSystem();
+
+        SkinningSystem(const SkinningSystem &) = delete;
+        SkinningSystem &operator=(const SkinningSystem &) = delete;
+
+        void Update();
+
+    private:
+        Scene &m_Scene;
+    };
+}
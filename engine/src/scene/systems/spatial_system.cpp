@@ -0,0 +1,137 @@
+#include "scene/systems/spatial_system.h"
+
+#include "core/timer.h"
+#include "scene/scene.h"
+#include "scene/components/light.h"
+#include "scene/components/transform.h"
+#include "scene/systems/bounds_system.h"
+#include "scene/systems/transform_system.h"
+
+namespace engine
+{
+    SpatialSystem::SpatialSystem(Scene &scene)
+        : m_Scene(scene)
+    {
+        auto &registry = m_Scene.GetRegistry();
+        registry.on_construct<sg::Light>().connect<&SpatialSystem::OnLightsChanged>(*this);
+        registry.on_destroy<sg::Light>().connect<&SpatialSystem::OnLightsChanged>(*this);
+
+        // Lights only enter the hierarchy once they have a transform
+        registry.on_construct<sg::Transform>().connect<&SpatialSystem::OnLightsChanged>(*this);
+        registry.on_destroy<sg::Transform>().connect<&SpatialSystem::OnLightsChanged>(*this);
+    }
+
+    SpatialSystem::~SpatialSystem()
+    {
+        auto &registry = m_Scene.GetRegistry();
+        registry.on_construct<sg::Light>().disconnect<&SpatialSystem::OnLightsChanged>(*this);
+        registry.on_destroy<sg::Light>().disconnect<&SpatialSystem::OnLightsChanged>(*this);
+        registry.on_construct<sg::Transform>().disconnect<&SpatialSystem::OnLightsChanged>(*this);
+        registry.on_destroy<sg::Transform>().disconnect<&SpatialSystem::OnLightsChanged>(*this);
+    }
+
+    void SpatialSystem::Update()
+    {
+        auto &bounds_system = m_Scene.GetBoundsSystem();
+
+        if (bounds_system.WasRebuilt())
+        {
+            RebuildMeshes();
+        }
+        else
+        {
+            auto &bounds = bounds_system.GetBounds();
+            for (auto index : bounds_system.GetChangedIndices())
+                m_MeshBVH.Update(index, bounds[index]);
+
+            m_MeshBVH.Refit();
+        }
+
+        if (m_LightsDirty)
+        {
+            RebuildLights();
+        }
+        else
+        {
+            for (auto entity : m_Scene.GetTransformSystem().GetChangedEntities())
+            {
+                auto light_it = m_LightItems.find(entity);
+                if (light_it != m_LightItems.end())
+                    m_LightBVH.Update(light_it->second, ComputeLightBounds(entity));
+            }
+
+            m_LightBVH.Refit();
+        }
+    }
+
+    void SpatialSystem::CullMeshes(const sg::Frustum &frustum, sg::BVH::CullResult &result) const
+    {
+        m_MeshBVH.Cull(frustum, result);
+    }
+
+    bool SpatialSystem::Pick(const glm::vec3 &origin, const glm::vec3 &direction, entt::entity &entity, float &distance) const
+    {
+        uint32_t item;
+        if (!m_MeshBVH.Raycast(origin, direction, std::numeric_limits<float>::max(), item, distance))
+            return false;
+
+        entity = m_Scene.GetBoundsSystem().GetEntities()[item];
+        return true;
+    }
+
+    void SpatialSystem::FindNearestLights(const glm::vec3 &point, size_t count, std::vector<std::pair<float, uint32_t>> &results) const
+    {
+        m_LightBVH.FindNearest(point, count, results);
+    }
+
+    void SpatialSystem::OnLightsChanged(entt::registry & /*registry*/, entt::entity /*entity*/)
+    {
+        m_LightsDirty = true;
+    }
+
+    void SpatialSystem::RebuildMeshes()
+    {
+        Timer timer;
+        timer.Start();
+
+        auto &bounds = m_Scene.GetBoundsSystem().GetBounds();
+        m_MeshBVH.Build(bounds);
+
+        auto elapsed_time = timer.Stop<Timer::Milliseconds>();
+        ENG_CORE_TRACE("Built mesh BVH over {} meshes in {} ms.", bounds.size(), elapsed_time);
+    }
+
+    void SpatialSystem::RebuildLights()
+    {
+        auto view = m_Scene.GetRegistry().view<sg::Light, sg::Transform>();
+
+        m_LightEntities.clear();
+        m_LightItems.clear();
+
+        std::vector<sg::AABB> bounds;
+
+        for (auto entity : view)
+        {
+            // Directional lights reach everything, they don't belong in a spatial query
+            if (view.get<sg::Light>(entity).GetLightType() == sg::LightType::Directional)
+                continue;
+
+            m_LightItems[entity] = ToUint32_t(m_LightEntities.size());
+            m_LightEntities.push_back(entity);
+            bounds.push_back(ComputeLightBounds(entity));
+        }
+
+        m_LightBVH.Build(bounds);
+        m_LightsDirty = false;
+    }
+
+    sg::AABB SpatialSystem::ComputeLightBounds(entt::entity entity) const
+    {
+        auto &registry = m_Scene.GetRegistry();
+        auto &light = registry.get<sg::Light>(entity);
+        glm::vec3 position{registry.get<sg::Transform>(entity).GetWorldMatrix()[3]};
+
+        glm::vec3 range{light.GetLightProperties().range};
+        return sg::AABB{position - range, position + range};
+    }
+}
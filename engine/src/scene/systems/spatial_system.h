@@ -0,0 +1,51 @@
+#pragma once
+
+#include "scene/bvh.h"
+
+ENG_DISABLE_WARNINGS()
+#include <entt/entt.hpp>
+ENG_ENABLE_WARNINGS()
+
+#include <unordered_map>
+
+namespace engine
+{
+    class Scene;
+
+    // Keeps bounding volume hierarchies over the world bounds of meshes and local lights
+    class SpatialSystem
+    {
+    public:
+        SpatialSystem(Scene &scene);
+        ~SpatialSystem();
+
+        SpatialSystem(const SpatialSystem &) = delete;
+        SpatialSystem &operator=(const SpatialSystem &) = delete;
+
+        // Rebuilds after meshes or lights were added or removed, otherwise refits changed transforms
+        void Update();
+
+        void CullMeshes(const sg::Frustum &frustum, sg::BVH::CullResult &result) const;
+        bool Pick(const glm::vec3 &origin, const glm::vec3 &direction, entt::entity &entity, float &distance) const;
+        void FindNearestLights(const glm::vec3 &point, size_t count, std::vector<std::pair<float, uint32_t>> &results) const;
+
+        // Mesh items are indices into the BoundsSystem arrays
+        entt::entity GetLightEntity(uint32_t item) const { return m_LightEntities[item]; }
+
+    private:
+        void OnLightsChanged(entt::registry &registry, entt::entity entity);
+
+        void RebuildMeshes();
+        void RebuildLights();
+        sg::AABB ComputeLightBounds(entt::entity entity) const;
+
+        Scene &m_Scene;
+
+        sg::BVH m_MeshBVH;
+
+        bool m_LightsDirty{true};
+        sg::BVH m_LightBVH;
+        std::vector<entt::entity> m_LightEntities;
+        std::unordered_map<entt::entity, uint32_t> m_LightItems;
+    };
+}
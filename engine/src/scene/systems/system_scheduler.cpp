@@ -0,0 +1,176 @@
+#include "scene/systems/system_scheduler.h"
+
+namespace engine
+{
+    namespace
+    {
+        bool Intersects(const std::vector<entt::id_type> &first, const std::vector<entt::id_type> &second)
+        {
+            for (auto type : first)
+            {
+                if (std::find(second.begin(), second.end(), type) != second.end())
+                    return true;
+            }
+
+            return false;
+        }
+    }
+
+    bool SystemAccess::ConflictsWith(const SystemAccess &other) const
+    {
+        return Intersects(m_Writes, other.m_Writes) ||
+               Intersects(m_Writes, other.m_Reads) ||
+               Intersects(m_Reads, other.m_Writes);
+    }
+
+    SystemScheduler::SystemScheduler(entt::registry &registry)
+        : m_Registry(registry)
+    {
+    }
+
+    SystemScheduler::~SystemScheduler()
+    {
+    }
+
+    void SystemScheduler::AddSystem(const std::string &name, const SystemAccess &access, SystemFunction function, bool main_thread)
+    {
+        System system{};
+        system.name = name;
+        system.access = access;
+        system.function = std::move(function);
+        system.main_thread = main_thread;
+
+        auto index = ToUint32_t(m_Systems.size());
+
+        // Conflicting systems keep the order they were added in
+        for (uint32_t other = 0; other < index; other++)
+        {
+            if (m_Systems[other].access.ConflictsWith(access))
+            {
+                system.dependencies.push_back(other);
+                m_Systems[other].dependents.push_back(index);
+            }
+        }
+
+        for (auto assure_storage : access.m_AssureStorage)
+            assure_storage(m_Registry);
+
+        ENG_CORE_TRACE("Scheduled system {} after {} conflicting systems", name, system.dependencies.size());
+
+        m_Systems.push_back(std::move(system));
+    }
+
+    void SystemScheduler::Run(float delta_time)
+    {
+        if (m_Systems.empty())
+            return;
+
+        for (auto &system : m_Systems)
+            system.pending = ToUint32_t(system.dependencies.size());
+
+        for (uint32_t index = 0; index < m_Systems.size(); index++)
+        {
+            if (m_Systems[index].dependencies.empty())
+                Submit(index, delta_time);
+        }
+
+        // Dependents still run, the first exception is rethrown once every system finished
+        std::exception_ptr exception;
+
+        while (true)
+        {
+            std::vector<uint32_t> ready;
+
+            {
+                std::lock_guard<std::mutex> lock(m_Mutex);
+                ready.swap(m_MainThreadReady);
+            }
+
+            if (ready.empty())
+            {
+                // Dependents are submitted before the job finishing their last dependency counts down,
+                // so once the jobs are done every system ran unless a main thread system became ready
+                try
+                {
+                    JobSystem::Get().Wait(m_Counter);
+                }
+                catch (...)
+                {
+                    if (!exception)
+                        exception = std::current_exception();
+                }
+
+                std::lock_guard<std::mutex> lock(m_Mutex);
+                if (m_MainThreadReady.empty())
+                    break;
+
+                continue;
+            }
+
+            for (auto system : ready)
+            {
+                auto system_exception = Execute(system, delta_time);
+                if (system_exception && !exception)
+                    exception = system_exception;
+            }
+        }
+
+        if (exception)
+            std::rethrow_exception(exception);
+    }
+
+    void SystemScheduler::Submit(uint32_t system, float delta_time)
+    {
+        if (m_Systems[system].main_thread)
+        {
+            std::lock_guard<std::mutex> lock(m_Mutex);
+            m_MainThreadReady.push_back(system);
+            return;
+        }
+
+        JobSystem::Get().Run(
+            [this, system, delta_time]()
+            {
+                auto exception = Execute(system, delta_time);
+
+                if (exception)
+                    std::rethrow_exception(exception);
+            },
+            &m_Counter);
+    }
+
+    std::exception_ptr SystemScheduler::Execute(uint32_t system, float delta_time)
+    {
+        std::exception_ptr exception;
+
+        try
+        {
+            m_Systems[system].function(delta_time);
+        }
+        catch (...)
+        {
+            exception = std::current_exception();
+        }
+
+        Finish(system, delta_time);
+        return exception;
+    }
+
+    void SystemScheduler::Finish(uint32_t system, float delta_time)
+    {
+        std::vector<uint32_t> ready;
+
+        {
+            std::lock_guard<std::mutex> lock(m_Mutex);
+
+            for (auto dependent : m_Systems[system].dependents)
+            {
+                if (--m_Systems[dependent].pending == 0)
+                    ready.push_back(dependent);
+            }
+        }
+
+        for (auto dependent : ready)
+            Submit(dependent, delta_time);
+    }
+}
@@ -0,0 +1,99 @@
+#pragma once
+
+#include "core/job_system.h"
+
+ENG_DISABLE_WARNINGS()
+#include <entt/entt.hpp>
+ENG_ENABLE_WARNINGS()
+
+#include <functional>
+#include <initializer_list>
+
+namespace engine
+{
+    // Component types a system reads and writes, two systems conflict when one writes a type the other touches
+    class SystemAccess
+    {
+    public:
+        template <typename... Components>
+        SystemAccess &Read()
+        {
+            static_cast<void>(std::initializer_list<int>{(Add<Components>(m_Reads), 0)...});
+            return *this;
+        }
+
+        template <typename... Components>
+        SystemAccess &Write()
+        {
+            static_cast<void>(std::initializer_list<int>{(Add<Components>(m_Writes), 0)...});
+            return *this;
+        }
+
+        bool ConflictsWith(const SystemAccess &other) const;
+
+    private:
+        friend class SystemScheduler;
+
+        template <typename Component>
+        void Add(std::vector<entt::id_type> &types)
+        {
+            types.push_back(entt::type_hash<Component>::value());
+
+            // Creating a pool changes the registry, so it has to happen before systems run in parallel
+            m_AssureStorage.push_back([](entt::registry &registry)
+                                      { static_cast<void>(registry.view<Component>()); });
+        }
+
+        std::vector<entt::id_type> m_Reads;
+        std::vector<entt::id_type> m_Writes;
+        std::vector<void (*)(entt::registry &)> m_AssureStorage;
+    };
+
+    // Runs systems as jobs, a system starts once every earlier registered system it
+    // conflicts with has finished, non-conflicting systems overlap. Main thread systems
+    // run on the thread calling Run instead
+    class SystemScheduler
+    {
+    public:
+        using SystemFunction = std::function<void(float)>;
+
+        SystemScheduler(entt::registry &registry);
+        ~SystemScheduler();
+
+        SystemScheduler(const SystemScheduler &) = delete;
+        SystemScheduler &operator=(const SystemScheduler &) = delete;
+
+        // main_thread systems are never handed to the job system, e.g. ones polling window input
+        void AddSystem(const std::string &name, const SystemAccess &access, SystemFunction function, bool main_thread = false);
+        // Blocks until every system ran once, rethrows the first exception a system threw
+        void Run(float delta_time);
+
+        size_t GetSystemCount() const { return m_Systems.size(); }
+        const std::vector<uint32_t> &GetDependencies(uint32_t system) const { return m_Systems.at(system).dependencies; }
+
+    private:
+        struct System
+        {
+            std::string name;
+            SystemAccess access;
+            SystemFunction function;
+            bool main_thread{false};
+            std::vector<uint32_t> dependencies;
+            std::vector<uint32_t> dependents;
+            uint32_t pending{0};
+        };
+
+        void Submit(uint32_t system, float delta_time);
+        // Runs the system and submits the dependents it unblocked, returns what it threw
+        std::exception_ptr Execute(uint32_t system, float delta_time);
+        void Finish(uint32_t system, float delta_time);
+
+        entt::registry &m_Registry;
+        std::vector<System> m_Systems;
+
+        std::mutex m_Mutex;
+        JobCounter m_Counter;
+        // Main thread systems whose dependencies finished, guarded by m_Mutex
+        std::vector<uint32_t> m_MainThreadReady;
+    };
+}
@@ -0,0 +1,220 @@
+#include "scene/systems/transform_batch.h"
+
+#include "common/simd.h"
+
+namespace engine
+{
+    namespace
+    {
+#if defined(ENG_SIMD_SSE) || defined(ENG_SIMD_AVX2)
+        inline void StoreColumn(__m128 x, __m128 y, __m128 z, __m128 w, glm::mat4 *matrices, int column)
+        {
+            _MM_TRANSPOSE4_PS(x, y, z, w);
+            _mm_storeu_ps(&matrices[0][column][0], x);
+            _mm_storeu_ps(&matrices[1][column][0], y);
+            _mm_storeu_ps(&matrices[2][column][0], z);
+            _mm_storeu_ps(&matrices[3][column][0], w);
+        }
+#endif
+
+#if defined(ENG_SIMD_AVX2)
+        inline void StoreColumn(__m256 x, __m256 y, __m256 z, __m256 w, glm::mat4 *matrices, int column)
+        {
+            StoreColumn(_mm256_castps256_ps128(x), _mm256_castps256_ps128(y),
+                        _mm256_castps256_ps128(z), _mm256_castps256_ps128(w),
+                        matrices, column);
+
+            StoreColumn(_mm256_extractf128_ps(x, 1), _mm256_extractf128_ps(y, 1),
+                        _mm256_extractf128_ps(z, 1), _mm256_extractf128_ps(w, 1),
+                        matrices + 4, column);
+        }
+
+        // 8 transforms per iteration, returns the first index left for the scalar tail
+        size_t ComposeAVX2(const float *tx, const float *ty, const float *tz,
+                           const float *rx, const float *ry, const float *rz, const float *rw,
+                           const float *sx, const float *sy, const float *sz,
+                           size_t count, glm::mat4 *matrices)
+        {
+            const __m256 one = _mm256_set1_ps(1.0f);
+            const __m256 zero = _mm256_setzero_ps();
+
+            size_t i = 0;
+            for (; i + 8 <= count; i += 8)
+            {
+                __m256 qx = _mm256_loadu_ps(rx + i);
+                __m256 qy = _mm256_loadu_ps(ry + i);
+                __m256 qz = _mm256_loadu_ps(rz + i);
+                __m256 qw = _mm256_loadu_ps(rw + i);
+
+                __m256 x2 = _mm256_add_ps(qx, qx);
+                __m256 y2 = _mm256_add_ps(qy, qy);
+                __m256 z2 = _mm256_add_ps(qz, qz);
+
+                __m256 xx = _mm256_mul_ps(qx, x2);
+                __m256 yy = _mm256_mul_ps(qy, y2);
+                __m256 zz = _mm256_mul_ps(qz, z2);
+                __m256 xy = _mm256_mul_ps(qx, y2);
+                __m256 xz = _mm256_mul_ps(qx, z2);
+                __m256 yz = _mm256_mul_ps(qy, z2);
+                __m256 wx = _mm256_mul_ps(qw, x2);
+                __m256 wy = _mm256_mul_ps(qw, y2);
+                __m256 wz = _mm256_mul_ps(qw, z2);
+
+                __m256 scale_x = _mm256_loadu_ps(sx + i);
+                __m256 scale_y = _mm256_loadu_ps(sy + i);
+                __m256 scale_z = _mm256_loadu_ps(sz + i);
+
+                StoreColumn(_mm256_mul_ps(_mm256_sub_ps(one, _mm256_add_ps(yy, zz)), scale_x),
+                            _mm256_mul_ps(_mm256_add_ps(xy, wz), scale_x),
+                            _mm256_mul_ps(_mm256_sub_ps(xz, wy), scale_x),
+                            zero, matrices + i, 0);
+
+                StoreColumn(_mm256_mul_ps(_mm256_sub_ps(xy, wz), scale_y),
+                            _mm256_mul_ps(_mm256_sub_ps(one, _mm256_add_ps(xx, zz)), scale_y),
+                            _mm256_mul_ps(_mm256_add_ps(yz, wx), scale_y),
+                            zero, matrices + i, 1);
+
+                StoreColumn(_mm256_mul_ps(_mm256_add_ps(xz, wy), scale_z),
+                            _mm256_mul_ps(_mm256_sub_ps(yz, wx), scale_z),
+                            _mm256_mul_ps(_mm256_sub_ps(one, _mm256_add_ps(xx, yy)), scale_z),
+                            zero, matrices + i, 2);
+
+                StoreColumn(_mm256_loadu_ps(tx + i), _mm256_loadu_ps(ty + i), _mm256_loadu_ps(tz + i),
+                            one, matrices + i, 3);
+            }
+
+            return i;
+        }
+#endif
+
+#if defined(ENG_SIMD_SSE) || defined(ENG_SIMD_AVX2)
+        // 4 transforms per iteration, returns the first index left for the scalar tail
+        size_t ComposeSSE(const float *tx, const float *ty, const float *tz,
+                          const float *rx, const float *ry, const float *rz, const float *rw,
+                          const float *sx, const float *sy, const float *sz,
+                          size_t begin, size_t count, glm::mat4 *matrices)
+        {
+            const __m128 one = _mm_set1_ps(1.0f);
+            const __m128 zero = _mm_setzero_ps();
+
+            size_t i = begin;
+            for (; i + 4 <= count; i += 4)
+            {
+                __m128 qx = _mm_loadu_ps(rx + i);
+                __m128 qy = _mm_loadu_ps(ry + i);
+                __m128 qz = _mm_loadu_ps(rz + i);
+                __m128 qw = _mm_loadu_ps(rw + i);
+
+                __m128 x2 = _mm_add_ps(qx, qx);
+                __m128 y2 = _mm_add_ps(qy, qy);
+                __m128 z2 = _mm_add_ps(qz, qz);
+
+                __m128 xx = _mm_mul_ps(qx, x2);
+                __m128 yy = _mm_mul_ps(qy, y2);
+                __m128 zz = _mm_mul_ps(qz, z2);
+                __m128 xy = _mm_mul_ps(qx, y2);
+                __m128 xz = _mm_mul_ps(qx, z2);
+                __m128 yz = _mm_mul_ps(qy, z2);
+                __m128 wx = _mm_mul_ps(qw, x2);
+                __m128 wy = _mm_mul_ps(qw, y2);
+                __m128 wz = _mm_mul_ps(qw, z2);
+
+                __m128 scale_x = _mm_loadu_ps(sx + i);
+                __m128 scale_y = _mm_loadu_ps(sy + i);
+                __m128 scale_z = _mm_loadu_ps(sz + i);
+
+                StoreColumn(_mm_mul_ps(_mm_sub_ps(one, _mm_add_ps(yy, zz)), scale_x),
+                            _mm_mul_ps(_mm_add_ps(xy, wz), scale_x),
+                            _mm_mul_ps(_mm_sub_ps(xz, wy), scale_x),
+                            zero, matrices + i, 0);
+
+                StoreColumn(_mm_mul_ps(_mm_sub_ps(xy, wz), scale_y),
+                            _mm_mul_ps(_mm_sub_ps(one, _mm_add_ps(xx, zz)), scale_y),
+                            _mm_mul_ps(_mm_add_ps(yz, wx), scale_y),
+                            zero, matrices + i, 1);
+
+                StoreColumn(_mm_mul_ps(_mm_add_ps(xz, wy), scale_z),
+                            _mm_mul_ps(_mm_sub_ps(yz, wx), scale_z),
+                            _mm_mul_ps(_mm_sub_ps(one, _mm_add_ps(xx, yy)), scale_z),
+                            zero, matrices + i, 2);
+
+                StoreColumn(_mm_loadu_ps(tx + i), _mm_loadu_ps(ty + i), _mm_loadu_ps(tz + i),
+                            one, matrices + i, 3);
+            }
+
+            return i;
+        }
+#endif
+    }
+
+    glm::mat4 ComposeTRS(const glm::vec3 &translation, const glm::quat &rotation, const glm::vec3 &scale)
+    {
+        float x2 = rotation.x + rotation.x;
+        float y2 = rotation.y + rotation.y;
+        float z2 = rotation.z + rotation.z;
+
+        float xx = rotation.x * x2, yy = rotation.y * y2, zz = rotation.z * z2;
+        float xy = rotation.x * y2, xz = rotation.x * z2, yz = rotation.y * z2;
+        float wx = rotation.w * x2, wy = rotation.w * y2, wz = rotation.w * z2;
+
+        glm::mat4 matrix;
+        matrix[0] = glm::vec4((1.0f - (yy + zz)) * scale.x, (xy + wz) * scale.x, (xz - wy) * scale.x, 0.0f);
+        matrix[1] = glm::vec4((xy - wz) * scale.y, (1.0f - (xx + zz)) * scale.y, (yz + wx) * scale.y, 0.0f);
+        matrix[2] = glm::vec4((xz + wy) * scale.z, (yz - wx) * scale.z, (1.0f - (xx + yy)) * scale.z, 0.0f);
+        matrix[3] = glm::vec4(translation, 1.0f);
+
+        return matrix;
+    }
+
+    void TransformBatch::Resize(size_t count)
+    {
+        m_Size = count;
+
+        for (auto *array : {&m_TranslationX, &m_TranslationY, &m_TranslationZ,
+                            &m_RotationX, &m_RotationY, &m_RotationZ, &m_RotationW,
+                            &m_ScaleX, &m_ScaleY, &m_ScaleZ})
+            array->resize(count);
+    }
+
+    void TransformBatch::Set(size_t index, const glm::vec3 &translation, const glm::quat &rotation, const glm::vec3 &scale)
+    {
+        m_TranslationX[index] = translation.x;
+        m_TranslationY[index] = translation.y;
+        m_TranslationZ[index] = translation.z;
+
+        m_RotationX[index] = rotation.x;
+        m_RotationY[index] = rotation.y;
+        m_RotationZ[index] = rotation.z;
+        m_RotationW[index] = rotation.w;
+
+        m_ScaleX[index] = scale.x;
+        m_ScaleY[index] = scale.y;
+        m_ScaleZ[index] = scale.z;
+    }
+
+    void TransformBatch::Compose(glm::mat4 *matrices) const
+    {
+        size_t i = 0;
+
+#if defined(ENG_SIMD_AVX2)
+        i = ComposeAVX2(m_TranslationX.data(), m_TranslationY.data(), m_TranslationZ.data(),
+                        m_RotationX.data(), m_RotationY.data(), m_RotationZ.data(), m_RotationW.data(),
+                        m_ScaleX.data(), m_ScaleY.data(), m_ScaleZ.data(),
+                        m_Size, matrices);
+#endif
+
+#if defined(ENG_SIMD_SSE) || defined(ENG_SIMD_AVX2)
+        i = ComposeSSE(m_TranslationX.data(), m_TranslationY.data(), m_TranslationZ.data(),
+                       m_RotationX.data(), m_RotationY.data(), m_RotationZ.data(), m_RotationW.data(),
+                       m_ScaleX.data(), m_ScaleY.data(), m_ScaleZ.data(),
+                       i, m_Size, matrices);
+#endif
+
+        for (; i < m_Size; i++)
+        {
+            matrices[i] = ComposeTRS({m_TranslationX[i], m_TranslationY[i], m_TranslationZ[i]},
+                                     glm::quat(m_RotationW[i], m_RotationX[i], m_RotationY[i], m_RotationZ[i]),
+                                     {m_ScaleX[i], m_ScaleY[i], m_ScaleZ[i]});
+        }
+    }
+}
@@ -0,0 +1,34 @@
+#pragma once
+
+#include "common/glm.h"
+
+ENG_DISABLE_WARNINGS()
+#include <glm/gtc/quaternion.hpp>
+ENG_ENABLE_WARNINGS()
+
+namespace engine
+{
+    // Structure of arrays copy of the local TRS of many transforms
+    class TransformBatch
+    {
+    public:
+        TransformBatch() = default;
+        ~TransformBatch() = default;
+
+        void Resize(size_t count);
+        void Set(size_t index, const glm::vec3 &translation, const glm::quat &rotation, const glm::vec3 &scale);
+        size_t GetSize() const { return m_Size; }
+
+        // Writes translate * rotate * scale of every element into matrices
+        void Compose(glm::mat4 *matrices) const;
+
+    private:
+        size_t m_Size{0};
+
+        std::vector<float> m_TranslationX, m_TranslationY, m_TranslationZ;
+        std::vector<float> m_RotationX, m_RotationY, m_RotationZ, m_RotationW;
+        std::vector<float> m_ScaleX, m_ScaleY, m_ScaleZ;
+    };
+
+    glm::mat4 ComposeTRS(const glm::vec3 &translation, const glm::quat &rotation, const glm::vec3 &scale);
+}
@@ -0,0 +1,225 @@
+#include "scene/systems/transform_system.h"
+
+#include "scene/scene.h"
+#include "scene/entity.h"
+#include "scene/components/hierarchy.h"
+#include "scene/components/transform.h"
+
+namespace engine
+{
+    TransformSystem::TransformSystem(Scene &scene)
+        : m_Scene(scene)
+    {
+        auto &registry = m_Scene.GetRegistry();
+        registry.on_construct<sg::Transform>().connect<&TransformSystem::OnTopologyChanged>(*this);
+        registry.on_destroy<sg::Transform>().connect<&TransformSystem::OnTopologyChanged>(*this);
+        registry.on_destroy<sg::Hierarchy>().connect<&TransformSystem::OnHierarchyDestroyed>(*this);
+    }
+
+    TransformSystem::~TransformSystem()
+    {
+        auto &registry = m_Scene.GetRegistry();
+        registry.on_construct<sg::Transform>().disconnect<&TransformSystem::OnTopologyChanged>(*this);
+        registry.on_destroy<sg::Transform>().disconnect<&TransformSystem::OnTopologyChanged>(*this);
+        registry.on_destroy<sg::Hierarchy>().disconnect<&TransformSystem::OnHierarchyDestroyed>(*this);
+    }
+
+    void TransformSystem::SetParent(Entity child, Entity parent)
+    {
+        auto &registry = m_Scene.GetRegistry();
+        entt::entity child_handle = child.GetHandle();
+        entt::entity parent_handle = parent.GetHandle();
+
+        for (auto ancestor = parent_handle; ancestor != entt::null;)
+        {
+            if (ancestor == child_handle)
+                throw std::runtime_error("Cannot parent an entity to itself or one of its descendants");
+
+            auto *hierarchy = registry.try_get<sg::Hierarchy>(ancestor);
+            ancestor = hierarchy ? hierarchy->m_Parent : entt::null;
+        }
+
+        Unlink(child_handle);
+
+        // Emplace both before taking references, the second emplace can move the pool
+        registry.get_or_emplace<sg::Hierarchy>(child_handle);
+        registry.get_or_emplace<sg::Hierarchy>(parent_handle);
+
+        registry.get<sg::Hierarchy>(child_handle).m_Parent = parent_handle;
+        registry.get<sg::Hierarchy>(parent_handle).m_Children.push_back(child_handle);
+
+        m_TopologyDirty = true;
+    }
+
+    void TransformSystem::RemoveParent(Entity child)
+    {
+        Unlink(child.GetHandle());
+        m_TopologyDirty = true;
+    }
+
+    void TransformSystem::Invalidate(entt::entity entity)
+    {
+        if (!m_TopologyDirty)
+            m_PendingInvalidations.push_back(entity);
+    }
+
+    void TransformSystem::Update()
+    {
+        auto &registry = m_Scene.GetRegistry();
+        size_t first_dirty = m_Entities.size();
+
+        m_ChangedEntities.clear();
+
+        if (m_TopologyDirty)
+        {
+            Rebuild();
+            first_dirty = 0;
+        }
+        else
+        {
+            for (auto entity : m_PendingInvalidations)
+            {
+                if (!registry.valid(entity) || !registry.all_of<sg::Transform>(entity))
+                    continue;
+
+                size_t index = registry.get<sg::Transform>(entity).m_NodeIndex;
+                m_Dirty[index] = 1;
+                first_dirty = std::min(first_dirty, index);
+            }
+        }
+
+        m_PendingInvalidations.clear();
+
+        m_DirtyIndices.clear();
+
+        for (size_t index = first_dirty; index < m_Entities.size(); index++)
+        {
+            auto parent = m_Parents[index];
+
+            if (parent >= 0 && m_Dirty[parent])
+                m_Dirty[index] = 1;
+
+            if (m_Dirty[index])
+                m_DirtyIndices.push_back(static_cast<uint32_t>(index));
+        }
+
+        if (m_DirtyIndices.empty())
+            return;
+
+        m_Batch.Resize(m_DirtyIndices.size());
+        m_LocalMatrices.resize(m_DirtyIndices.size());
+
+        for (size_t i = 0; i < m_DirtyIndices.size(); i++)
+        {
+            auto &transform = *m_Transforms[m_DirtyIndices[i]];
+            m_Batch.Set(i, transform.GetTranslation(), transform.GetRotation(), transform.GetScale());
+        }
+
+        m_Batch.Compose(m_LocalMatrices.data());
+
+        // Indices are ascending, so parents are always resolved before their children
+        for (size_t i = 0; i < m_DirtyIndices.size(); i++)
+        {
+            auto index = m_DirtyIndices[i];
+            auto parent = m_Parents[index];
+
+            if (parent >= 0)
+                m_WorldMatrices[index] = m_WorldMatrices[parent] * m_LocalMatrices[i];
+            else
+                m_WorldMatrices[index] = m_LocalMatrices[i];
+
+            auto &transform = *m_Transforms[index];
+            transform.m_WorldMatrix = m_WorldMatrices[index];
+            transform.m_UpdateWorldMatrix = false;
+            m_Dirty[index] = 0;
+
+            m_ChangedEntities.push_back(m_Entities[index]);
+        }
+    }
+
+    void TransformSystem::OnTopologyChanged(entt::registry & /*registry*/, entt::entity /*entity*/)
+    {
+        m_TopologyDirty = true;
+        m_PendingInvalidations.clear();
+    }
+
+    void TransformSystem::OnHierarchyDestroyed(entt::registry &registry, entt::entity entity)
+    {
+        Unlink(entity);
+
+        for (auto child : registry.get<sg::Hierarchy>(entity).m_Children)
+        {
+            if (auto *hierarchy = registry.try_get<sg::Hierarchy>(child))
+                hierarchy->m_Parent = entt::null;
+        }
+
+        m_TopologyDirty = true;
+    }
+
+    void TransformSystem::Unlink(entt::entity child)
+    {
+        auto &registry = m_Scene.GetRegistry();
+        auto *hierarchy = registry.try_get<sg::Hierarchy>(child);
+
+        if (!hierarchy || hierarchy->m_Parent == entt::null)
+            return;
+
+        if (auto *parent_hierarchy = registry.try_get<sg::Hierarchy>(hierarchy->m_Parent))
+        {
+            auto &children = parent_hierarchy->m_Children;
+            children.erase(std::remove(children.begin(), children.end(), child), children.end());
+        }
+
+        hierarchy->m_Parent = entt::null;
+    }
+
+    void TransformSystem::Rebuild()
+    {
+        auto &registry = m_Scene.GetRegistry();
+
+        m_Entities.clear();
+        m_Transforms.clear();
+        m_Parents.clear();
+
+        auto add_node = [&](entt::entity entity, int32_t parent)
+        {
+            auto &transform = registry.get<sg::Transform>(entity);
+            transform.m_NodeIndex = static_cast<uint32_t>(m_Entities.size());
+
+            m_Entities.push_back(entity);
+            m_Transforms.push_back(&transform);
+            m_Parents.push_back(parent);
+        };
+
+        auto has_transform = [&](entt::entity entity)
+        {
+            return entity != entt::null && registry.valid(entity) && registry.all_of<sg::Transform>(entity);
+        };
+
+        auto view = registry.view<sg::Transform>();
+        for (auto entity : view)
+        {
+            auto *hierarchy = registry.try_get<sg::Hierarchy>(entity);
+            if (!hierarchy || !has_transform(hierarchy->m_Parent))
+                add_node(entity, -1);
+        }
+
+        for (size_t index = 0; index < m_Entities.size(); index++)
+        {
+            auto *hierarchy = registry.try_get<sg::Hierarchy>(m_Entities[index]);
+            if (!hierarchy)
+                continue;
+
+            for (auto child : hierarchy->m_Children)
+            {
+                if (has_transform(child))
+                    add_node(child, static_cast<int32_t>(index));
+            }
+        }
+
+        m_WorldMatrices.resize(m_Entities.size());
+        m_Dirty.assign(m_Entities.size(), 1);
+
+        m_TopologyDirty = false;
+    }
+}
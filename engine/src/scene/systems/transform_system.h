@@ -0,0 +1,60 @@
+#pragma once
+
+#include "scene/systems/transform_batch.h"
+
+ENG_DISABLE_WARNINGS()
+#include <entt/entt.hpp>
+ENG_ENABLE_WARNINGS()
+
+namespace engine
+{
+    class Scene;
+    class Entity;
+
+    namespace sg
+    {
+        class Transform;
+    }
+
+    class TransformSystem
+    {
+    public:
+        TransformSystem(Scene &scene);
+        ~TransformSystem();
+
+        TransformSystem(const TransformSystem &) = delete;
+        TransformSystem &operator=(const TransformSystem &) = delete;
+
+        void SetParent(Entity child, Entity parent);
+        void RemoveParent(Entity child);
+        void Invalidate(entt::entity entity);
+        void Update();
+
+        size_t GetNodeCount() const { return m_Entities.size(); }
+        // Entities whose world matrix was recomputed by the last Update
+        const std::vector<entt::entity> &GetChangedEntities() const { return m_ChangedEntities; }
+
+    private:
+        void OnTopologyChanged(entt::registry &registry, entt::entity entity);
+        void OnHierarchyDestroyed(entt::registry &registry, entt::entity entity);
+        void Unlink(entt::entity child);
+        void Rebuild();
+
+        Scene &m_Scene;
+        bool m_TopologyDirty{true};
+
+        // Breadth-first order, a parent always comes before its children
+        std::vector<entt::entity> m_Entities;
+        std::vector<sg::Transform *> m_Transforms;
+        std::vector<int32_t> m_Parents;
+        std::vector<glm::mat4> m_WorldMatrices;
+        std::vector<uint8_t> m_Dirty;
+
+        std::vector<entt::entity> m_PendingInvalidations;
+        std::vector<entt::entity> m_ChangedEntities;
+
+        std::vector<uint32_t> m_DirtyIndices;
+        TransformBatch m_Batch;
+        std::vector<glm::mat4> m_LocalMatrices;
+    };
+}
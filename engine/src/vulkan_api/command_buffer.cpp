@@ -560,6 +560,27 @@ namespace engine
             &image_memory_barrier);
     }
 
+    void CommandBuffer::CreateBufferMemoryBarrier(const core::Buffer &buffer, VkDeviceSize offset, VkDeviceSize size, const BufferMemoryBarrier &memory_barrier)
+    {
+        VkBufferMemoryBarrier buffer_memory_barrier{VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER};
+        buffer_memory_barrier.srcAccessMask = memory_barrier.src_access_mask;
+        buffer_memory_barrier.dstAccessMask = memory_barrier.dst_access_mask;
+        buffer_memory_barrier.srcQueueFamilyIndex = memory_barrier.old_queue_family;
+        buffer_memory_barrier.dstQueueFamilyIndex = memory_barrier.new_queue_family;
+        buffer_memory_barrier.buffer = buffer.GetHandle();
+        buffer_memory_barrier.offset = offset;
+        buffer_memory_barrier.size = size;
+
+        vkCmdPipelineBarrier(
+            m_Handle,
+            memory_barrier.src_stage_mask,
+            memory_barrier.dst_stage_mask,
+            0,
+            0, nullptr,
+            1, &buffer_memory_barrier,
+            0, nullptr);
+    }
+
     const bool CommandBuffer::IsRenderSizeOptimal(const VkExtent2D &framebuffer_extent, const VkRect2D &render_area)
     {
         auto render_area_granularity = m_CurrentRenderPass.render_pass->GetRenderAreaGranularity();
@@ -579,6 +600,11 @@ namespace engine
         vkCmdSetScissor(m_Handle, first_scissor, ToUint32_t(scissors.size()), scissors.data());
     }
 
+    void CommandBuffer::CopyBuffer(const core::Buffer &src_buffer, const core::Buffer &dst_buffer, const std::vector<VkBufferCopy> &regions)
+    {
+        vkCmdCopyBuffer(m_Handle, src_buffer.GetHandle(), dst_buffer.GetHandle(), ToUint32_t(regions.size()), regions.data());
+    }
+
     void CommandBuffer::CopyBufferToImage(const core::Buffer &buffer, const core::Image &image, const std::vector<VkBufferImageCopy> &regions)
     {
         vkCmdCopyBufferToImage(m_Handle, buffer.GetHandle(),
@@ -603,6 +629,12 @@ namespace engine
         vkCmdDrawIndexed(m_Handle, index_count, instance_count, first_index, vertex_offset, first_instance);
     }
 
+    void CommandBuffer::Dispatch(uint32_t group_count_x, uint32_t group_count_y, uint32_t group_count_z)
+    {
+        Flush(VK_PIPELINE_BIND_POINT_COMPUTE);
+        vkCmdDispatch(m_Handle, group_count_x, group_count_y, group_count_z);
+    }
+
     void CommandBuffer::SetSpecializationConstant(uint32_t constant_id, const std::vector<uint8_t> &data)
     {
         m_PipelineState.SetSpecializationConstant(constant_id, data);
@@ -60,6 +60,7 @@ namespace engine
         VkResult Reset(ResetMode reset_mode);
 
         void CreateImageMemoryBarrier(const core::ImageView &image_view, const ImageMemoryBarrier &memory_barrier);
+        void CreateBufferMemoryBarrier(const core::Buffer &buffer, VkDeviceSize offset, VkDeviceSize size, const BufferMemoryBarrier &memory_barrier);
         const bool IsRenderSizeOptimal(const VkExtent2D &framebuffer_extent, const VkRect2D &render_area);
         void SetViewport(uint32_t first_viewport, const std::vector<VkViewport> &viewports);
         void SetScissor(uint32_t first_scissor, const std::vector<VkRect2D> &scissors);
@@ -97,11 +98,13 @@ namespace engine
         void BindIndexBuffer(const core::Buffer &buffer, VkDeviceSize offset, VkIndexType index_type);
 
         void NextSubpass();
+        void CopyBuffer(const core::Buffer &src_buffer, const core::Buffer &dst_buffer, const std::vector<VkBufferCopy> &regions);
         void CopyBufferToImage(const core::Buffer &buffer, const core::Image &image, const std::vector<VkBufferImageCopy> &regions);
         void EndRenderPass();
 
         void Draw(uint32_t vertex_count, uint32_t instance_count, uint32_t first_vertex, uint32_t first_instance);
         void DrawIndexed(uint32_t index_count, uint32_t instance_count, uint32_t first_index, int32_t vertex_offset, uint32_t first_instance);
+        void Dispatch(uint32_t group_count_x, uint32_t group_count_y, uint32_t group_count_z);
 
         template <class T>
         void SetSpecializationConstant(uint32_t constant_id, const T &data);
@@ -9,7 +9,8 @@ namespace engine
         Buffer::Buffer(Device &device, VkDeviceSize size,
                        VkBufferUsageFlags buffer_usage,
                        VmaMemoryUsage memory_usage,
-                       VmaAllocationCreateFlags flags)
+                       VmaAllocationCreateFlags flags,
+                       const std::vector<uint32_t> &queue_families)
             : m_Device(device), m_Size(size)
         {
 #ifdef VK_USE_PLATFORM_MACOS_MVK
@@ -23,6 +24,14 @@ namespace engine
             buffer_info.usage = buffer_usage;
             buffer_info.size = size;
 
+            // Written on one queue family and read on another without ownership transfers
+            if (queue_families.size() > 1)
+            {
+                buffer_info.sharingMode = VK_SHARING_MODE_CONCURRENT;
+                buffer_info.queueFamilyIndexCount = ToUint32_t(queue_families.size());
+                buffer_info.pQueueFamilyIndices = queue_families.data();
+            }
+
             VmaAllocationCreateInfo memory_info{};
             memory_info.flags = flags;
             memory_info.usage = memory_usage;
@@ -12,7 +12,8 @@ namespace engine
             Buffer(Device &device, VkDeviceSize size,
                    VkBufferUsageFlags buffer_usage,
                    VmaMemoryUsage memory_usage,
-                   VmaAllocationCreateFlags flags = VMA_ALLOCATION_CREATE_MAPPED_BIT);
+                   VmaAllocationCreateFlags flags = VMA_ALLOCATION_CREATE_MAPPED_BIT,
+                   const std::vector<uint32_t> &queue_families = {});
             ~Buffer();
 
             Buffer(const Buffer &) = delete;
@@ -21,12 +21,28 @@ namespace engine
             ENG_CORE_WARN("Ignore buffer allocation update");
     }
 
+    void BufferAllocation::Update(const uint8_t *data, size_t size, uint32_t offset)
+    {
+        ENG_ASSERT(m_Buffer, "Invalid buffer pointer");
+
+        if (offset + size <= m_Size)
+            m_Buffer->Update(data, size, ToUint32_t(m_BaseOffset) + offset);
+        else
+            ENG_CORE_WARN("Ignore buffer allocation update");
+    }
+
     core::Buffer &BufferAllocation::GetBuffer()
     {
         ENG_ASSERT(m_Buffer, "Invalid buffer pointer");
         return *m_Buffer;
     }
 
+    const core::Buffer &BufferAllocation::GetBuffer() const
+    {
+        ENG_ASSERT(m_Buffer, "Invalid buffer pointer");
+        return *m_Buffer;
+    }
+
     BufferBlock::BufferBlock(Device &device, VkDeviceSize size, VkBufferUsageFlags usage, VmaMemoryUsage memory_usage)
         : m_Buffer{device, size, usage, memory_usage}
 
@@ -34,7 +50,7 @@ namespace engine
         if (usage == VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT)
             m_Alignment = device.GetGPU().GetProperties().limits.minUniformBufferOffsetAlignment;
 
-        else if (usage == VK_BUFFER_USAGE_STORAGE_BUFFER_BIT)
+        else if (usage & VK_BUFFER_USAGE_STORAGE_BUFFER_BIT)
             m_Alignment = device.GetGPU().GetProperties().limits.minStorageBufferOffsetAlignment;
 
         else if (usage == VK_BUFFER_USAGE_UNIFORM_TEXEL_BUFFER_BIT)
@@ -15,6 +15,7 @@ namespace engine
         BufferAllocation &operator=(BufferAllocation &&) = default;
 
         void Update(const std::vector<uint8_t> &data, uint32_t offset = 0);
+        void Update(const uint8_t *data, size_t size, uint32_t offset = 0);
 
         bool Empty() const
         {
@@ -28,6 +29,7 @@ namespace engine
         }
 
         core::Buffer &GetBuffer();
+        const core::Buffer &GetBuffer() const;
         VkDeviceSize GetSize() const { return m_Size; }
         VkDeviceSize GetOffset() const { return m_BaseOffset; }
 
@@ -0,0 +1,306 @@
+#include "vulkan_api/core/geometry_arena.h"
+
+#include "vulkan_api/command_buffer.h"
+#include "vulkan_api/command_pool.h"
+#include "vulkan_api/device.h"
+#include "vulkan_api/fence_pool.h"
+
+namespace engine
+{
+    namespace
+    {
+        inline VkDeviceSize AlignUp(VkDeviceSize value, VkDeviceSize alignment)
+        {
+            // Vertex strides are not always powers of two
+            return (value + alignment - 1) / alignment * alignment;
+        }
+    }
+
+    GeometryArena::GeometryArena(Device &device, const std::vector<uint32_t> &queue_families, VkDeviceSize vertex_block_size, VkDeviceSize index_block_size)
+        : m_Device(device),
+          m_QueueFamilies(queue_families),
+          m_VertexBlockSize(vertex_block_size),
+          m_IndexBlockSize(index_block_size)
+    {
+    }
+
+    GeometryArena::~GeometryArena()
+    {
+    }
+
+    GeometryArena::Handle GeometryArena::AllocateVertices(VkDeviceSize size, uint32_t stride)
+    {
+        return Allocate(GeometryType::Vertex, size, std::max(stride, 1u));
+    }
+
+    GeometryArena::Handle GeometryArena::AllocateIndices(VkDeviceSize size, uint32_t index_size)
+    {
+        return Allocate(GeometryType::Index, size, std::max(index_size, 1u));
+    }
+
+    GeometryArena::Handle GeometryArena::Allocate(GeometryType type, VkDeviceSize size, VkDeviceSize alignment)
+    {
+        ENG_ASSERT(size > 0, "Allocation size must be greater than zero");
+
+        auto &blocks = GetBlocks(type);
+
+        Range range{};
+        range.type = type;
+        range.size = size;
+        range.alignment = alignment;
+        range.allocated = true;
+
+        bool found = false;
+
+        for (uint32_t block_index = 0; block_index < blocks.size() && !found; block_index++)
+        {
+            if (AllocateFromBlock(blocks[block_index], size, alignment, range.offset))
+            {
+                range.block = block_index;
+                found = true;
+            }
+        }
+
+        if (!found)
+        {
+            auto block_size = std::max(type == GeometryType::Vertex ? m_VertexBlockSize : m_IndexBlockSize, size + alignment);
+
+            ENG_CORE_TRACE("Building #{} geometry arena block ({} bytes)", blocks.size(), block_size);
+
+            Block block{};
+            block.buffer = CreateBuffer(type, block_size);
+            block.free_ranges[0] = block_size;
+            blocks.push_back(std::move(block));
+
+            range.block = ToUint32_t(blocks.size() - 1);
+            AllocateFromBlock(blocks.back(), size, alignment, range.offset);
+        }
+
+        Handle handle;
+
+        if (!m_FreeHandles.empty())
+        {
+            handle = m_FreeHandles.back();
+            m_FreeHandles.pop_back();
+            m_Ranges[handle] = range;
+        }
+        else
+        {
+            handle = ToUint32_t(m_Ranges.size());
+            m_Ranges.push_back(range);
+        }
+
+        return handle;
+    }
+
+    bool GeometryArena::AllocateFromBlock(Block &block, VkDeviceSize size, VkDeviceSize alignment, VkDeviceSize &offset)
+    {
+        // First fit, the leading alignment gap and the tail stay free
+        for (auto it = block.free_ranges.begin(); it != block.free_ranges.end(); ++it)
+        {
+            auto free_offset = it->first;
+            auto free_end = it->first + it->second;
+            auto aligned_offset = AlignUp(free_offset, alignment);
+
+            if (aligned_offset + size > free_end)
+                continue;
+
+            block.free_ranges.erase(it);
+
+            if (aligned_offset > free_offset)
+                block.free_ranges[free_offset] = aligned_offset - free_offset;
+
+            if (aligned_offset + size < free_end)
+                block.free_ranges[aligned_offset + size] = free_end - aligned_offset - size;
+
+            offset = aligned_offset;
+            return true;
+        }
+
+        return false;
+    }
+
+    void GeometryArena::Free(Handle handle)
+    {
+        auto &range = m_Ranges.at(handle);
+        ENG_ASSERT(range.allocated, "Geometry range freed twice");
+
+        ReleaseToBlock(GetBlocks(range.type).at(range.block), range.offset, range.size);
+
+        range.allocated = false;
+        m_FreeHandles.push_back(handle);
+    }
+
+    void GeometryArena::ReleaseToBlock(Block &block, VkDeviceSize offset, VkDeviceSize size)
+    {
+        auto next = block.free_ranges.lower_bound(offset);
+
+        // Merge with the following free range
+        if (next != block.free_ranges.end() && offset + size == next->first)
+        {
+            size += next->second;
+            next = block.free_ranges.erase(next);
+        }
+
+        // Merge with the preceding free range
+        if (next != block.free_ranges.begin())
+        {
+            auto previous = std::prev(next);
+
+            if (previous->first + previous->second == offset)
+            {
+                previous->second += size;
+                return;
+            }
+        }
+
+        block.free_ranges[offset] = size;
+    }
+
+    const core::Buffer &GeometryArena::GetBuffer(Handle handle) const
+    {
+        auto &range = m_Ranges.at(handle);
+        return *GetBlocks(range.type).at(range.block).buffer;
+    }
+
+    void GeometryArena::RecordUploadBarrier(CommandBuffer &command_buffer) const
+    {
+        BufferMemoryBarrier memory_barrier{};
+        memory_barrier.src_stage_mask = VK_PIPELINE_STAGE_TRANSFER_BIT;
+        memory_barrier.dst_stage_mask = VK_PIPELINE_STAGE_VERTEX_INPUT_BIT;
+        memory_barrier.src_access_mask = VK_ACCESS_TRANSFER_WRITE_BIT;
+        memory_barrier.dst_access_mask = VK_ACCESS_VERTEX_ATTRIBUTE_READ_BIT | VK_ACCESS_INDEX_READ_BIT;
+
+        for (auto *blocks : {&m_VertexBlocks, &m_IndexBlocks})
+        {
+            for (auto &block : *blocks)
+                command_buffer.CreateBufferMemoryBarrier(*block.buffer, 0, VK_WHOLE_SIZE, memory_barrier);
+        }
+    }
+
+    bool GeometryArena::IsPacked(const Block &block)
+    {
+        // Only the tail is free
+        return block.free_ranges.empty() ||
+               (block.free_ranges.size() == 1 && block.free_ranges.begin()->first + block.free_ranges.begin()->second == block.buffer->GetSize());
+    }
+
+    bool GeometryArena::IsFragmented() const
+    {
+        for (auto *blocks : {&m_VertexBlocks, &m_IndexBlocks})
+        {
+            for (auto &block : *blocks)
+            {
+                if (!IsPacked(block))
+                    return true;
+            }
+        }
+
+        return false;
+    }
+
+    void GeometryArena::Defragment()
+    {
+        if (!IsFragmented())
+            return;
+
+        auto &command_buffer = m_Device.RequestCommandBuffer();
+        command_buffer.Begin(VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT, 0);
+
+        // Old buffers stay alive until the copies out of them finished
+        std::vector<std::unique_ptr<core::Buffer>> retired_buffers;
+        VkDeviceSize moved_size = 0;
+
+        for (auto type : {GeometryType::Vertex, GeometryType::Index})
+        {
+            auto &blocks = GetBlocks(type);
+
+            std::vector<std::vector<Handle>> live_ranges(blocks.size());
+            for (Handle handle = 0; handle < m_Ranges.size(); handle++)
+            {
+                auto &range = m_Ranges[handle];
+                if (range.allocated && range.type == type)
+                    live_ranges[range.block].push_back(handle);
+            }
+
+            for (uint32_t block_index = 0; block_index < blocks.size(); block_index++)
+            {
+                auto &block = blocks[block_index];
+                auto block_size = block.buffer->GetSize();
+
+                if (IsPacked(block))
+                    continue;
+
+                auto &handles = live_ranges[block_index];
+                std::sort(handles.begin(), handles.end(),
+                          [this](Handle a, Handle b)
+                          { return m_Ranges[a].offset < m_Ranges[b].offset; });
+
+                auto buffer = CreateBuffer(type, block_size);
+
+                std::vector<VkBufferCopy> copy_regions;
+                VkDeviceSize cursor = 0;
+
+                for (auto handle : handles)
+                {
+                    auto &range = m_Ranges[handle];
+                    auto offset = AlignUp(cursor, range.alignment);
+
+                    copy_regions.push_back({range.offset, offset, range.size});
+                    moved_size += range.size;
+
+                    range.offset = offset;
+                    cursor = offset + range.size;
+                }
+
+                if (!copy_regions.empty())
+                    command_buffer.CopyBuffer(*block.buffer, *buffer, copy_regions);
+
+                block.free_ranges.clear();
+                if (cursor < block_size)
+                    block.free_ranges[cursor] = block_size - cursor;
+
+                retired_buffers.push_back(std::move(block.buffer));
+                block.buffer = std::move(buffer);
+            }
+        }
+
+        RecordUploadBarrier(command_buffer);
+        command_buffer.End();
+
+        auto &queue_family = m_Device.GetQueueFamilyByFlags(VK_QUEUE_GRAPHICS_BIT);
+        queue_family.GetQueues()[0].Submit(command_buffer, m_Device.RequestFence());
+
+        m_Device.GetFencePool().Wait();
+        m_Device.GetFencePool().Reset();
+        m_Device.GetCommandPool().ResetPool();
+
+        ENG_CORE_TRACE("Defragmented {} geometry arena blocks, moved {} bytes", retired_buffers.size(), moved_size);
+    }
+
+    size_t GeometryArena::GetBlockCount(GeometryType type) const
+    {
+        return GetBlocks(type).size();
+    }
+
+    VkDeviceSize GeometryArena::GetFreeSize(GeometryType type) const
+    {
+        VkDeviceSize free_size = 0;
+
+        for (auto &block : GetBlocks(type))
+        {
+            for (auto &free_range : block.free_ranges)
+                free_size += free_range.second;
+        }
+
+        return free_size;
+    }
+
+    std::unique_ptr<core::Buffer> GeometryArena::CreateBuffer(GeometryType type, VkDeviceSize size)
+    {
+        VkBufferUsageFlags usage = VK_BUFFER_USAGE_TRANSFER_SRC_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT;
+        usage |= type == GeometryType::Vertex ? VK_BUFFER_USAGE_VERTEX_BUFFER_BIT : VK_BUFFER_USAGE_INDEX_BUFFER_BIT;
+
+        return std::make_unique<core::Buffer>(m_Device, size, usage, VMA_MEMORY_USAGE_GPU_ONLY, 0, m_QueueFamilies);
+    }
+}
@@ -0,0 +1,99 @@
+#pragma once
+
+#include "vulkan_api/core/buffer.h"
+
+#include <map>
+
+namespace engine
+{
+    class Device;
+    class CommandBuffer;
+
+    enum class GeometryType
+    {
+        Vertex,
+        Index
+    };
+
+    // Suballocates the vertex and index ranges of every mesh from a few large device local buffers,
+    // so draws only differ by firstIndex and vertexOffset instead of bound buffers
+    class GeometryArena
+    {
+    public:
+        // Stays valid when defragmenting moves the range behind it
+        using Handle = uint32_t;
+        static constexpr Handle NULL_HANDLE = ~0u;
+
+        struct Range
+        {
+            GeometryType type{GeometryType::Vertex};
+            uint32_t block{0};
+            VkDeviceSize offset{0};
+            VkDeviceSize size{0};
+            VkDeviceSize alignment{1};
+            bool allocated{false};
+        };
+
+        static constexpr VkDeviceSize DEFAULT_VERTEX_BLOCK_SIZE = 64 * 1024 * 1024;
+        static constexpr VkDeviceSize DEFAULT_INDEX_BLOCK_SIZE = 32 * 1024 * 1024;
+
+        // Blocks are shared between the given queue families, like the graphics and upload transfer family
+        GeometryArena(Device &device,
+                      const std::vector<uint32_t> &queue_families = {},
+                      VkDeviceSize vertex_block_size = DEFAULT_VERTEX_BLOCK_SIZE,
+                      VkDeviceSize index_block_size = DEFAULT_INDEX_BLOCK_SIZE);
+        ~GeometryArena();
+
+        GeometryArena(const GeometryArena &) = delete;
+        GeometryArena &operator=(const GeometryArena &) = delete;
+
+        // Aligned to the stride, the range offset divided by it is the vertexOffset of a draw
+        Handle AllocateVertices(VkDeviceSize size, uint32_t stride);
+        // Aligned to the index size, the range offset divided by it is the firstIndex of a draw
+        Handle AllocateIndices(VkDeviceSize size, uint32_t index_size);
+        void Free(Handle handle);
+
+        const Range &GetRange(Handle handle) const { return m_Ranges.at(handle); }
+        const core::Buffer &GetBuffer(Handle handle) const;
+
+        // Makes transfer writes into the arena visible to vertex input
+        void RecordUploadBarrier(CommandBuffer &command_buffer) const;
+
+        // Packs the live ranges of every block into new buffers and waits for the copies,
+        // resets the device command pool so it may only run while no frame is recorded
+        void Defragment();
+        // Some block has free space between its live ranges
+        bool IsFragmented() const;
+
+        size_t GetBlockCount(GeometryType type) const;
+        VkDeviceSize GetFreeSize(GeometryType type) const;
+
+    private:
+        struct Block
+        {
+            std::unique_ptr<core::Buffer> buffer;
+            // Offset to size of each free range, neighbours are merged when freed
+            std::map<VkDeviceSize, VkDeviceSize> free_ranges;
+        };
+
+        static bool IsPacked(const Block &block);
+        Handle Allocate(GeometryType type, VkDeviceSize size, VkDeviceSize alignment);
+        bool AllocateFromBlock(Block &block, VkDeviceSize size, VkDeviceSize alignment, VkDeviceSize &offset);
+        void ReleaseToBlock(Block &block, VkDeviceSize offset, VkDeviceSize size);
+        std::unique_ptr<core::Buffer> CreateBuffer(GeometryType type, VkDeviceSize size);
+
+        std::vector<Block> &GetBlocks(GeometryType type) { return type == GeometryType::Vertex ? m_VertexBlocks : m_IndexBlocks; }
+        const std::vector<Block> &GetBlocks(GeometryType type) const { return type == GeometryType::Vertex ? m_VertexBlocks : m_IndexBlocks; }
+
+        Device &m_Device;
+        std::vector<uint32_t> m_QueueFamilies;
+        VkDeviceSize m_VertexBlockSize;
+        VkDeviceSize m_IndexBlockSize;
+
+        std::vector<Block> m_VertexBlocks;
+        std::vector<Block> m_IndexBlocks;
+
+        std::vector<Range> m_Ranges;
+        std::vector<Handle> m_FreeHandles;
+    };
+}
@@ -179,6 +179,15 @@ namespace engine
 
     VkResult Device::WaitIdle()
     {
+        // Waiting for the device counts as using every queue
+        std::vector<std::unique_lock<std::mutex>> locks;
+
+        for (auto &queue_family : m_QueueFamilies)
+        {
+            for (auto &queue : queue_family.GetQueues())
+                locks.push_back(queue.Lock());
+        }
+
         return vkDeviceWaitIdle(m_Handle);
     }
 
@@ -254,6 +263,21 @@ namespace engine
         throw std::runtime_error("Queue not found");
     }
 
+    QueueFamily *Device::FindDedicatedQueueFamily(VkQueueFlags required_queue_flags, VkQueueFlags excluded_queue_flags)
+    {
+        for (auto &queue_family : m_QueueFamilies)
+        {
+            VkQueueFlags queue_flags = queue_family.GetProperties().queueFlags;
+
+            if ((queue_flags & required_queue_flags) == required_queue_flags &&
+                (queue_flags & excluded_queue_flags) == 0 &&
+                !queue_family.GetQueues().empty())
+                return &queue_family;
+        }
+
+        return nullptr;
+    }
+
     VkFence Device::RequestFence()
     {
         return m_FencePool->RequestFence();
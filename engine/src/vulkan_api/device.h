@@ -5,6 +5,8 @@
 #include "vulkan_api/queue.h"
 #include "vulkan_api/queue_family.h"
 
+#include <atomic>
+
 namespace engine
 {
     class CommandPool;
@@ -26,6 +28,8 @@ namespace engine
         const QueueFamily &GetSuitableGraphicsQueueFamily();
 
         QueueFamily &GetQueueFamilyByFlags(VkQueueFlags required_queue_flags);
+        // Family with the required flags and none of the excluded ones, like a transfer only family, null if there is none
+        QueueFamily *FindDedicatedQueueFamily(VkQueueFlags required_queue_flags, VkQueueFlags excluded_queue_flags);
         void CheckIfPresentSupported(VkSurfaceKHR surface);
         VkFence RequestFence();
         CommandBuffer &RequestCommandBuffer();
@@ -38,6 +42,11 @@ namespace engine
         CommandPool &GetCommandPool() { return *m_CommandPool; }
         FencePool &GetFencePool() { return *m_FencePool; }
 
+        // Called after sampled image views were destroyed while frames are drawn. A new view can get the handle of a
+        // destroyed one, so frames drop their cached descriptor sets on their next reset
+        void InvalidateDescriptorSets() { m_DescriptorSetEpoch++; }
+        uint64_t GetDescriptorSetEpoch() const { return m_DescriptorSetEpoch; }
+
     private:
         PhysicalDevice &m_Gpu;
         Platform &m_Platform;
@@ -52,5 +61,6 @@ namespace engine
 
         std::unique_ptr<CommandPool> m_CommandPool{};
         std::unique_ptr<FencePool> m_FencePool{};
+        std::atomic<uint64_t> m_DescriptorSetEpoch{0};
     };
 }
@@ -24,6 +24,7 @@ namespace engine
 
     VkResult Queue::Submit(const std::vector<VkSubmitInfo> &submit_infos, VkFence fence) const
     {
+        auto lock = Lock();
         return vkQueueSubmit(m_Handle, ToUint32_t(submit_infos.size()), submit_infos.data(), fence);
     }
 
@@ -34,6 +35,7 @@ namespace engine
             return VK_ERROR_INCOMPATIBLE_DISPLAY_KHR;
         }
 
+        auto lock = Lock();
         return vkQueuePresentKHR(m_Handle, &present_info);
     }
 }
\ No newline at end of file
@@ -17,6 +17,9 @@ namespace engine
 
         VkResult Present(const VkPresentInfoKHR &present_infos) const;
 
+        // Held while the queue is used, scenes loading on other threads submit to the same queues
+        std::unique_lock<std::mutex> Lock() const { return std::unique_lock<std::mutex>(*m_Mutex); }
+
         uint32_t GetQueueFamilyIndex() const { return m_QueueFamilyIndex; }
         uint32_t GetIndex() const { return m_Index; }
         VkQueue GetHandle() const { return m_Handle; }
@@ -26,5 +29,7 @@ namespace engine
         uint32_t m_QueueFamilyIndex{0};
         uint32_t m_Index{0};
         VkQueue m_Handle{VK_NULL_HANDLE};
+        // Shared by copies, which refer to the same VkQueue
+        std::shared_ptr<std::mutex> m_Mutex{std::make_shared<std::mutex>()};
     };
 }
\ No newline at end of file
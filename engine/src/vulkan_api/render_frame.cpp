@@ -91,6 +91,18 @@ namespace engine
         }
 
         m_SemaphorePool.Reset();
+
+        // Sets are keyed by handles, which may belong to new objects by now
+        if (m_DescriptorSetEpoch != m_Device.GetDescriptorSetEpoch())
+        {
+            m_DescriptorSetEpoch = m_Device.GetDescriptorSetEpoch();
+
+            for (auto &descriptor_sets : m_DescriptorSets)
+                descriptor_sets->clear();
+
+            for (auto &descriptor_pools : m_DescriptorPools)
+                descriptor_pools->clear();
+        }
     }
 
     BufferAllocation RenderFrame::AllocateBuffer(VkBufferUsageFlags usage, VkDeviceSize size, size_t thread_index)
@@ -32,7 +32,8 @@ namespace engine
             {VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT, 1},
             {VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, 2}, // x2 the size of BUFFER_POOL_BLOCK_SIZE since SSBOs are normally much larger than other types of buffers
             {VK_BUFFER_USAGE_VERTEX_BUFFER_BIT, 1},
-            {VK_BUFFER_USAGE_INDEX_BUFFER_BIT, 1}};
+            {VK_BUFFER_USAGE_INDEX_BUFFER_BIT, 1},
+            {VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, 16}}; // Skinned vertices, written by compute or the CPU
 
         void UpdateRenderTarget(std::unique_ptr<RenderTarget> &&render_target)
         {
@@ -84,6 +85,7 @@ namespace engine
         std::map<uint32_t, std::vector<std::unique_ptr<CommandPool>>> m_CommandPools{};
         std::vector<std::unique_ptr<std::unordered_map<std::size_t, DescriptorPool>>> m_DescriptorPools;
         std::vector<std::unique_ptr<std::unordered_map<std::size_t, DescriptorSet>>> m_DescriptorSets;
+        uint64_t m_DescriptorSetEpoch{0};
         FencePool m_FencePool;
         SemaphorePool m_SemaphorePool;
         std::unique_ptr<RenderTarget> m_SwapchainRenderTarget;
@@ -0,0 +1,141 @@
+#include "vulkan_api/rendering/draw_queue.h"
+
+#include "scene/components/material.h"
+#include "scene/components/submesh.h"
+
+namespace engine
+{
+    namespace
+    {
+        constexpr uint64_t BLEND_BIT = uint64_t{1} << 63;
+        constexpr uint32_t PIPELINE_ID_MASK = 0x7FFF;
+        constexpr uint32_t MATERIAL_ID_MASK = 0xFFFF;
+        constexpr uint32_t SUBMESH_ID_MASK = 0xFFFF;
+
+        // Non negative floats keep their order when compared as unsigned integers
+        inline uint32_t DepthBits(float depth)
+        {
+            depth = std::max(depth, 0.0f);
+            uint32_t bits;
+            std::memcpy(&bits, &depth, sizeof(bits));
+            return bits;
+        }
+    }
+
+    void DrawQueue::Push(sg::Submesh &submesh, sg::Transform &transform, VkFrontFace front_face, float depth,
+                         const SkinnedVertices *skinned_vertices)
+    {
+        uint64_t key;
+
+        if (submesh.GetMaterial()->m_AlphaMode == sg::AlphaMode::Blend)
+        {
+            key = BLEND_BIT | (uint64_t{~DepthBits(depth)} << 31);
+        }
+        else
+        {
+            key = (uint64_t{GetPipelineId(submesh, front_face) & PIPELINE_ID_MASK} << 48) |
+                  (uint64_t{GetMaterialId(submesh.GetMaterial()) & MATERIAL_ID_MASK} << 32) |
+                  (uint64_t{GetSubmeshId(&submesh) & SUBMESH_ID_MASK} << 16) |
+                  uint64_t{DepthBits(depth) >> 16};
+        }
+
+        m_Packets.push_back({key, &submesh, &transform, front_face, skinned_vertices});
+    }
+
+    bool DrawQueue::CanBatch(const DrawPacket &first, const DrawPacket &second)
+    {
+        if (IsBlended(first) || first.skinned_vertices || second.skinned_vertices || (first.key >> 16) != (second.key >> 16))
+            return false;
+
+        // The ids in the key are masked and wrap around in large sessions, so equal keys may still differ
+        return first.submesh == second.submesh && first.front_face == second.front_face &&
+               first.submesh->GetMaterial() == second.submesh->GetMaterial();
+    }
+
+    void DrawQueue::Sort()
+    {
+        // LSD radix sort on 8 bit digits, skipping digits every key shares
+        constexpr size_t DIGIT_COUNT = sizeof(uint64_t);
+        constexpr size_t BUCKET_COUNT = 256;
+
+        size_t count = m_Packets.size();
+        if (count < 2)
+            return;
+
+        std::array<std::array<uint32_t, BUCKET_COUNT>, DIGIT_COUNT> histograms{};
+
+        for (auto &packet : m_Packets)
+        {
+            for (size_t digit = 0; digit < DIGIT_COUNT; digit++)
+                histograms[digit][(packet.key >> (digit * 8)) & 0xFF]++;
+        }
+
+        m_SortScratch.resize(count);
+
+        auto *source = &m_Packets;
+        auto *destination = &m_SortScratch;
+
+        for (size_t digit = 0; digit < DIGIT_COUNT; digit++)
+        {
+            auto &histogram = histograms[digit];
+            auto shift = digit * 8;
+
+            if (histogram[((*source)[0].key >> shift) & 0xFF] == count)
+                continue;
+
+            uint32_t offset = 0;
+            for (auto &bucket : histogram)
+            {
+                auto bucket_count = bucket;
+                bucket = offset;
+                offset += bucket_count;
+            }
+
+            for (auto &packet : *source)
+                (*destination)[histogram[(packet.key >> shift) & 0xFF]++] = packet;
+
+            std::swap(source, destination);
+        }
+
+        if (source != &m_Packets)
+            m_Packets.swap(m_SortScratch);
+    }
+
+    uint32_t DrawQueue::GetPipelineId(const sg::Submesh &submesh, VkFrontFace front_face)
+    {
+        // Everything GeometrySubpass derives pipeline state from for an opaque draw
+        size_t hash = submesh.GetShaderVariant().GetID();
+        HashCombine(hash, submesh.GetMaterial()->m_DoubleSided);
+        HashCombine(hash, front_face);
+
+        auto it = m_PipelineIds.find(hash);
+        if (it != m_PipelineIds.end())
+            return it->second;
+
+        auto id = ToUint32_t(m_PipelineIds.size());
+        m_PipelineIds.emplace(hash, id);
+        return id;
+    }
+
+    uint32_t DrawQueue::GetSubmeshId(const sg::Submesh *submesh)
+    {
+        auto it = m_SubmeshIds.find(submesh);
+        if (it != m_SubmeshIds.end())
+            return it->second;
+
+        auto id = ToUint32_t(m_SubmeshIds.size());
+        m_SubmeshIds.emplace(submesh, id);
+        return id;
+    }
+
+    uint32_t DrawQueue::GetMaterialId(const sg::Material *material)
+    {
+        auto it = m_MaterialIds.find(material);
+        if (it != m_MaterialIds.end())
+            return it->second;
+
+        auto id = ToUint32_t(m_MaterialIds.size());
+        m_MaterialIds.emplace(material, id);
+        return id;
+    }
+}
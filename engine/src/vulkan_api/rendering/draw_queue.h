@@ -0,0 +1,59 @@
+#pragma once
+
+#include <unordered_map>
+
+namespace engine
+{
+    struct SkinnedVertices;
+
+    namespace sg
+    {
+        class Material;
+        class Submesh;
+        class Transform;
+    }
+
+    struct DrawPacket
+    {
+        uint64_t key;
+        sg::Submesh *submesh;
+        sg::Transform *transform;
+        VkFrontFace front_face;
+        // Set for skinned submeshes, replaces their position and normal buffers
+        const SkinnedVertices *skinned_vertices;
+    };
+
+    // Flat list of draws ordered by a packed 64 bit key:
+    //   opaque: [63] 0 | [62..48] pipeline | [47..32] material | [31..16] submesh | [15..0] depth, front to back
+    //   blend:  [63] 1 | [62..31] inverted depth, back to front | [30..0] unused
+    class DrawQueue
+    {
+    public:
+        DrawQueue() = default;
+        ~DrawQueue() = default;
+
+        void Clear() { m_Packets.clear(); }
+        void Push(sg::Submesh &submesh, sg::Transform &transform, VkFrontFace front_face, float depth,
+                  const SkinnedVertices *skinned_vertices = nullptr);
+        void Sort();
+
+        const std::vector<DrawPacket> &GetPackets() const { return m_Packets; }
+        static bool IsBlended(const DrawPacket &packet) { return (packet.key >> 63) != 0; }
+        // Opaque packets that only differ in depth can be drawn as instances of one draw,
+        // skinned packets have their own vertices
+        static bool CanBatch(const DrawPacket &first, const DrawPacket &second);
+
+    private:
+        uint32_t GetPipelineId(const sg::Submesh &submesh, VkFrontFace front_face);
+        uint32_t GetMaterialId(const sg::Material *material);
+        uint32_t GetSubmeshId(const sg::Submesh *submesh);
+
+        std::vector<DrawPacket> m_Packets;
+        std::vector<DrawPacket> m_SortScratch;
+
+        // Small ids handed out on first use, kept across frames
+        std::unordered_map<size_t, uint32_t> m_PipelineIds;
+        std::unordered_map<const sg::Material *, uint32_t> m_MaterialIds;
+        std::unordered_map<const sg::Submesh *, uint32_t> m_SubmeshIds;
+    };
+}
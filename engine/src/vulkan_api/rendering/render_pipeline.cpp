@@ -12,9 +12,6 @@ namespace engine
     RenderPipeline::RenderPipeline(Device &device, std::vector<std::unique_ptr<Subpass>> &&subpasses)
         : m_Device(device), m_Subpasses(std::move(subpasses))
     {
-        for (auto &subpass : m_Subpasses)
-            subpass->Prepare(m_Device);
-
         m_ClearValue[0].color = {0.05f, 0.05f, 0.05f, 1.0f};
         m_ClearValue[1].depthStencil = {0.0f, ~0U};
     }
@@ -25,7 +22,6 @@ namespace engine
 
     void RenderPipeline::AddSubpass(std::unique_ptr<Subpass> &&subpass)
     {
-        subpass->Prepare(m_Device);
         m_Subpasses.emplace_back(std::move(subpass));
     }
 
@@ -37,6 +33,27 @@ namespace engine
         while (m_ClearValue.size() < render_target.GetAttachments().size())
             m_ClearValue.push_back({0.0f, 0.0f, 0.0f, 1.0f});
 
+        // Only clears the render target while the scene is loading, so the window keeps presenting
+        if (!layer.IsSceneLoaded())
+        {
+            m_Subpasses[0]->UpdateRenderTargetAttachments(render_target);
+            command_buffer.BeginRenderPass(render_target, m_LoadStore, m_ClearValue, m_Subpasses, contents);
+
+            for (size_t i = 1; i < m_Subpasses.size(); ++i)
+            {
+                m_Subpasses[i]->UpdateRenderTargetAttachments(render_target);
+                command_buffer.NextSubpass();
+            }
+
+            return;
+        }
+
+        for (; m_PreparedSubpassCount < m_Subpasses.size(); m_PreparedSubpassCount++)
+            m_Subpasses[m_PreparedSubpassCount]->Prepare(m_Device);
+
+        for (auto &subpass : m_Subpasses)
+            subpass->PreDraw(render_context, layer, command_buffer);
+
         for (size_t i = 0; i < m_Subpasses.size(); ++i)
         {
             m_ActiveSubpassIndex = i;
@@ -32,5 +32,7 @@ namespace engine
         std::vector<LoadStoreInfo> m_LoadStore = std::vector<LoadStoreInfo>(2);
         std::vector<VkClearValue> m_ClearValue = std::vector<VkClearValue>(2);
         size_t m_ActiveSubpassIndex{0};
+        // Subpasses are prepared on the first draw of a loaded scene, preparing reads its submeshes
+        size_t m_PreparedSubpassCount{0};
     };
 }
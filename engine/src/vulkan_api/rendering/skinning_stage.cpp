@@ -0,0 +1,260 @@
+#include "vulkan_api/rendering/skinning_stage.h"
+
+#include "common/simd.h"
+#include "core/job_system.h"
+#include "scene/components/skin.h"
+#include "scene/components/submesh.h"
+#include "vulkan_api/command_buffer.h"
+#include "vulkan_api/device.h"
+#include "vulkan_api/render_context.h"
+
+namespace engine
+{
+    namespace
+    {
+        constexpr VkBufferUsageFlags SKINNED_VERTEX_USAGE = VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT;
+
+        // Matches local_size_x in skinning.comp
+        constexpr uint32_t SKINNING_GROUP_SIZE = 64;
+
+        // Vertices skinned by one CPU task
+        constexpr size_t SKINNING_CHUNK_SIZE = 4096;
+
+        struct SkinningInfo
+        {
+            uint32_t vertex_count;
+            uint32_t joint_count;
+        };
+
+        inline float *MappedData(BufferAllocation &allocation)
+        {
+            return reinterpret_cast<float *>(allocation.GetBuffer().Map() + allocation.GetOffset());
+        }
+    }
+
+    void SkinVertices(const sg::SkinVertex *vertices, size_t count,
+                      const glm::mat4 *joint_matrices, size_t joint_count,
+                      float *positions, float *normals)
+    {
+        for (size_t i = 0; i < count; i++)
+        {
+            auto &vertex = vertices[i];
+
+#if defined(ENG_SIMD_SSE) || defined(ENG_SIMD_AVX2)
+            __m128 column_0 = _mm_setzero_ps();
+            __m128 column_1 = _mm_setzero_ps();
+            __m128 column_2 = _mm_setzero_ps();
+            __m128 column_3 = _mm_setzero_ps();
+
+            for (int influence = 0; influence < 4; influence++)
+            {
+                float weight = vertex.weights[influence];
+                uint32_t joint = vertex.joints[influence];
+
+                if (weight == 0.0f || joint >= joint_count)
+                    continue;
+
+                const float *matrix = &joint_matrices[joint][0][0];
+                __m128 w = _mm_set1_ps(weight);
+
+                column_0 = _mm_add_ps(column_0, _mm_mul_ps(w, _mm_loadu_ps(matrix)));
+                column_1 = _mm_add_ps(column_1, _mm_mul_ps(w, _mm_loadu_ps(matrix + 4)));
+                column_2 = _mm_add_ps(column_2, _mm_mul_ps(w, _mm_loadu_ps(matrix + 8)));
+                column_3 = _mm_add_ps(column_3, _mm_mul_ps(w, _mm_loadu_ps(matrix + 12)));
+            }
+
+            __m128 position = _mm_add_ps(_mm_add_ps(_mm_mul_ps(column_0, _mm_set1_ps(vertex.position.x)),
+                                                    _mm_mul_ps(column_1, _mm_set1_ps(vertex.position.y))),
+                                         _mm_add_ps(_mm_mul_ps(column_2, _mm_set1_ps(vertex.position.z)), column_3));
+
+            __m128 normal = _mm_add_ps(_mm_add_ps(_mm_mul_ps(column_0, _mm_set1_ps(vertex.normal.x)),
+                                                  _mm_mul_ps(column_1, _mm_set1_ps(vertex.normal.y))),
+                                       _mm_mul_ps(column_2, _mm_set1_ps(vertex.normal.z)));
+
+            alignas(16) float position_data[4];
+            alignas(16) float normal_data[4];
+            _mm_store_ps(position_data, position);
+            _mm_store_ps(normal_data, normal);
+
+            glm::vec3 skinned_position{position_data[0], position_data[1], position_data[2]};
+            glm::vec3 skinned_normal{normal_data[0], normal_data[1], normal_data[2]};
+#else
+            glm::mat4 skin_matrix{0.0f};
+
+            for (int influence = 0; influence < 4; influence++)
+            {
+                float weight = vertex.weights[influence];
+                uint32_t joint = vertex.joints[influence];
+
+                if (weight != 0.0f && joint < joint_count)
+                    skin_matrix += weight * joint_matrices[joint];
+            }
+
+            glm::vec3 skinned_position{skin_matrix * vertex.position};
+            glm::vec3 skinned_normal{glm::mat3(skin_matrix) * glm::vec3(vertex.normal)};
+#endif
+
+            float length = glm::length(skinned_normal);
+            if (length > 0.0f)
+                skinned_normal /= length;
+
+            std::memcpy(positions + i * 3, &skinned_position, sizeof(glm::vec3));
+            std::memcpy(normals + i * 3, &skinned_normal, sizeof(glm::vec3));
+        }
+    }
+
+    SkinningStage::SkinningStage(ShaderSource &&compute_shader)
+        : m_ComputeShader(std::move(compute_shader))
+    {
+    }
+
+    SkinningStage::~SkinningStage()
+    {
+    }
+
+    void SkinningStage::Prepare(Device &device)
+    {
+        device.GetResourceCache().RequestShaderModule(VK_SHADER_STAGE_COMPUTE_BIT, m_ComputeShader);
+    }
+
+    void SkinningStage::Clear()
+    {
+        m_Jobs.clear();
+        m_Outputs.clear();
+    }
+
+    const SkinnedVertices *SkinningStage::Push(const sg::Skin &skin, const sg::Submesh &submesh)
+    {
+        m_Outputs.emplace_back();
+        m_Jobs.push_back({&skin, &submesh, &m_Outputs.back()});
+
+        return &m_Outputs.back();
+    }
+
+    void SkinningStage::Execute(RenderContext &render_context, CommandBuffer &command_buffer, size_t thread_index)
+    {
+        if (m_Jobs.empty())
+            return;
+
+        Allocate(render_context, thread_index);
+
+        if (m_Mode == SkinningMode::CPU)
+            ExecuteCPU();
+        else
+            ExecuteCompute(render_context, command_buffer, thread_index);
+    }
+
+    void SkinningStage::Allocate(RenderContext &render_context, size_t thread_index)
+    {
+        auto &render_frame = render_context.GetActiveFrame();
+
+        for (auto &job : m_Jobs)
+        {
+            auto size = job.submesh->m_SkinVertices.size() * sizeof(glm::vec3);
+
+            job.output->positions = render_frame.AllocateBuffer(SKINNED_VERTEX_USAGE, size, thread_index);
+            job.output->normals = render_frame.AllocateBuffer(SKINNED_VERTEX_USAGE, size, thread_index);
+        }
+    }
+
+    void SkinningStage::ExecuteCPU()
+    {
+        auto &job_system = JobSystem::Get();
+        JobCounter counter;
+
+        for (auto &job : m_Jobs)
+        {
+            auto &vertices = job.submesh->m_SkinVertices;
+            auto &joint_matrices = job.skin->GetJointMatrices();
+
+            float *positions = MappedData(job.output->positions);
+            float *normals = MappedData(job.output->normals);
+
+            for (size_t first = 0; first < vertices.size(); first += SKINNING_CHUNK_SIZE)
+            {
+                size_t count = std::min(SKINNING_CHUNK_SIZE, vertices.size() - first);
+
+                job_system.Run(
+                    [&vertices, &joint_matrices, positions, normals, first, count]()
+                    {
+                        SkinVertices(vertices.data() + first, count,
+                                     joint_matrices.data(), joint_matrices.size(),
+                                     positions + first * 3, normals + first * 3);
+                    },
+                    &counter);
+            }
+        }
+
+        job_system.Wait(counter);
+
+        // Pool buffers are shared by many allocations, flush each one once
+        std::vector<const core::Buffer *> flushed;
+
+        for (auto &output : m_Outputs)
+        {
+            for (auto *allocation : {&output.positions, &output.normals})
+            {
+                auto &buffer = allocation->GetBuffer();
+
+                if (std::find(flushed.begin(), flushed.end(), &buffer) == flushed.end())
+                {
+                    buffer.Flush();
+                    flushed.push_back(&buffer);
+                }
+            }
+        }
+    }
+
+    void SkinningStage::ExecuteCompute(RenderContext &render_context, CommandBuffer &command_buffer, size_t thread_index)
+    {
+        auto &resource_cache = command_buffer.GetDevice().GetResourceCache();
+        auto &render_frame = render_context.GetActiveFrame();
+
+        auto &shader_module = resource_cache.RequestShaderModule(VK_SHADER_STAGE_COMPUTE_BIT, m_ComputeShader);
+        auto &pipeline_layout = resource_cache.RequestPipelineLayout({&shader_module});
+
+        command_buffer.GetPipelineState().SetPipelineLayout(pipeline_layout);
+
+        std::vector<const core::Buffer *> written;
+
+        for (auto &job : m_Jobs)
+        {
+            auto &joint_matrices = job.skin->GetJointMatrices();
+            auto &skin_vertex_buffer = *job.submesh->m_SkinVertexBuffer;
+            auto joint_size = joint_matrices.size() * sizeof(glm::mat4);
+
+            auto joint_allocation = render_frame.AllocateBuffer(VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, joint_size, thread_index);
+            joint_allocation.Update(reinterpret_cast<const uint8_t *>(joint_matrices.data()), joint_size);
+
+            auto &positions = job.output->positions;
+            auto &normals = job.output->normals;
+
+            command_buffer.BindBuffer(skin_vertex_buffer, 0, skin_vertex_buffer.GetSize(), 0, 0, 0);
+            command_buffer.BindBuffer(joint_allocation.GetBuffer(), joint_allocation.GetOffset(), joint_allocation.GetSize(), 0, 1, 0);
+            command_buffer.BindBuffer(positions.GetBuffer(), positions.GetOffset(), positions.GetSize(), 0, 2, 0);
+            command_buffer.BindBuffer(normals.GetBuffer(), normals.GetOffset(), normals.GetSize(), 0, 3, 0);
+
+            SkinningInfo skinning_info{};
+            skinning_info.vertex_count = ToUint32_t(job.submesh->m_SkinVertices.size());
+            skinning_info.joint_count = ToUint32_t(joint_matrices.size());
+            command_buffer.PushConstants(skinning_info);
+
+            command_buffer.Dispatch((skinning_info.vertex_count + SKINNING_GROUP_SIZE - 1) / SKINNING_GROUP_SIZE, 1, 1);
+
+            for (auto *buffer : {&positions.GetBuffer(), &normals.GetBuffer()})
+            {
+                if (std::find(written.begin(), written.end(), buffer) == written.end())
+                    written.push_back(buffer);
+            }
+        }
+
+        BufferMemoryBarrier memory_barrier{};
+        memory_barrier.src_stage_mask = VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
+        memory_barrier.dst_stage_mask = VK_PIPELINE_STAGE_VERTEX_INPUT_BIT;
+        memory_barrier.src_access_mask = VK_ACCESS_SHADER_WRITE_BIT;
+        memory_barrier.dst_access_mask = VK_ACCESS_VERTEX_ATTRIBUTE_READ_BIT;
+
+        for (auto *buffer : written)
+            command_buffer.CreateBufferMemoryBarrier(*buffer, 0, VK_WHOLE_SIZE, memory_barrier);
+    }
+}
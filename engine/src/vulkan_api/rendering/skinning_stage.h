@@ -0,0 +1,76 @@
+#pragma once
+
+#include "renderer/shader.h"
+#include "vulkan_api/core/buffer_pool.h"
+
+#include <deque>
+
+namespace engine
+{
+    class Device;
+    class RenderContext;
+    class CommandBuffer;
+
+    namespace sg
+    {
+        class Skin;
+        class Submesh;
+        struct SkinVertex;
+    }
+
+    enum class SkinningMode
+    {
+        // Reference path, multithreaded and SIMD, also used on machines without compute support
+        CPU,
+        Compute
+    };
+
+    // Skinned positions and normals of one submesh, tightly packed vec3 arrays valid for the current frame
+    struct SkinnedVertices
+    {
+        BufferAllocation positions;
+        BufferAllocation normals;
+    };
+
+    // Linear blend skinning of the visible skinned submeshes into per frame vertex buffers
+    class SkinningStage
+    {
+    public:
+        SkinningStage(ShaderSource &&compute_shader);
+        ~SkinningStage();
+
+        void Prepare(Device &device);
+
+        void SetMode(SkinningMode mode) { m_Mode = mode; }
+        SkinningMode GetMode() const { return m_Mode; }
+
+        void Clear();
+        // The returned vertices stay at the same address until the next Clear and are filled by Execute
+        const SkinnedVertices *Push(const sg::Skin &skin, const sg::Submesh &submesh);
+        // Must be recorded outside of a render pass
+        void Execute(RenderContext &render_context, CommandBuffer &command_buffer, size_t thread_index = 0);
+
+    private:
+        struct Job
+        {
+            const sg::Skin *skin;
+            const sg::Submesh *submesh;
+            SkinnedVertices *output;
+        };
+
+        void Allocate(RenderContext &render_context, size_t thread_index);
+        void ExecuteCPU();
+        void ExecuteCompute(RenderContext &render_context, CommandBuffer &command_buffer, size_t thread_index);
+
+        SkinningMode m_Mode{SkinningMode::Compute};
+        ShaderSource m_ComputeShader;
+
+        std::vector<Job> m_Jobs;
+        std::deque<SkinnedVertices> m_Outputs;
+    };
+
+    // Skins count vertices with the joint palette into packed vec3 positions and normals
+    void SkinVertices(const sg::SkinVertex *vertices, size_t count,
+                      const glm::mat4 *joint_matrices, size_t joint_count,
+                      float *positions, float *normals);
+}
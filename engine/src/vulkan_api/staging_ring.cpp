@@ -0,0 +1,234 @@
+#include "vulkan_api/staging_ring.h"
+
+#include "vulkan_api/command_buffer.h"
+#include "vulkan_api/device.h"
+#include "vulkan_api/queue.h"
+
+namespace engine
+{
+    namespace
+    {
+        inline VkDeviceSize AlignUp(VkDeviceSize value, VkDeviceSize alignment)
+        {
+            return (value + alignment - 1) & ~(alignment - 1);
+        }
+    }
+
+    StagingRing::StagingRing(Device &device, VkDeviceSize capacity)
+        : m_Device(device),
+          m_Capacity(AlignUp(std::max<VkDeviceSize>(capacity, ALIGNMENT), ALIGNMENT))
+    {
+        m_Buffer = std::make_unique<core::Buffer>(m_Device, m_Capacity, VK_BUFFER_USAGE_TRANSFER_SRC_BIT, VMA_MEMORY_USAGE_CPU_ONLY);
+    }
+
+    StagingRing::~StagingRing()
+    {
+        WaitIdle();
+
+        for (auto fence : m_FreeFences)
+            vkDestroyFence(m_Device.GetHandle(), fence, nullptr);
+    }
+
+    StagingRing::Allocation StagingRing::Allocate(VkDeviceSize size)
+    {
+        size = AlignUp(std::max<VkDeviceSize>(size, 1), ALIGNMENT);
+        bool dedicated = size > m_Capacity;
+
+        std::unique_lock<std::mutex> lock(m_Mutex);
+
+        Region region{};
+        region.size = size;
+
+        auto can_allocate = [this, dedicated, &region]()
+        {
+            if (dedicated)
+                return m_Regions.empty();
+
+            return m_DedicatedWaitingCount == 0 && TryAllocate(region.size, region.offset);
+        };
+
+        if (!can_allocate())
+        {
+            // Keeps smaller allocations from starving one that needs the whole ring drained
+            if (dedicated)
+                m_DedicatedWaitingCount++;
+
+            m_WaitingCount++;
+            if (m_WaitCallback)
+                m_WaitCallback();
+
+            m_Released.wait(lock, can_allocate);
+            m_WaitingCount--;
+
+            if (dedicated)
+                m_DedicatedWaitingCount--;
+        }
+
+        Allocation allocation{};
+        allocation.id = m_NextId++;
+        allocation.size = size;
+
+        if (dedicated)
+        {
+            region.dedicated_buffer = std::make_unique<core::Buffer>(m_Device, size, VK_BUFFER_USAGE_TRANSFER_SRC_BIT, VMA_MEMORY_USAGE_CPU_ONLY);
+            allocation.buffer = region.dedicated_buffer.get();
+            allocation.data = region.dedicated_buffer->Map();
+        }
+        else
+        {
+            allocation.buffer = m_Buffer.get();
+            allocation.offset = region.offset;
+            allocation.data = m_Buffer->Map() + region.offset;
+        }
+
+        region.id = allocation.id;
+        m_Regions.push_back(std::move(region));
+
+        m_Usage += size;
+        m_PeakUsage = std::max(m_PeakUsage, m_Usage);
+
+        return allocation;
+    }
+
+    void StagingRing::Free(const Allocation &allocation)
+    {
+        Release({allocation.id});
+    }
+
+    bool StagingRing::TryAllocate(VkDeviceSize size, VkDeviceSize &offset) const
+    {
+        if (m_Regions.empty())
+        {
+            offset = 0;
+            return true;
+        }
+
+        if (m_Regions.back().dedicated_buffer)
+            return false;
+
+        auto head = m_Regions.back().offset + m_Regions.back().size;
+        auto tail = m_Regions.front().offset;
+
+        if (m_Regions.back().offset >= tail)
+        {
+            // Not wrapped, free space after the newest region and before the oldest one
+            if (head + size <= m_Capacity)
+            {
+                offset = head;
+                return true;
+            }
+
+            if (size <= tail)
+            {
+                offset = 0;
+                return true;
+            }
+
+            return false;
+        }
+
+        // Wrapped, the only free space is between the newest and the oldest region
+        if (head + size <= tail)
+        {
+            offset = head;
+            return true;
+        }
+
+        return false;
+    }
+
+    void StagingRing::Submit(const Queue &queue, const CommandBuffer &command_buffer, std::vector<Allocation> &&allocations,
+                             std::function<void()> finished)
+    {
+        PendingSubmit submit{};
+        submit.fence = RequestFence();
+        submit.finished = std::move(finished);
+
+        for (auto &allocation : allocations)
+            submit.allocations.push_back(allocation.id);
+
+        VkResult result = queue.Submit(command_buffer, submit.fence);
+        if (result != VK_SUCCESS)
+            throw std::runtime_error("Failed to submit staging copies");
+
+        m_Submits.push_back(std::move(submit));
+    }
+
+    void StagingRing::Retire(bool wait_for_oldest)
+    {
+        if (wait_for_oldest && !m_Submits.empty())
+            vkWaitForFences(m_Device.GetHandle(), 1, &m_Submits.front().fence, VK_TRUE, UINT64_MAX);
+
+        while (!m_Submits.empty())
+        {
+            auto &submit = m_Submits.front();
+
+            if (vkGetFenceStatus(m_Device.GetHandle(), submit.fence) != VK_SUCCESS)
+                break;
+
+            vkResetFences(m_Device.GetHandle(), 1, &submit.fence);
+            m_FreeFences.push_back(submit.fence);
+
+            Release(submit.allocations);
+            auto finished = std::move(submit.finished);
+            m_Submits.pop_front();
+
+            if (finished)
+                finished();
+        }
+    }
+
+    void StagingRing::WaitIdle()
+    {
+        while (!m_Submits.empty())
+            Retire(true);
+    }
+
+    void StagingRing::Release(const std::vector<uint64_t> &allocations)
+    {
+        std::unique_ptr<core::Buffer> dedicated_buffer;
+
+        {
+            std::lock_guard<std::mutex> lock(m_Mutex);
+
+            for (auto id : allocations)
+            {
+                auto it = std::find_if(m_Regions.begin(), m_Regions.end(), [id](const Region &region)
+                                       { return region.id == id; });
+
+                if (it != m_Regions.end())
+                    it->released = true;
+            }
+
+            while (!m_Regions.empty() && m_Regions.front().released)
+            {
+                m_Usage -= m_Regions.front().size;
+
+                if (m_Regions.front().dedicated_buffer)
+                    dedicated_buffer = std::move(m_Regions.front().dedicated_buffer);
+
+                m_Regions.pop_front();
+            }
+        }
+
+        m_Released.notify_all();
+    }
+
+    VkFence StagingRing::RequestFence()
+    {
+        if (!m_FreeFences.empty())
+        {
+            auto fence = m_FreeFences.back();
+            m_FreeFences.pop_back();
+            return fence;
+        }
+
+        VkFence fence{VK_NULL_HANDLE};
+        VkFenceCreateInfo create_info{VK_STRUCTURE_TYPE_FENCE_CREATE_INFO};
+
+        if (vkCreateFence(m_Device.GetHandle(), &create_info, nullptr, &fence) != VK_SUCCESS)
+            throw std::runtime_error("Failed to create fence.");
+
+        return fence;
+    }
+}
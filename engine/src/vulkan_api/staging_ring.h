@@ -0,0 +1,100 @@
+#pragma once
+
+#include "vulkan_api/core/buffer.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+
+namespace engine
+{
+    class Device;
+    class CommandBuffer;
+    class Queue;
+
+    // Staging memory with a fixed budget, producer threads allocate and fill it while one thread records
+    // and submits the copies out of it. Space is reused once the submit reading it finished executing
+    class StagingRing
+    {
+    public:
+        struct Allocation
+        {
+            const core::Buffer *buffer{nullptr};
+            VkDeviceSize offset{0};
+            VkDeviceSize size{0};
+            uint8_t *data{nullptr};
+            uint64_t id{0};
+        };
+
+        static constexpr VkDeviceSize ALIGNMENT = 16;
+
+        StagingRing(Device &device, VkDeviceSize capacity);
+        ~StagingRing();
+
+        StagingRing(const StagingRing &) = delete;
+        StagingRing &operator=(const StagingRing &) = delete;
+
+        // Thread safe, blocks while the ring is full. An allocation larger than the ring waits until the ring
+        // drained and gets a buffer of its own, so the peak stays at the larger of the two
+        Allocation Allocate(VkDeviceSize size);
+        // Thread safe, gives back an allocation that is never submitted, e.g. after its producer failed
+        void Free(const Allocation &allocation);
+
+        // Submits the command buffer, the allocations it copies from are released when it finished.
+        // finished is called by the Retire call that sees the copies executed
+        void Submit(const Queue &queue, const CommandBuffer &command_buffer, std::vector<Allocation> &&allocations,
+                    std::function<void()> finished = {});
+        // Releases the allocations of finished submits, waits for the oldest submit first if requested
+        void Retire(bool wait_for_oldest);
+        void WaitIdle();
+
+        // Called by an allocating thread when it starts to wait, so the submitting thread can flush its work
+        void SetWaitCallback(std::function<void()> callback) { m_WaitCallback = std::move(callback); }
+
+        size_t GetWaitingCount() const { return m_WaitingCount; }
+        bool HasPendingSubmits() const { return !m_Submits.empty(); }
+        VkDeviceSize GetCapacity() const { return m_Capacity; }
+        VkDeviceSize GetPeakUsage() const { return m_PeakUsage; }
+
+    private:
+        struct Region
+        {
+            uint64_t id{0};
+            VkDeviceSize offset{0};
+            VkDeviceSize size{0};
+            std::unique_ptr<core::Buffer> dedicated_buffer;
+            bool released{false};
+        };
+
+        struct PendingSubmit
+        {
+            VkFence fence{VK_NULL_HANDLE};
+            std::vector<uint64_t> allocations;
+            std::function<void()> finished;
+        };
+
+        bool TryAllocate(VkDeviceSize size, VkDeviceSize &offset) const;
+        void Release(const std::vector<uint64_t> &allocations);
+        VkFence RequestFence();
+
+        Device &m_Device;
+        VkDeviceSize m_Capacity;
+        std::unique_ptr<core::Buffer> m_Buffer;
+        std::function<void()> m_WaitCallback;
+
+        std::mutex m_Mutex;
+        std::condition_variable m_Released;
+        // Live regions in allocation order, the ring only advances past the oldest once it was released
+        std::deque<Region> m_Regions;
+        uint64_t m_NextId{0};
+        uint32_t m_DedicatedWaitingCount{0};
+        std::atomic<size_t> m_WaitingCount{0};
+        VkDeviceSize m_Usage{0};
+        VkDeviceSize m_PeakUsage{0};
+
+        // Only touched by the submitting thread
+        std::deque<PendingSubmit> m_Submits;
+        std::vector<VkFence> m_FreeFences;
+    };
+}
@@ -26,24 +26,17 @@ namespace engine
 
     void ForwardSubpass::Prepare(Device &device)
     {
-        auto view = m_Scene.GetRegistry().view<sg::Mesh>();
-
-        for (auto &entity : view)
+        for (auto &sub_mesh : m_Scene.GetSubmeshes())
         {
-            auto &mesh = view.get<sg::Mesh>(entity);
-
-            for (auto &sub_mesh : mesh.GetSubmeshes())
-            {
-                auto &variant = sub_mesh->GetMutShaderVariant();
+            auto &variant = sub_mesh->GetMutShaderVariant();
 
-                // Same as Geometry except adds lighting definitions to sub mesh variants.
-                variant.AddDefine({"MAX_LIGHT_COUNT " + std::to_string(MAX_FORWARD_LIGHT_COUNT)});
+            // Same as Geometry except adds lighting definitions to sub mesh variants.
+            variant.AddDefine({"MAX_LIGHT_COUNT " + std::to_string(MAX_FORWARD_LIGHT_COUNT)});
 
-                variant.AddDefine(light_type_definitions);
+            variant.AddDefine(light_type_definitions);
 
-                device.GetResourceCache().RequestShaderModule(VK_SHADER_STAGE_VERTEX_BIT, m_VertexShader, variant);
-                device.GetResourceCache().RequestShaderModule(VK_SHADER_STAGE_FRAGMENT_BIT, m_FragmentShader, variant);
-            }
+            device.GetResourceCache().RequestShaderModule(VK_SHADER_STAGE_VERTEX_BIT, m_VertexShader, variant);
+            device.GetResourceCache().RequestShaderModule(VK_SHADER_STAGE_FRAGMENT_BIT, m_FragmentShader, variant);
         }
     }
 
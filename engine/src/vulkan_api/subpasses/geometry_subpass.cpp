@@ -6,17 +6,34 @@
 #include "scene/components/sampler.h"
 #include "scene/components/texture.h"
 #include "scene/components/pbr_material.h"
+#include "scene/components/skin.h"
 #include "scene/components/submesh.h"
 #include "core/layer.h"
 #include "scene/components/perspective_camera.h"
+#include "scene/systems/bounds_system.h"
+#include "scene/systems/spatial_system.h"
 #include "vulkan_api/device.h"
+#include "vulkan_api/texture_streamer.h"
 
 namespace engine
 {
+    namespace
+    {
+        // Keeps a single instance buffer allocation well inside one buffer pool block
+        constexpr ptrdiff_t MAX_INSTANCE_COUNT = 1024;
+
+        // Vertex inputs replaced by the skinning stage output
+        inline bool IsSkinnedAttribute(const std::string &name)
+        {
+            return name == "position" || name == "normal";
+        }
+    }
+
     GeometrySubpass::GeometrySubpass(ShaderSource &&vertex_shader, ShaderSource &&fragment_shader, Scene &scene)
         : Subpass(std::move(vertex_shader),
                   std::move(fragment_shader)),
-          m_Scene(scene)
+          m_Scene(scene),
+          m_SkinningStage(ShaderSource{"skinning.comp"})
     {
     }
 
@@ -26,43 +43,55 @@ namespace engine
 
     void GeometrySubpass::Prepare(Device &device)
     {
+        // Submeshes are shared between mesh instances, so go over the scene list
+        for (auto &submesh : m_Scene.GetSubmeshes())
+        {
+            auto &variant = submesh->GetMutShaderVariant();
 
-        auto view = m_Scene.GetRegistry().view<sg::Mesh>();
+            device.GetResourceCache().RequestShaderModule(VK_SHADER_STAGE_VERTEX_BIT, m_VertexShader, variant);
+            device.GetResourceCache().RequestShaderModule(VK_SHADER_STAGE_FRAGMENT_BIT, m_FragmentShader, variant);
+        }
 
-        for (auto &entity : view)
-        {
-            auto &mesh = view.get<sg::Mesh>(entity);
+        m_SkinningStage.Prepare(device);
+    }
 
-            for (auto &submesh : mesh.GetSubmeshes())
-            {
-                auto &variant = submesh->GetMutShaderVariant();
+    void GeometrySubpass::PreDraw(RenderContext &render_context, Layer &layer, CommandBuffer &command_buffer)
+    {
+        m_SurfaceHeight = render_context.GetSurfaceExtent().height;
 
-                device.GetResourceCache().RequestShaderModule(VK_SHADER_STAGE_VERTEX_BIT, m_VertexShader, variant);
-                device.GetResourceCache().RequestShaderModule(VK_SHADER_STAGE_FRAGMENT_BIT, m_FragmentShader, variant);
-            }
-        }
+        GetSortedNodes(m_DrawQueue, layer.GetCamera());
+        m_SkinningStage.Execute(render_context, command_buffer, m_ThreadIndex);
     }
 
     void GeometrySubpass::Draw(RenderContext &render_context, Layer &layer, CommandBuffer &command_buffer)
     {
-        std::multimap<float, std::pair<sg::Submesh *, sg::Transform *>> opaque_nodes;
-        std::multimap<float, std::pair<sg::Submesh *, sg::Transform *>> transparent_nodes;
+        UpdateUniform(render_context, command_buffer, layer.GetCamera(), m_ThreadIndex);
+
+        m_BoundVertexBuffer = VK_NULL_HANDLE;
+        m_BoundIndexBuffer = VK_NULL_HANDLE;
 
-        GetSortedNodes(opaque_nodes, transparent_nodes, layer.GetCamera());
+        auto &packets = m_DrawQueue.GetPackets();
 
-        for (auto node_it = opaque_nodes.begin(); node_it != opaque_nodes.end(); node_it++)
+        // Opaque packets sort before blended ones
+        auto first_blended = std::find_if(packets.begin(), packets.end(), DrawQueue::IsBlended);
+
+        // Neighbouring packets with the same pipeline, material and submesh become one instanced draw
+        for (auto batch_begin = packets.cbegin(); batch_begin != first_blended;)
         {
-            auto &transform = *(node_it->second.second);
-            UpdateUniform(render_context, command_buffer, transform, layer.GetCamera(), m_ThreadIndex);
+            auto batch_end = batch_begin + 1;
 
-            // Invert the front face if the mesh was flipped
-            const auto &scale = transform.GetScale();
-            bool flipped = scale.x * scale.y * scale.z < 0;
-            VkFrontFace front_face = flipped ? VK_FRONT_FACE_CLOCKWISE : VK_FRONT_FACE_COUNTER_CLOCKWISE;
+            while (batch_end != first_blended &&
+                   batch_end - batch_begin < MAX_INSTANCE_COUNT &&
+                   DrawQueue::CanBatch(*batch_begin, *batch_end))
+                batch_end++;
 
-            DrawSubmesh(command_buffer, *node_it->second.first, front_face);
+            DrawBatch(render_context, command_buffer, batch_begin, batch_end);
+            batch_begin = batch_end;
         }
 
+        if (first_blended == packets.end())
+            return;
+
         // Enable alpha blending
         ColorBlendAttachmentState color_blend_attachment{};
         color_blend_attachment.blend_enable = VK_TRUE;
@@ -82,50 +111,100 @@ namespace engine
 
         command_buffer.GetPipelineState().SetDepthStencilState(GetDepthStencilState());
 
-        // Draw transparent objects in back-to-front order
-        for (auto node_it = transparent_nodes.rbegin(); node_it != transparent_nodes.rend(); node_it++)
-        {
-            auto &transform = *(node_it->second.second);
-            UpdateUniform(render_context, command_buffer, transform, layer.GetCamera(), m_ThreadIndex);
+        // Blended packets are already in back-to-front order, so they can't be merged
+        for (auto packet_it = first_blended; packet_it != packets.cend(); packet_it++)
+            DrawBatch(render_context, command_buffer, packet_it, packet_it + 1);
+    }
 
-            DrawSubmesh(command_buffer, *node_it->second.first);
-        }
+    void GeometrySubpass::DrawBatch(RenderContext &render_context, CommandBuffer &command_buffer,
+                                    std::vector<DrawPacket>::const_iterator begin,
+                                    std::vector<DrawPacket>::const_iterator end)
+    {
+        m_InstanceTransforms.clear();
+
+        for (auto packet_it = begin; packet_it != end; packet_it++)
+            m_InstanceTransforms.push_back(packet_it->transform->GetWorldMatrix());
+
+        auto instance_count = ToUint32_t(m_InstanceTransforms.size());
+        auto size = m_InstanceTransforms.size() * sizeof(glm::mat4);
+
+        auto instance_buffer = render_context.GetActiveFrame().AllocateBuffer(VK_BUFFER_USAGE_VERTEX_BUFFER_BIT, size, m_ThreadIndex);
+        instance_buffer.Update(reinterpret_cast<const uint8_t *>(m_InstanceTransforms.data()), size);
+
+        DrawSubmesh(command_buffer, *begin->submesh, instance_buffer, instance_count, begin->front_face, begin->skinned_vertices);
     }
 
-    void GeometrySubpass::GetSortedNodes(
-        std::multimap<float, std::pair<sg::Submesh *, sg::Transform *>> &opaque_nodes,
-        std::multimap<float, std::pair<sg::Submesh *, sg::Transform *>> &transparent_nodes,
-        Entity *camera)
+    void GeometrySubpass::GetSortedNodes(DrawQueue &draw_queue, Entity *camera)
     {
+        draw_queue.Clear();
+        m_SkinningStage.Clear();
+
+        auto &perspective_camera = camera->GetComponent<sg::PerspectiveCamera>();
         auto camera_matrix = camera->GetComponent<sg::Transform>().GetWorldMatrix();
 
-        auto view = m_Scene.GetRegistry().view<sg::Mesh, sg::Transform>();
-        for (auto &entity : view)
+        sg::Frustum frustum{VulkanStyleProjection(perspective_camera.GetProjection()) * glm::inverse(camera_matrix)};
+
+        m_Scene.GetSpatialSystem().CullMeshes(frustum, m_CullResult);
+
+        auto &registry = m_Scene.GetRegistry();
+        auto &bounds_system = m_Scene.GetBoundsSystem();
+        auto &entities = bounds_system.GetEntities();
+        auto &bounds_batch = bounds_system.GetBoundsBatch();
+
+        glm::vec3 camera_position{camera_matrix[3]};
+        m_CullingStats = {};
+
+        auto *texture_streamer = m_Scene.GetTextureStreamer();
+        // Pixels per unit of size at unit distance
+        float pixel_scale = perspective_camera.GetProjection()[1][1] * static_cast<float>(m_SurfaceHeight);
+
+        for (auto index : m_CullResult.visible)
         {
-            auto [mesh, transform] = view.get<sg::Mesh, sg::Transform>(entity);
+            auto entity = entities[index];
+            auto &mesh = registry.get<sg::Mesh>(entity);
+            auto &transform = registry.get<sg::Transform>(entity);
+            auto *skin = registry.try_get<sg::Skin>(entity);
+
+            m_CullingStats.visible_submeshes += ToUint32_t(mesh.GetSubmeshes().size());
 
-            auto world_matrix = transform.GetWorldMatrix();
-            auto &mesh_bounds = mesh.GetBounds();
+            glm::vec3 center{bounds_batch.m_CenterX[index], bounds_batch.m_CenterY[index], bounds_batch.m_CenterZ[index]};
+            float distance = glm::length(camera_position - center);
+
+            float screen_size = 0.0f;
+            if (texture_streamer)
+            {
+                glm::vec3 extent{bounds_batch.m_ExtentX[index], bounds_batch.m_ExtentY[index], bounds_batch.m_ExtentZ[index]};
+                float radius = glm::length(extent);
 
-            sg::AABB world_bounds{mesh_bounds.GetMin(), mesh_bounds.GetMax()};
-            world_bounds.Transform(world_matrix);
+                // Meshes around the camera or without bounds cover the whole surface
+                screen_size = distance > radius ? radius * pixel_scale / distance : static_cast<float>(m_SurfaceHeight);
+            }
 
-            float distance = glm::length(glm::vec3(camera_matrix[3]) -
-                                         world_bounds.GetCenter());
+            // Invert the front face if the mesh was flipped
+            const auto &scale = transform.GetScale();
+            bool flipped = scale.x * scale.y * scale.z < 0;
+            VkFrontFace front_face = flipped ? VK_FRONT_FACE_CLOCKWISE : VK_FRONT_FACE_COUNTER_CLOCKWISE;
 
             for (auto &submesh : mesh.GetSubmeshes())
             {
-                auto pair = std::make_pair(submesh, &transform);
-                if (submesh->GetMaterial()->m_AlphaMode == sg::AlphaMode::Blend)
-                    transparent_nodes.emplace(distance, pair);
+                const SkinnedVertices *skinned_vertices = nullptr;
 
-                else
-                    opaque_nodes.emplace(distance, pair);
+                if (skin && submesh->IsSkinned() && !skin->GetJoints().empty())
+                    skinned_vertices = m_SkinningStage.Push(*skin, *submesh);
+
+                if (texture_streamer)
+                    texture_streamer->Request(*submesh->GetMaterial(), screen_size);
+
+                draw_queue.Push(*submesh, transform, front_face, distance, skinned_vertices);
             }
         }
+
+        draw_queue.Sort();
+
+        m_CullingStats.culled_submeshes = ToUint32_t(bounds_system.GetSubmeshCount()) - m_CullingStats.visible_submeshes;
     }
 
-    void GeometrySubpass::UpdateUniform(RenderContext &render_context, CommandBuffer &command_buffer, sg::Transform &submesh_transform, Entity *camera, size_t thread_index)
+    void GeometrySubpass::UpdateUniform(RenderContext &render_context, CommandBuffer &command_buffer, Entity *camera, size_t thread_index)
     {
         GlobalUniform global_uniform;
         auto &perspective_camera = camera->GetComponent<sg::PerspectiveCamera>();
@@ -141,7 +220,6 @@ namespace engine
         auto allocation = render_frame.AllocateBuffer(VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT,
                                                       sizeof(GlobalUniform), thread_index);
 
-        global_uniform.model = submesh_transform.GetWorldMatrix();
         global_uniform.camera_position = glm::vec3(
             camera_transform.GetWorldMatrix()[3]);
 
@@ -149,7 +227,7 @@ namespace engine
         command_buffer.BindBuffer(allocation.GetBuffer(), allocation.GetOffset(), allocation.GetSize(), 0, 1, 0);
     }
 
-    void GeometrySubpass::DrawSubmesh(CommandBuffer &command_buffer, sg::Submesh &submesh, VkFrontFace front_face)
+    void GeometrySubpass::DrawSubmesh(CommandBuffer &command_buffer, sg::Submesh &submesh, BufferAllocation &instance_buffer, uint32_t instance_count, VkFrontFace front_face, const SkinnedVertices *skinned_vertices)
     {
         auto &device = command_buffer.GetDevice();
         PreparePipelineState(command_buffer, front_face, submesh.GetMaterial()->m_DoubleSided);
@@ -172,12 +250,18 @@ namespace engine
 
         DescriptorSetLayout &descriptor_set_layout = pipeline_layout.GetDescriptorSetLayout(0);
 
-        for (auto &texture : submesh.GetMaterial()->m_Textures)
+        auto *material = submesh.GetMaterial();
+
+        for (auto &texture : material->m_Textures)
         {
             if (auto layout_binding = descriptor_set_layout.GetLayoutBinding(texture.first))
             {
+                // Streamed textures with finer levels resident draw those
+                auto view_it = material->m_TextureViews.find(texture.first);
+                auto &image_view = view_it != material->m_TextureViews.end() ? *view_it->second : texture.second->GetImage()->GetVkImageView();
+
                 command_buffer.GetResourceBindingState().BindImage(
-                    texture.second->GetImage()->GetVkImageView(),
+                    image_view,
                     texture.second->GetSampler()->m_VkSampler,
                     0, layout_binding->binding, 0);
             }
@@ -185,10 +269,51 @@ namespace engine
 
         auto vertex_input_resources = pipeline_layout.GetResources(ShaderResourceType::Input, VK_SHADER_STAGE_VERTEX_BIT);
 
+        auto *arena = submesh.m_GeometryArena;
+        bool interleaved = submesh.m_InterleavedBuffer != nullptr || arena != nullptr;
+        bool has_position_stream = submesh.m_PositionBuffer || submesh.m_PositionRange != GeometryArena::NULL_HANDLE;
+
+        // Buffers of other submeshes are bound at the same locations
+        if (!arena)
+            m_BoundVertexBuffer = VK_NULL_HANDLE;
+
+        // Shaders reading nothing but positions, like depth only passes, use the split position stream
+        bool position_only = interleaved && has_position_stream &&
+                             std::all_of(vertex_input_resources.begin(), vertex_input_resources.end(),
+                                         [](const ShaderResource &resource)
+                                         { return resource.name == "position" || resource.name == "instance_model"; });
+
+        // Interleaved attributes share one binding, numbered after the first location using it
+        uint32_t interleaved_binding = std::numeric_limits<uint32_t>::max();
+
         VertexInputState vertex_input_state;
 
         for (auto &input_resource : vertex_input_resources)
         {
+            // Per instance model matrix, one vec4 attribute per column
+            if (input_resource.name == "instance_model")
+            {
+                VkVertexInputBindingDescription instance_binding{};
+                instance_binding.binding = input_resource.location;
+                instance_binding.stride = sizeof(glm::mat4);
+                instance_binding.inputRate = VK_VERTEX_INPUT_RATE_INSTANCE;
+
+                vertex_input_state.bindings.push_back(instance_binding);
+
+                for (uint32_t column = 0; column < 4; column++)
+                {
+                    VkVertexInputAttributeDescription instance_attribute{};
+                    instance_attribute.binding = input_resource.location;
+                    instance_attribute.format = VK_FORMAT_R32G32B32A32_SFLOAT;
+                    instance_attribute.location = input_resource.location + column;
+                    instance_attribute.offset = ToUint32_t(sizeof(glm::vec4)) * column;
+
+                    vertex_input_state.attributes.push_back(instance_attribute);
+                }
+
+                continue;
+            }
+
             sg::VertexAttribute attribute;
 
             if (!submesh.GetAttribute(input_resource.name, attribute))
@@ -196,19 +321,51 @@ namespace engine
                 continue;
             }
 
+            if (skinned_vertices && IsSkinnedAttribute(input_resource.name))
+            {
+                attribute.format = VK_FORMAT_R32G32B32_SFLOAT;
+                attribute.stride = ToUint32_t(sizeof(glm::vec3));
+                attribute.offset = 0;
+            }
+            else if (position_only)
+            {
+                attribute.stride = submesh.m_PositionStride;
+                attribute.offset = 0;
+            }
+
+            uint32_t binding = input_resource.location;
+
+            if (interleaved && !position_only)
+            {
+                if (interleaved_binding == std::numeric_limits<uint32_t>::max())
+                {
+                    interleaved_binding = input_resource.location;
+
+                    VkVertexInputBindingDescription vertex_binding{};
+                    vertex_binding.binding = interleaved_binding;
+                    vertex_binding.stride = attribute.stride;
+
+                    vertex_input_state.bindings.push_back(vertex_binding);
+                }
+
+                binding = interleaved_binding;
+            }
+            else
+            {
+                VkVertexInputBindingDescription vertex_binding{};
+                vertex_binding.binding = binding;
+                vertex_binding.stride = attribute.stride;
+
+                vertex_input_state.bindings.push_back(vertex_binding);
+            }
+
             VkVertexInputAttributeDescription vertex_attribute{};
-            vertex_attribute.binding = input_resource.location;
+            vertex_attribute.binding = binding;
             vertex_attribute.format = attribute.format;
             vertex_attribute.location = input_resource.location;
             vertex_attribute.offset = attribute.offset;
 
             vertex_input_state.attributes.push_back(vertex_attribute);
-
-            VkVertexInputBindingDescription vertex_binding{};
-            vertex_binding.binding = input_resource.location;
-            vertex_binding.stride = attribute.stride;
-
-            vertex_input_state.bindings.push_back(vertex_binding);
         }
 
         command_buffer.GetPipelineState().SetVertexInputState(vertex_input_state);
@@ -216,6 +373,33 @@ namespace engine
         // Find submesh vertex buffers matching the shader input attribute names
         for (auto &input_resource : vertex_input_resources)
         {
+            if (skinned_vertices && IsSkinnedAttribute(input_resource.name) &&
+                submesh.m_VertexBuffers.count(input_resource.name))
+            {
+                auto &allocation = input_resource.name == "position" ? skinned_vertices->positions : skinned_vertices->normals;
+
+                std::vector<std::reference_wrapper<const core::Buffer>> buffers;
+                buffers.emplace_back(std::ref(allocation.GetBuffer()));
+
+                command_buffer.BindVertexBuffers(input_resource.location, std::move(buffers), {allocation.GetOffset()});
+                continue;
+            }
+
+            if (position_only && input_resource.name == "position")
+            {
+                if (arena)
+                    BindArenaVertexBuffer(command_buffer, input_resource.location, arena->GetBuffer(submesh.m_PositionRange));
+                else
+                {
+                    std::vector<std::reference_wrapper<const core::Buffer>> buffers;
+                    buffers.emplace_back(std::ref(*submesh.m_PositionBuffer));
+
+                    command_buffer.BindVertexBuffers(input_resource.location, std::move(buffers), {0});
+                }
+
+                continue;
+            }
+
             const auto &buffer_iter = submesh.m_VertexBuffers.find(input_resource.name);
 
             if (buffer_iter != submesh.m_VertexBuffers.end())
@@ -226,9 +410,55 @@ namespace engine
                 // Bind vertex buffers only for the attribute locations defined
                 command_buffer.BindVertexBuffers(input_resource.location, std::move(buffers), {0});
             }
+            else if (input_resource.name == "instance_model")
+            {
+                std::vector<std::reference_wrapper<const core::Buffer>> buffers;
+                buffers.emplace_back(std::ref(instance_buffer.GetBuffer()));
+
+                command_buffer.BindVertexBuffers(input_resource.location, std::move(buffers), {instance_buffer.GetOffset()});
+            }
+        }
+
+        // One bind covers every interleaved attribute
+        if (interleaved_binding != std::numeric_limits<uint32_t>::max())
+        {
+            if (arena)
+                BindArenaVertexBuffer(command_buffer, interleaved_binding, arena->GetBuffer(submesh.m_VertexRange));
+            else
+            {
+                std::vector<std::reference_wrapper<const core::Buffer>> buffers;
+                buffers.emplace_back(std::ref(*submesh.m_InterleavedBuffer));
+
+                command_buffer.BindVertexBuffers(interleaved_binding, std::move(buffers), {0});
+            }
+        }
+
+        // Arena submeshes share buffers, they only differ by where their vertices start
+        int32_t vertex_offset = 0;
+
+        if (arena)
+        {
+            if (position_only)
+                vertex_offset = static_cast<int32_t>(arena->GetRange(submesh.m_PositionRange).offset / submesh.m_PositionStride);
+            else
+                vertex_offset = static_cast<int32_t>(arena->GetRange(submesh.m_VertexRange).offset / submesh.m_VertexStride);
         }
 
-        DrawSubmeshCommand(command_buffer, submesh);
+        DrawSubmeshCommand(command_buffer, submesh, instance_count, vertex_offset);
+    }
+
+    void GeometrySubpass::BindArenaVertexBuffer(CommandBuffer &command_buffer, uint32_t binding, const core::Buffer &buffer)
+    {
+        if (m_BoundVertexBuffer == buffer.GetHandle() && m_BoundVertexBinding == binding)
+            return;
+
+        std::vector<std::reference_wrapper<const core::Buffer>> buffers;
+        buffers.emplace_back(std::ref(buffer));
+
+        command_buffer.BindVertexBuffers(binding, std::move(buffers), {0});
+
+        m_BoundVertexBuffer = buffer.GetHandle();
+        m_BoundVertexBinding = binding;
     }
 
     void GeometrySubpass::PreparePipelineState(CommandBuffer &command_buffer, VkFrontFace front_face, bool double_sided_material)
@@ -270,6 +500,8 @@ namespace engine
         pbr_material_uniform.base_color_factor = pbr_material->m_BaseColorFactor;
         pbr_material_uniform.metallic_factor = pbr_material->m_MetallicFactor;
         pbr_material_uniform.roughness_factor = pbr_material->m_RoughnessFactor;
+        pbr_material_uniform.position_offset = glm::vec4(submesh.m_PositionOffset, 0.0f);
+        pbr_material_uniform.position_scale = glm::vec4(submesh.m_PositionScale, 0.0f);
 
         auto data = ToBytes(pbr_material_uniform);
 
@@ -279,21 +511,40 @@ namespace engine
         }
     }
 
-    void GeometrySubpass::DrawSubmeshCommand(CommandBuffer &command_buffer, sg::Submesh &submesh)
+    void GeometrySubpass::DrawSubmeshCommand(CommandBuffer &command_buffer, sg::Submesh &submesh, uint32_t instance_count, int32_t vertex_offset)
     {
+        if (submesh.m_IndexRange != GeometryArena::NULL_HANDLE)
+        {
+            auto &index_buffer = submesh.m_GeometryArena->GetBuffer(submesh.m_IndexRange);
+
+            if (m_BoundIndexBuffer != index_buffer.GetHandle() || m_BoundIndexType != submesh.m_IndexType)
+            {
+                command_buffer.BindIndexBuffer(index_buffer, 0, submesh.m_IndexType);
+
+                m_BoundIndexBuffer = index_buffer.GetHandle();
+                m_BoundIndexType = submesh.m_IndexType;
+            }
+
+            uint32_t index_size = submesh.m_IndexType == VK_INDEX_TYPE_UINT32 ? 4 : 2;
+            auto first_index = ToUint32_t(submesh.m_GeometryArena->GetRange(submesh.m_IndexRange).offset / index_size);
+
+            command_buffer.DrawIndexed(submesh.m_VertexIndices, instance_count, first_index, vertex_offset, 0);
+        }
         // Draw submesh indexed if indices exists
-        if (submesh.m_VertexIndices != 0)
+        else if (submesh.m_VertexIndices != 0)
         {
+            m_BoundIndexBuffer = VK_NULL_HANDLE;
+
             // Bind index buffer of submesh
             command_buffer.BindIndexBuffer(*submesh.m_IndexBuffer, submesh.m_IndexOffset, submesh.m_IndexType);
 
             // Draw submesh using indexed data
-            command_buffer.DrawIndexed(submesh.m_VertexIndices, 1, 0, 0, 0);
+            command_buffer.DrawIndexed(submesh.m_VertexIndices, instance_count, 0, 0, 0);
         }
         else
         {
             // Draw submesh using vertices only
-            command_buffer.Draw(submesh.m_VerticesCount, 1, 0, 0);
+            command_buffer.Draw(submesh.m_VerticesCount, instance_count, static_cast<uint32_t>(vertex_offset), 0);
         }
     }
 }
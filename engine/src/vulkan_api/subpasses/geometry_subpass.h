@@ -1,6 +1,9 @@
 #pragma once
 
 #include "vulkan_api/subpasses/subpass.h"
+#include "scene/bvh.h"
+#include "vulkan_api/rendering/draw_queue.h"
+#include "vulkan_api/rendering/skinning_stage.h"
 
 namespace engine
 {
@@ -12,13 +15,13 @@ namespace engine
     namespace sg
     {
         class Camera;
+        class Mesh;
         class Submesh;
         class Transform;
     }
 
     struct alignas(16) GlobalUniform
     {
-        glm::mat4 model;
         glm::mat4 camera_view_proj;
         glm::vec3 camera_position;
     };
@@ -28,6 +31,16 @@ namespace engine
         glm::vec4 base_color_factor;
         float metallic_factor;
         float roughness_factor;
+        glm::vec2 padding;
+        // Read by the vertex stage of QUANTIZED_POSITION variants
+        glm::vec4 position_offset;
+        glm::vec4 position_scale;
+    };
+
+    struct CullingStats
+    {
+        uint32_t visible_submeshes{0};
+        uint32_t culled_submeshes{0};
     };
 
     class GeometrySubpass : public Subpass
@@ -39,25 +52,55 @@ namespace engine
         virtual ~GeometrySubpass();
 
         virtual void Prepare(Device &device) override;
+        // Culls, sorts and skins the visible submeshes
+        virtual void PreDraw(RenderContext &render_context, Layer &layer, CommandBuffer &command_buffer) override;
         virtual void Draw(RenderContext &render_context, Layer &layer, CommandBuffer &command_buffer) override;
-        void GetSortedNodes(std::multimap<float, std::pair<sg::Submesh *, sg::Transform *>> &opaque_nodes,
-                            std::multimap<float, std::pair<sg::Submesh *, sg::Transform *>> &transparent_nodes,
-                            Entity *camera);
+        void GetSortedNodes(DrawQueue &draw_queue, Entity *camera);
 
-        void UpdateUniform(RenderContext &render_context, CommandBuffer &command_buffer, sg::Transform &transform, Entity *camera, size_t thread_index = 0);
+        void UpdateUniform(RenderContext &render_context, CommandBuffer &command_buffer, Entity *camera, size_t thread_index = 0);
+
+        // Draws the packets as instances of their first submesh
+        void DrawBatch(RenderContext &render_context, CommandBuffer &command_buffer,
+                       std::vector<DrawPacket>::const_iterator begin,
+                       std::vector<DrawPacket>::const_iterator end);
 
         void DrawSubmesh(CommandBuffer &command_buffer,
                          sg::Submesh &sub_mesh,
-                         VkFrontFace front_face = VK_FRONT_FACE_COUNTER_CLOCKWISE);
+                         BufferAllocation &instance_buffer,
+                         uint32_t instance_count = 1,
+                         VkFrontFace front_face = VK_FRONT_FACE_COUNTER_CLOCKWISE,
+                         const SkinnedVertices *skinned_vertices = nullptr);
 
         void PreparePipelineState(CommandBuffer &command_buffer, VkFrontFace front_face, bool double_sided_material);
         PipelineLayout &PreparePipelineLayout(CommandBuffer &command_buffer, const std::vector<ShaderModule *> &shader_modules);
         void PreparePushConstants(CommandBuffer &command_buffer, sg::Submesh &submesh);
-        void DrawSubmeshCommand(CommandBuffer &command_buffer, sg::Submesh &submesh);
+        void DrawSubmeshCommand(CommandBuffer &command_buffer, sg::Submesh &submesh, uint32_t instance_count = 1, int32_t vertex_offset = 0);
+
+        const CullingStats &GetCullingStats() const { return m_CullingStats; }
+
+        void SetSkinningMode(SkinningMode mode) { m_SkinningStage.SetMode(mode); }
+        SkinningMode GetSkinningMode() const { return m_SkinningStage.GetMode(); }
 
     protected:
         Scene &m_Scene;
         uint32_t m_ThreadIndex{0};
         RasterizationState m_BaseRasterizationState{};
+
+    private:
+        sg::BVH::CullResult m_CullResult;
+        DrawQueue m_DrawQueue;
+        std::vector<glm::mat4> m_InstanceTransforms;
+        SkinningStage m_SkinningStage;
+        CullingStats m_CullingStats;
+        // Height of the drawn surface in pixels, streamed textures are requested by the on screen size of meshes
+        uint32_t m_SurfaceHeight{0};
+
+        // Skips rebinding the arena buffers when consecutive draws share them
+        void BindArenaVertexBuffer(CommandBuffer &command_buffer, uint32_t binding, const core::Buffer &buffer);
+
+        VkBuffer m_BoundVertexBuffer{VK_NULL_HANDLE};
+        uint32_t m_BoundVertexBinding{0};
+        VkBuffer m_BoundIndexBuffer{VK_NULL_HANDLE};
+        VkIndexType m_BoundIndexType{VK_INDEX_TYPE_UINT16};
     };
 }
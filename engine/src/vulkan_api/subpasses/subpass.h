@@ -51,6 +51,8 @@ namespace engine
 
         virtual void Prepare(Device &device) = 0;
         virtual void Draw(RenderContext &render_context, Layer &layer, CommandBuffer &command_buffer) = 0;
+        // Recorded before the render pass begins, for work the draw depends on such as compute dispatches
+        virtual void PreDraw(RenderContext &render_context, Layer &layer, CommandBuffer &command_buffer) {}
         void UpdateRenderTargetAttachments(RenderTarget &render_target);
 
         const ShaderSource &GetVertexShader() const { return m_VertexShader; }
@@ -88,10 +90,11 @@ namespace engine
                 auto [scene_light, transform] = view.get<sg::Light, sg::Transform>(entity);
 
                 const auto &properties = scene_light.GetLightProperties();
+                const auto &world_matrix = transform.GetWorldMatrix();
 
-                LightInfo light{{transform.GetTranslation(), static_cast<float>(scene_light.GetLightType())},
+                LightInfo light{{glm::vec3(world_matrix[3]), static_cast<float>(scene_light.GetLightType())},
                                 {properties.color, properties.intensity},
-                                {transform.GetRotation() * properties.direction, properties.range},
+                                {glm::normalize(glm::mat3(world_matrix) * properties.direction), properties.range},
                                 {properties.inner_cone_angle, properties.outer_cone_angle}};
 
                 // TODO: light direction wrong
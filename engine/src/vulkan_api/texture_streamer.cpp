@@ -0,0 +1,450 @@
+#include "vulkan_api/texture_streamer.h"
+
+#include "scene/scene.h"
+#include "scene/components/image.h"
+#include "scene/components/pbr_material.h"
+#include "scene/components/texture.h"
+#include "vulkan_api/command_pool.h"
+#include "vulkan_api/core/image.h"
+#include "vulkan_api/core/image_view.h"
+#include "vulkan_api/device.h"
+
+namespace engine
+{
+    namespace
+    {
+        // Images share a staging buffer, each starts at a multiple of every block size and of 4 bytes
+        constexpr VkDeviceSize STAGING_ALIGNMENT = 16;
+
+        inline VkDeviceSize AlignUp(VkDeviceSize value, VkDeviceSize alignment)
+        {
+            return (value + alignment - 1) & ~(alignment - 1);
+        }
+    }
+
+    TextureStreamer::TextureStreamer(Device &device, Scene &scene, const TextureStreamerSettings &settings)
+        : m_Device(device),
+          m_Queue(device.GetSuitableGraphicsQueueFamily().GetQueues()[0]),
+          m_Settings(settings)
+    {
+        std::unordered_map<const sg::Image *, size_t> indices;
+
+        // The loader kept the whole chain of the images it streams and only created their smallest levels
+        for (auto &image : scene.GetImages())
+        {
+            if (image->GetBaseLevel() == 0 || image->GetData().empty())
+                continue;
+
+            StreamedImage streamed{};
+            streamed.image = image.get();
+            streamed.tail_level = image->GetBaseLevel();
+            streamed.resident_level = streamed.tail_level;
+            streamed.requested_level = streamed.tail_level;
+
+            m_ResidentSize += image->GetLevelRange(streamed.tail_level).second;
+
+            indices.emplace(image.get(), m_Images.size());
+            m_Images.push_back(std::move(streamed));
+        }
+
+        for (auto &material : scene.GetMaterials())
+        {
+            for (auto &texture : material->m_Textures)
+            {
+                auto it = indices.find(texture.second->GetImage());
+                if (it == indices.end())
+                    continue;
+
+                m_Images[it->second].slots.emplace_back(material.get(), texture.first);
+                m_MaterialImages[material.get()].push_back(it->second);
+            }
+        }
+
+        ENG_CORE_INFO("Streaming {} images, {} bytes resident of a {} byte budget.", m_Images.size(), m_ResidentSize, m_Settings.budget);
+    }
+
+    TextureStreamer::~TextureStreamer()
+    {
+        for (auto &batch : m_Batches)
+            vkWaitForFences(m_Device.GetHandle(), 1, &batch.fence, VK_TRUE, UINT64_MAX);
+
+        for (auto &retirement : m_Retirements)
+            vkWaitForFences(m_Device.GetHandle(), 1, &retirement.fence, VK_TRUE, UINT64_MAX);
+
+        // Frames can't draw the finer images anymore once the streamer is gone
+        for (auto &streamed : m_Images)
+        {
+            for (auto &slot : streamed.slots)
+                slot.first->m_TextureViews.erase(slot.second);
+        }
+
+        for (auto &batch : m_Batches)
+            m_FreeFences.push_back(batch.fence);
+
+        for (auto &retirement : m_Retirements)
+            m_FreeFences.push_back(retirement.fence);
+
+        m_Batches.clear();
+        m_Retirements.clear();
+
+        for (auto fence : m_FreeFences)
+            vkDestroyFence(m_Device.GetHandle(), fence, nullptr);
+    }
+
+    uint32_t TextureStreamer::GetTailLevel(const sg::Image &image, uint32_t tail_size)
+    {
+        auto &mipmaps = image.GetMipmaps();
+
+        for (uint32_t level = 0; level < mipmaps.size(); level++)
+        {
+            auto &extent = mipmaps[level].extent;
+
+            if (std::max(extent.width, extent.height) <= tail_size)
+                return level;
+        }
+
+        return ToUint32_t(mipmaps.size()) - 1;
+    }
+
+    void TextureStreamer::Request(const sg::Material &material, float screen_size)
+    {
+        auto it = m_MaterialImages.find(&material);
+        if (it == m_MaterialImages.end())
+            return;
+
+        for (auto index : it->second)
+        {
+            auto &streamed = m_Images[index];
+            auto &extent = streamed.image->GetExtent();
+
+            // The texture is assumed to cover the material once, the level with about one texel per pixel is enough
+            auto texels = static_cast<float>(std::max(extent.width, extent.height));
+            auto level = std::floor(std::log2(texels / std::max(screen_size, 1.0f)));
+            auto requested_level = static_cast<uint32_t>(std::clamp(level, 0.0f, static_cast<float>(streamed.tail_level)));
+
+            if (streamed.last_requested_frame != m_Frame)
+            {
+                streamed.requested_level = requested_level;
+                streamed.last_requested_frame = m_Frame;
+            }
+            else
+                streamed.requested_level = std::min(streamed.requested_level, requested_level);
+        }
+    }
+
+    void TextureStreamer::Update()
+    {
+        RetireFinished();
+        PublishFinished();
+
+        std::vector<size_t> upgrades;
+
+        for (size_t index = 0; index < m_Images.size(); index++)
+        {
+            auto &streamed = m_Images[index];
+
+            if (streamed.last_requested_frame != m_Frame)
+            {
+                if (m_Frame - streamed.last_requested_frame > m_Settings.idle_frames)
+                    Evict(streamed);
+
+                continue;
+            }
+
+            if (!streamed.uploading && streamed.requested_level < streamed.resident_level)
+                upgrades.push_back(index);
+        }
+
+        // Images missing the most levels first
+        std::sort(upgrades.begin(), upgrades.end(),
+                  [this](size_t a, size_t b)
+                  {
+                      auto &first = m_Images[a];
+                      auto &second = m_Images[b];
+                      auto first_missing = first.resident_level - first.requested_level;
+                      auto second_missing = second.resident_level - second.requested_level;
+
+                      if (first_missing != second_missing)
+                          return first_missing > second_missing;
+
+                      return first.requested_level < second.requested_level;
+                  });
+
+        StartUploads(std::move(upgrades));
+        SubmitRetirement();
+
+        m_Frame++;
+    }
+
+    size_t TextureStreamer::GetPendingUploadCount() const
+    {
+        size_t count = 0;
+
+        for (auto &batch : m_Batches)
+            count += batch.uploads.size();
+
+        return count;
+    }
+
+    void TextureStreamer::RetireFinished()
+    {
+        bool destroyed = false;
+
+        while (!m_Retirements.empty())
+        {
+            auto &retirement = m_Retirements.front();
+
+            if (vkGetFenceStatus(m_Device.GetHandle(), retirement.fence) != VK_SUCCESS)
+                break;
+
+            vkResetFences(m_Device.GetHandle(), 1, &retirement.fence);
+            m_FreeFences.push_back(retirement.fence);
+
+            m_Retirements.pop_front();
+            destroyed = true;
+        }
+
+        // Frames may have cached descriptor sets for the destroyed views, which new views can get the handles of
+        if (destroyed)
+            m_Device.InvalidateDescriptorSets();
+    }
+
+    void TextureStreamer::PublishFinished()
+    {
+        while (!m_Batches.empty())
+        {
+            auto &batch = m_Batches.front();
+
+            if (vkGetFenceStatus(m_Device.GetHandle(), batch.fence) != VK_SUCCESS)
+                break;
+
+            for (auto &upload : batch.uploads)
+            {
+                auto &streamed = m_Images[upload.index];
+
+                // The image it replaces may still be drawn by frames in flight
+                if (streamed.vk_image)
+                {
+                    m_Retiring.vk_images.push_back(std::move(streamed.vk_image));
+                    m_Retiring.vk_image_views.push_back(std::move(streamed.vk_image_view));
+                    m_ResidentSize -= streamed.resident_size;
+                }
+
+                streamed.vk_image = std::move(upload.vk_image);
+                streamed.vk_image_view = std::move(upload.vk_image_view);
+                streamed.resident_level = upload.level;
+                streamed.resident_size = upload.size;
+                streamed.uploading = false;
+
+                for (auto &slot : streamed.slots)
+                    slot.first->m_TextureViews[slot.second] = streamed.vk_image_view.get();
+            }
+
+            vkResetFences(m_Device.GetHandle(), 1, &batch.fence);
+            m_FreeFences.push_back(batch.fence);
+
+            batch.command_pool->ResetPool();
+            m_FreeCommandPools.push_back(std::move(batch.command_pool));
+
+            m_Batches.pop_front();
+        }
+    }
+
+    void TextureStreamer::Evict(StreamedImage &streamed)
+    {
+        if (!streamed.vk_image || streamed.uploading)
+            return;
+
+        for (auto &slot : streamed.slots)
+            slot.first->m_TextureViews.erase(slot.second);
+
+        m_Retiring.vk_images.push_back(std::move(streamed.vk_image));
+        m_Retiring.vk_image_views.push_back(std::move(streamed.vk_image_view));
+
+        m_ResidentSize -= streamed.resident_size;
+        streamed.resident_size = 0;
+        streamed.resident_level = streamed.tail_level;
+    }
+
+    bool TextureStreamer::MakeRoom(VkDeviceSize size)
+    {
+        while (m_ResidentSize + size > m_Settings.budget)
+        {
+            StreamedImage *victim = nullptr;
+
+            for (auto &streamed : m_Images)
+            {
+                if (!streamed.vk_image || streamed.uploading || streamed.last_requested_frame == m_Frame)
+                    continue;
+
+                if (!victim || streamed.last_requested_frame < victim->last_requested_frame)
+                    victim = &streamed;
+            }
+
+            if (!victim)
+                return false;
+
+            Evict(*victim);
+        }
+
+        return true;
+    }
+
+    void TextureStreamer::StartUploads(std::vector<size_t> &&indices)
+    {
+        std::vector<Upload> uploads;
+        VkDeviceSize upload_size = 0;
+        VkDeviceSize staging_size = 0;
+
+        for (auto index : indices)
+        {
+            auto &streamed = m_Images[index];
+            auto level = streamed.requested_level;
+            auto size = static_cast<VkDeviceSize>(streamed.image->GetLevelRange(level).second);
+
+            if (!uploads.empty() && upload_size + size > m_Settings.upload_budget)
+                break;
+
+            // Both the old and the new image are resident until the new one is published. Levels the budget has
+            // no room for are skipped, finest first
+            while (level < streamed.resident_level && !MakeRoom(size))
+            {
+                level++;
+                size = streamed.image->GetLevelRange(level).second;
+            }
+
+            if (level >= streamed.resident_level)
+                continue;
+
+            auto &mipmaps = streamed.image->GetMipmaps();
+
+            Upload upload{};
+            upload.index = index;
+            upload.level = level;
+            upload.size = size;
+            upload.staging_offset = staging_size;
+            upload.vk_image = std::make_unique<core::Image>(m_Device,
+                                                            mipmaps[level].extent,
+                                                            streamed.image->GetFormat(),
+                                                            VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT,
+                                                            VMA_MEMORY_USAGE_GPU_ONLY,
+                                                            VK_SAMPLE_COUNT_1_BIT,
+                                                            ToUint32_t(mipmaps.size()) - level);
+            upload.vk_image_view = std::make_unique<core::ImageView>(*upload.vk_image, VK_IMAGE_VIEW_TYPE_2D);
+
+            streamed.uploading = true;
+            m_ResidentSize += size;
+            upload_size += size;
+            staging_size = AlignUp(staging_size + size, STAGING_ALIGNMENT);
+
+            uploads.push_back(std::move(upload));
+        }
+
+        if (uploads.empty())
+            return;
+
+        Batch batch{};
+        batch.staging_buffer = std::make_unique<core::Buffer>(m_Device, staging_size, VK_BUFFER_USAGE_TRANSFER_SRC_BIT, VMA_MEMORY_USAGE_CPU_ONLY);
+
+        if (m_FreeCommandPools.empty())
+            batch.command_pool = std::make_unique<CommandPool>(m_Device, m_Queue.GetQueueFamilyIndex());
+        else
+        {
+            batch.command_pool = std::move(m_FreeCommandPools.back());
+            m_FreeCommandPools.pop_back();
+        }
+
+        auto &command_buffer = batch.command_pool->RequestCommandBuffer();
+        command_buffer.Begin(VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT, 0);
+
+        for (auto &upload : uploads)
+        {
+            auto &image = *m_Images[upload.index].image;
+            auto range = image.GetLevelRange(upload.level);
+
+            batch.staging_buffer->Update(image.GetData().data() + range.first, range.second, upload.staging_offset);
+
+            {
+                ImageMemoryBarrier memory_barrier{};
+                memory_barrier.old_layout = VK_IMAGE_LAYOUT_UNDEFINED;
+                memory_barrier.new_layout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+                memory_barrier.src_access_mask = 0;
+                memory_barrier.dst_access_mask = VK_ACCESS_TRANSFER_WRITE_BIT;
+                memory_barrier.src_stage_mask = VK_PIPELINE_STAGE_HOST_BIT;
+                memory_barrier.dst_stage_mask = VK_PIPELINE_STAGE_TRANSFER_BIT;
+
+                command_buffer.CreateImageMemoryBarrier(*upload.vk_image_view, memory_barrier);
+            }
+
+            std::vector<VkBufferImageCopy> copy_regions;
+
+            for (auto &mipmap : image.GetMipmaps())
+            {
+                if (mipmap.level < upload.level)
+                    continue;
+
+                VkBufferImageCopy copy_region{};
+                copy_region.bufferOffset = upload.staging_offset + mipmap.offset - range.first;
+                copy_region.imageSubresource = upload.vk_image_view->GetSubresourceLayers();
+                copy_region.imageSubresource.mipLevel = mipmap.level - upload.level;
+                copy_region.imageExtent = mipmap.extent;
+
+                copy_regions.push_back(copy_region);
+            }
+
+            command_buffer.CopyBufferToImage(*batch.staging_buffer, *upload.vk_image, copy_regions);
+
+            {
+                ImageMemoryBarrier memory_barrier{};
+                memory_barrier.old_layout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+                memory_barrier.new_layout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+                memory_barrier.src_access_mask = VK_ACCESS_TRANSFER_WRITE_BIT;
+                memory_barrier.dst_access_mask = VK_ACCESS_SHADER_READ_BIT;
+                memory_barrier.src_stage_mask = VK_PIPELINE_STAGE_TRANSFER_BIT;
+                memory_barrier.dst_stage_mask = VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
+
+                command_buffer.CreateImageMemoryBarrier(*upload.vk_image_view, memory_barrier);
+            }
+        }
+
+        command_buffer.End();
+
+        batch.fence = RequestFence();
+        batch.uploads = std::move(uploads);
+        m_Queue.Submit(command_buffer, batch.fence);
+
+        m_Batches.push_back(std::move(batch));
+    }
+
+    void TextureStreamer::SubmitRetirement()
+    {
+        if (m_Retiring.vk_images.empty())
+            return;
+
+        // A submit without batches signals once everything submitted to the queue before finished, frames recorded
+        // from now on draw the new views
+        m_Retiring.fence = RequestFence();
+        m_Queue.Submit(std::vector<VkSubmitInfo>{}, m_Retiring.fence);
+
+        m_Retirements.push_back(std::move(m_Retiring));
+        m_Retiring = {};
+    }
+
+    VkFence TextureStreamer::RequestFence()
+    {
+        if (!m_FreeFences.empty())
+        {
+            auto fence = m_FreeFences.back();
+            m_FreeFences.pop_back();
+            return fence;
+        }
+
+        VkFence fence{VK_NULL_HANDLE};
+        VkFenceCreateInfo create_info{VK_STRUCTURE_TYPE_FENCE_CREATE_INFO};
+
+        if (vkCreateFence(m_Device.GetHandle(), &create_info, nullptr, &fence) != VK_SUCCESS)
+            throw std::runtime_error("Failed to create fence.");
+
+        return fence;
+    }
+}
@@ -0,0 +1,138 @@
+#pragma once
+
+#include "vulkan_api/core/buffer.h"
+
+#include <deque>
+
+namespace engine
+{
+    class Device;
+    class CommandPool;
+    class Queue;
+    class Scene;
+
+    namespace core
+    {
+        class Image;
+        class ImageView;
+    }
+
+    namespace sg
+    {
+        class Image;
+        class Material;
+    }
+
+    struct TextureStreamerSettings
+    {
+        // Device memory of the sampled levels of streamed images, the smallest levels always stay resident
+        VkDeviceSize budget{256 * 1024 * 1024};
+        // Bytes copied to the GPU per frame at most, a single larger image still goes through alone
+        VkDeviceSize upload_budget{16 * 1024 * 1024};
+        // Levels this many texels across or smaller are loaded with the scene and never dropped
+        uint32_t tail_size{128};
+        // Frames an image was not drawn before its streamed levels are dropped
+        uint32_t idle_frames{300};
+    };
+
+    // Keeps the levels of streamed images resident that their on screen size needs. The full chain stays in memory,
+    // the Vulkan image created by the loader only holds the smallest levels. Finer levels go into an image of their
+    // own, which materials draw through their view table once its upload finished. Images least recently drawn
+    // lose their finer levels when the budget is exceeded
+    class TextureStreamer
+    {
+    public:
+        TextureStreamer(Device &device, Scene &scene, const TextureStreamerSettings &settings = {});
+        ~TextureStreamer();
+
+        TextureStreamer(const TextureStreamer &) = delete;
+        TextureStreamer &operator=(const TextureStreamer &) = delete;
+
+        // First level of the smallest levels an image keeps resident
+        static uint32_t GetTailLevel(const sg::Image &image, uint32_t tail_size);
+
+        // Called while the draws are collected, the material covers about screen_size pixels
+        void Request(const sg::Material &material, float screen_size);
+
+        // Called once per frame before drawing. Publishes finished uploads, destroys images no frame uses anymore,
+        // drops levels over the budget and starts the uploads for the last frame's requests
+        void Update();
+
+        VkDeviceSize GetResidentSize() const { return m_ResidentSize; }
+        size_t GetPendingUploadCount() const;
+
+    private:
+        struct StreamedImage
+        {
+            sg::Image *image{nullptr};
+            // Texture slots of the materials drawing the image
+            std::vector<std::pair<sg::Material *, std::string>> slots;
+
+            uint32_t tail_level{0};
+            // First level of the finer image, tail_level while only the loader's image is resident
+            uint32_t resident_level{0};
+            VkDeviceSize resident_size{0};
+            std::unique_ptr<core::Image> vk_image;
+            std::unique_ptr<core::ImageView> vk_image_view;
+
+            // Finest level requested since the last update
+            uint32_t requested_level{0};
+            uint64_t last_requested_frame{0};
+            bool uploading{false};
+        };
+
+        struct Upload
+        {
+            size_t index{0};
+            uint32_t level{0};
+            VkDeviceSize size{0};
+            VkDeviceSize staging_offset{0};
+            std::unique_ptr<core::Image> vk_image;
+            std::unique_ptr<core::ImageView> vk_image_view;
+        };
+
+        // Uploads started in one update, recorded into one command buffer
+        struct Batch
+        {
+            VkFence fence{VK_NULL_HANDLE};
+            std::unique_ptr<CommandPool> command_pool;
+            std::unique_ptr<core::Buffer> staging_buffer;
+            std::vector<Upload> uploads;
+        };
+
+        // Images replaced or dropped, destroyed once every frame submitted before signaled the fence
+        struct Retirement
+        {
+            VkFence fence{VK_NULL_HANDLE};
+            // Views are declared last so they are destroyed before their images
+            std::vector<std::unique_ptr<core::Image>> vk_images;
+            std::vector<std::unique_ptr<core::ImageView>> vk_image_views;
+        };
+
+        void RetireFinished();
+        void PublishFinished();
+        // Drops the finer levels, materials draw the loader's image again
+        void Evict(StreamedImage &streamed);
+        // Evicts least recently requested images until size more bytes fit, images requested by the last frame are kept
+        bool MakeRoom(VkDeviceSize size);
+        void StartUploads(std::vector<size_t> &&indices);
+        void SubmitRetirement();
+        VkFence RequestFence();
+
+        Device &m_Device;
+        const Queue &m_Queue;
+        TextureStreamerSettings m_Settings;
+
+        std::vector<StreamedImage> m_Images;
+        std::unordered_map<const sg::Material *, std::vector<size_t>> m_MaterialImages;
+
+        VkDeviceSize m_ResidentSize{0};
+        uint64_t m_Frame{1};
+
+        std::deque<Batch> m_Batches;
+        std::vector<std::unique_ptr<CommandPool>> m_FreeCommandPools;
+        std::deque<Retirement> m_Retirements;
+        Retirement m_Retiring;
+        std::vector<VkFence> m_FreeFences;
+    };
+}
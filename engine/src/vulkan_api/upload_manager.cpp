@@ -0,0 +1,184 @@
+#include "vulkan_api/upload_manager.h"
+
+#include "vulkan_api/command_buffer.h"
+#include "vulkan_api/command_pool.h"
+#include "vulkan_api/device.h"
+#include "vulkan_api/queue.h"
+#include "vulkan_api/queue_family.h"
+
+namespace engine
+{
+    UploadManager::UploadManager(Device &device, VkDeviceSize chunk_size)
+        : m_Device(device),
+          m_ChunkSize(chunk_size)
+    {
+        auto &graphics_family = m_Device.GetQueueFamilyByFlags(VK_QUEUE_GRAPHICS_BIT);
+
+        // Prefer a transfer only family, it usually maps to the copy engines
+        auto *transfer_family = m_Device.FindDedicatedQueueFamily(VK_QUEUE_TRANSFER_BIT, VK_QUEUE_GRAPHICS_BIT | VK_QUEUE_COMPUTE_BIT);
+        if (!transfer_family)
+            transfer_family = m_Device.FindDedicatedQueueFamily(VK_QUEUE_TRANSFER_BIT, VK_QUEUE_GRAPHICS_BIT);
+
+        if (transfer_family)
+        {
+            m_DedicatedTransferQueue = true;
+            m_Queue = &transfer_family->GetQueues()[0];
+            m_QueueFamilies = {graphics_family.GetFamilyIndex(), transfer_family->GetFamilyIndex()};
+        }
+        else
+        {
+            m_Queue = &graphics_family.GetQueues()[0];
+        }
+
+        m_CommandPool = std::make_unique<CommandPool>(m_Device, m_Queue->GetQueueFamilyIndex());
+
+        ENG_CORE_TRACE("Uploading through queue family {}{}", m_Queue->GetQueueFamilyIndex(),
+                       m_DedicatedTransferQueue ? " (dedicated transfer)" : "");
+    }
+
+    UploadManager::~UploadManager()
+    {
+        Wait();
+
+        for (auto fence : m_FreeFences)
+            vkDestroyFence(m_Device.GetHandle(), fence, nullptr);
+    }
+
+    void UploadManager::Upload(const core::Buffer &buffer, VkDeviceSize offset, const uint8_t *data, size_t size)
+    {
+        if (size == 0)
+            return;
+
+        if (m_Batch.staging_buffer && m_Batch.staging_offset + size > m_Batch.staging_buffer->GetSize())
+            Flush();
+
+        if (!m_Batch.staging_buffer)
+            BeginBatch(size);
+
+        // Copy regions stay aligned for the transfer queue's optimal granularity
+        auto staging_offset = m_Batch.staging_offset;
+        m_Batch.staging_buffer->Update(data, size, staging_offset);
+        m_Batch.staging_offset = (staging_offset + size + 15) & ~VkDeviceSize{15};
+
+        VkBufferCopy copy_region{};
+        copy_region.srcOffset = staging_offset;
+        copy_region.dstOffset = offset;
+        copy_region.size = size;
+
+        m_Batch.command_buffer->CopyBuffer(*m_Batch.staging_buffer, buffer, {copy_region});
+
+        if (std::find(m_Batch.destinations.begin(), m_Batch.destinations.end(), &buffer) == m_Batch.destinations.end())
+            m_Batch.destinations.push_back(&buffer);
+
+        m_UploadedSize += size;
+    }
+
+    void UploadManager::BeginBatch(VkDeviceSize minimum_size)
+    {
+        Retire(false);
+
+        for (auto it = m_FreeChunks.begin(); it != m_FreeChunks.end(); ++it)
+        {
+            if ((*it)->GetSize() >= minimum_size)
+            {
+                m_Batch.staging_buffer = std::move(*it);
+                m_FreeChunks.erase(it);
+                break;
+            }
+        }
+
+        // Uploads larger than a chunk get a staging buffer of their own size
+        if (!m_Batch.staging_buffer)
+            m_Batch.staging_buffer = std::make_unique<core::Buffer>(m_Device, std::max(m_ChunkSize, minimum_size),
+                                                                    VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+                                                                    VMA_MEMORY_USAGE_CPU_ONLY);
+
+        m_Batch.staging_offset = 0;
+        m_Batch.command_buffer = &m_CommandPool->RequestCommandBuffer();
+        m_Batch.command_buffer->Begin(VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT, 0);
+    }
+
+    void UploadManager::Flush()
+    {
+        if (!m_Batch.staging_buffer)
+            return;
+
+        // A transfer family has no later stages, the graphics queue waits on its fence before drawing
+        if (!m_DedicatedTransferQueue)
+        {
+            BufferMemoryBarrier memory_barrier{};
+            memory_barrier.src_stage_mask = VK_PIPELINE_STAGE_TRANSFER_BIT;
+            memory_barrier.dst_stage_mask = VK_PIPELINE_STAGE_VERTEX_INPUT_BIT | VK_PIPELINE_STAGE_VERTEX_SHADER_BIT | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
+            memory_barrier.src_access_mask = VK_ACCESS_TRANSFER_WRITE_BIT;
+            memory_barrier.dst_access_mask = VK_ACCESS_VERTEX_ATTRIBUTE_READ_BIT | VK_ACCESS_INDEX_READ_BIT | VK_ACCESS_SHADER_READ_BIT;
+
+            for (auto *buffer : m_Batch.destinations)
+                m_Batch.command_buffer->CreateBufferMemoryBarrier(*buffer, 0, VK_WHOLE_SIZE, memory_barrier);
+        }
+
+        m_Batch.command_buffer->End();
+        m_Batch.staging_buffer->Flush();
+
+        m_Batch.fence = RequestFence();
+
+        VkResult result = m_Queue->Submit(*m_Batch.command_buffer, m_Batch.fence);
+        if (result != VK_SUCCESS)
+            throw std::runtime_error("Failed to submit upload batch");
+
+        m_PendingBatches.push_back(std::move(m_Batch));
+        m_Batch = {};
+        m_BatchCount++;
+    }
+
+    void UploadManager::Wait()
+    {
+        Flush();
+        Retire(true);
+
+        // Every batch finished, so none of the command buffers is pending anymore
+        m_CommandPool->ResetPool();
+
+        if (m_BatchCount > 0)
+            ENG_CORE_TRACE("Uploaded {} bytes in {} batches", m_UploadedSize, m_BatchCount);
+
+        m_UploadedSize = 0;
+        m_BatchCount = 0;
+    }
+
+    void UploadManager::Retire(bool wait)
+    {
+        while (!m_PendingBatches.empty())
+        {
+            auto &batch = m_PendingBatches.front();
+
+            if (wait)
+                vkWaitForFences(m_Device.GetHandle(), 1, &batch.fence, VK_TRUE, UINT64_MAX);
+            else if (vkGetFenceStatus(m_Device.GetHandle(), batch.fence) != VK_SUCCESS)
+                break;
+
+            vkResetFences(m_Device.GetHandle(), 1, &batch.fence);
+            m_FreeFences.push_back(batch.fence);
+            m_FreeChunks.push_back(std::move(batch.staging_buffer));
+
+            m_PendingBatches.pop_front();
+        }
+    }
+
+    VkFence UploadManager::RequestFence()
+    {
+        if (!m_FreeFences.empty())
+        {
+            auto fence = m_FreeFences.back();
+            m_FreeFences.pop_back();
+            return fence;
+        }
+
+        VkFence fence{VK_NULL_HANDLE};
+        VkFenceCreateInfo create_info{VK_STRUCTURE_TYPE_FENCE_CREATE_INFO};
+
+        if (vkCreateFence(m_Device.GetHandle(), &create_info, nullptr, &fence) != VK_SUCCESS)
+            throw std::runtime_error("Failed to create fence.");
+
+        return fence;
+    }
+}
@@ -0,0 +1,70 @@
+#pragma once
+
+#include "vulkan_api/core/buffer.h"
+
+#include <deque>
+
+namespace engine
+{
+    class Device;
+    class CommandBuffer;
+    class CommandPool;
+    class Queue;
+
+    // Copies data into GPU only buffers through staging chunks. Each filled chunk is one batch of copies
+    // submitted at once, its staging memory is reused when the batch's fence signaled
+    class UploadManager
+    {
+    public:
+        static constexpr VkDeviceSize DEFAULT_CHUNK_SIZE = 64 * 1024 * 1024;
+
+        UploadManager(Device &device, VkDeviceSize chunk_size = DEFAULT_CHUNK_SIZE);
+        ~UploadManager();
+
+        UploadManager(const UploadManager &) = delete;
+        UploadManager &operator=(const UploadManager &) = delete;
+
+        // The data is copied into staging memory before returning, the GPU copy happens with the batch
+        void Upload(const core::Buffer &buffer, VkDeviceSize offset, const uint8_t *data, size_t size);
+
+        // Submits the current batch without waiting for it
+        void Flush();
+        // Submits the current batch and waits for every batch
+        void Wait();
+
+        bool HasDedicatedTransferQueue() const { return m_DedicatedTransferQueue; }
+        // Queue families that access the uploaded buffers, destination buffers are shared between them
+        const std::vector<uint32_t> &GetQueueFamilies() const { return m_QueueFamilies; }
+
+    private:
+        struct Batch
+        {
+            std::unique_ptr<core::Buffer> staging_buffer;
+            VkDeviceSize staging_offset{0};
+            CommandBuffer *command_buffer{nullptr};
+            VkFence fence{VK_NULL_HANDLE};
+            std::vector<const core::Buffer *> destinations;
+        };
+
+        void BeginBatch(VkDeviceSize minimum_size);
+        // Recycles the staging chunks and fences of finished batches, waits for all of them if requested
+        void Retire(bool wait);
+        VkFence RequestFence();
+
+        Device &m_Device;
+        VkDeviceSize m_ChunkSize;
+
+        const Queue *m_Queue{nullptr};
+        bool m_DedicatedTransferQueue{false};
+        std::vector<uint32_t> m_QueueFamilies;
+        std::unique_ptr<CommandPool> m_CommandPool;
+
+        Batch m_Batch;
+        std::deque<Batch> m_PendingBatches;
+        std::vector<std::unique_ptr<core::Buffer>> m_FreeChunks;
+        std::vector<VkFence> m_FreeFences;
+
+        VkDeviceSize m_UploadedSize{0};
+        uint32_t m_BatchCount{0};
+    };
+}
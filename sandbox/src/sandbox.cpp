@@ -41,7 +41,11 @@ void Game::OnAttach()
     window->CreateSurface(GetApp().GetInstance(), GetApp().GetDevice().GetGPU());
     window->CreateRenderContext(GetApp().GetDevice(), present_mode_priority, surface_format_priority);
     window->GetRenderContext().Prepare();
-    AddFreeCamera(window->GetRenderContext().GetSurfaceExtent(), window);
+}
+
+void Game::OnSceneLoaded()
+{
+    AddFreeCamera(GetWindow()->GetRenderContext().GetSurfaceExtent(), GetWindow());
 }
 
 Simple::Simple(engine::Application *application, const std::string &name)
@@ -68,14 +72,19 @@ void Simple::OnAttach()
     window->CreateSurface(GetApp().GetInstance(), GetApp().GetDevice().GetGPU());
     window->CreateRenderContext(GetApp().GetDevice(), present_mode_priority, surface_format_priority);
     window->GetRenderContext().Prepare();
-    AddFreeCamera(window->GetRenderContext().GetSurfaceExtent(), window);
+}
+
+void Simple::OnSceneLoaded()
+{
+    AddFreeCamera(GetWindow()->GetRenderContext().GetSurfaceExtent(), GetWindow());
 }
 
 bool Sandbox::Prepare()
 {
     Application::Prepare();
-    engine::Scene *s1 = LoadScene("scenes/sponza/Sponza01.gltf");
-    engine::Scene *s2 = LoadScene("scenes/planet.gltf");
+    // Both scenes load concurrently while the windows already present
+    engine::Scene *s1 = LoadSceneAsync("scenes/sponza/Sponza01.gltf").scene;
+    engine::Scene *s2 = LoadSceneAsync("scenes/planet.gltf").scene;
 
     {
         engine::ShaderSource vert_shader("base.vert");
@@ -13,6 +13,7 @@ class Game : public engine::Layer
 public:
     Game(engine::Application *application, engine::Window *window, const std::string &name);
     void OnAttach() override;
+    void OnSceneLoaded() override;
 };
 
 class Simple : public engine::Layer
@@ -20,6 +21,7 @@ class Simple : public engine::Layer
 public:
     Simple(engine::Application *application, const std::string &name);
     void OnAttach() override;
+    void OnSceneLoaded() override;
 };
 
 class Sandbox : public engine::Application